@@ -267,6 +267,43 @@ LUA_INLINE int CppBindClassMetaMethod::errorConstMismatch(lua_State* L)
         lua_tostring(L, lua_upvalueindex(1)));
 }
 
+LUA_INLINE int CppBindClassMetaMethod::releasedIndex(lua_State* L)
+{
+    // <SP:1> -> released userdata
+    // <SP:2> -> key
+
+    // get release function -> <mt> <mt[key]>
+    lua_getmetatable(L, 1);
+    lua_pushvalue(L, 2);
+    lua_rawget(L, -2);
+    if (lua_tocfunction(L, -1) == &releasedNoOp) {
+        return 1;
+    }
+
+    lua_pushliteral(L, "___type");
+    lua_rawget(L, -3);
+    return luaL_error(L, "attempt to get property '%s.%s' of released object",
+        luaL_optstring(L, -1, "<unknown>"), luaL_tolstring(L, 2, nullptr));
+}
+
+LUA_INLINE int CppBindClassMetaMethod::releasedNewIndex(lua_State* L)
+{
+    // <SP:1> -> released userdata
+    // <SP:2> -> key
+    // <SP:3> -> value
+
+    lua_getmetatable(L, 1);
+    lua_pushliteral(L, "___type");
+    lua_rawget(L, -2);
+    return luaL_error(L, "attempt to set property '%s.%s' of released object",
+        luaL_optstring(L, -1, "<unknown>"), luaL_tolstring(L, 2, nullptr));
+}
+
+LUA_INLINE int CppBindClassMetaMethod::releasedNoOp(lua_State*)
+{
+    return 0;
+}
+
 //---------------------------------------------------------------------------
 
 LUA_INLINE bool CppBindClassBase::buildMetaTable(LuaRef& meta, LuaRef& parent, const char* name,
@@ -408,3 +445,36 @@ LUA_INLINE void CppBindClassBase::setMemberFunction(const char* name, const LuaR
         meta_const.rawset(name, err);
     }
 }
+
+LUA_INLINE void CppBindClassBase::setMemberRelease(const char* name, void* released_id, lua_CFunction release)
+{
+    auto L = state();
+    LuaRef meta_class = m_meta.rawget("___class");
+    LuaRef meta_const = m_meta.rawget("___const");
+
+    // the released object metatable, shared by all objects of this class
+    LuaRef registry(L, LUA_REGISTRYINDEX);
+    LuaRef released = registry.rawgetp(released_id);
+    if (released == nullptr) {
+        released = LuaRef::createTable(L);
+        released.rawset("__index", &CppBindClassMetaMethod::releasedIndex);
+        released.rawset("__newindex", &CppBindClassMetaMethod::releasedNewIndex);
+        released.rawset("__close", &CppBindClassMetaMethod::releasedNoOp);
+        released.rawset("___type", "released_" + meta_class.rawget<std::string>("___type", "<unknown>"));
+        released.rawset("___const", released);
+        registry.rawsetp(released_id, released);
+    }
+    released.rawset(name, &CppBindClassMetaMethod::releasedNoOp);
+
+    // release can be called by const object too
+    LuaRef proc = LuaRef::fromValue(L, release);
+    setMemberFunction(name, proc, true);
+    meta_class.rawset("__close", proc);
+    meta_const.rawset("__close", proc);
+}
+
+LUA_INLINE void CppBindClassBase::setMemberRawFunction(const char* name, lua_CFunction proc, lua_CFunction proc_const)
+{
+    m_meta.rawget("___class").rawset(name, proc);
+    m_meta.rawget("___const").rawset(name, proc_const);
+}
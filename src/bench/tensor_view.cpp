@@ -0,0 +1,208 @@
+#include <benchmark/benchmark.h>
+#include <LuaIntf.h>
+
+#include <vector>
+
+static void register_lua(LuaIntf::LuaContext & ctx, bool raw_index) {
+    using namespace LuaIntf;
+    using Meta = TensorViewMetaMethod<float>;
+
+    auto data = std::make_shared<std::vector<float>>(1024, 1.0f);
+    TensorView<float> view(data->data(), data->size(), data);
+
+    auto binding = LuaBinding(ctx).beginClass<TensorView<float>>("FloatTensorView");
+    binding
+        .addFunction("get", &TensorView<float>::get)
+        .addFunction("set", &TensorView<float>::set);
+    if (raw_index) {
+        binding
+            .addRawMetaFunction("__index", &Meta::index)
+            .addRawMetaFunction("__newindex", &Meta::newIndex, &Meta::newIndexConst)
+            .addRawMetaFunction("__len", &Meta::len);
+    }
+    binding.endClass();
+
+    ctx.setGlobal("view", view);
+}
+
+static void tensor_view_get_method(benchmark::State & state) {
+    LuaIntf::LuaContext ctx { false };
+    register_lua(ctx, false);
+
+    ctx.doString(
+        "fun = function()\n"
+        "  local s = 0\n"
+        "  for i = 1, 1024 do s = s + view:get(i) end\n"
+        "end\n"
+    );
+
+    auto const fun = ctx.getGlobal("fun");
+
+    for (auto _ : state) {
+        fun();
+    }
+}
+
+static void tensor_view_get_index(benchmark::State & state) {
+    LuaIntf::LuaContext ctx { false };
+    register_lua(ctx, true);
+
+    ctx.doString(
+        "fun = function()\n"
+        "  local s = 0\n"
+        "  for i = 1, 1024 do s = s + view[i] end\n"
+        "end\n"
+    );
+
+    auto const fun = ctx.getGlobal("fun");
+
+    for (auto _ : state) {
+        fun();
+    }
+}
+
+static void tensor_view_set_index(benchmark::State & state) {
+    LuaIntf::LuaContext ctx { false };
+    register_lua(ctx, true);
+
+    ctx.doString(
+        "fun = function()\n"
+        "  for i = 1, 1024 do view[i] = i end\n"
+        "end\n"
+    );
+
+    auto const fun = ctx.getGlobal("fun");
+
+    for (auto _ : state) {
+        fun();
+    }
+}
+
+static void table_get_index(benchmark::State & state) {
+    LuaIntf::LuaContext ctx { false };
+
+    ctx.doString(
+        "local t = {}\n"
+        "for i = 1, 1024 do t[i] = 1.0 end\n"
+        "fun = function()\n"
+        "  local s = 0\n"
+        "  for i = 1, 1024 do s = s + t[i] end\n"
+        "end\n"
+    );
+
+    auto const fun = ctx.getGlobal("fun");
+
+    for (auto _ : state) {
+        fun();
+    }
+}
+
+static void tensor_view_sum_loop(benchmark::State & state) {
+    LuaIntf::LuaContext ctx { false };
+    register_lua(ctx, true);
+
+    ctx.doString(
+        "fun = function()\n"
+        "  local s = 0\n"
+        "  for i = 1, #view do s = s + view[i] end\n"
+        "  return s\n"
+        "end\n"
+    );
+
+    auto const fun = ctx.getGlobal("fun");
+
+    for (auto _ : state) {
+        fun();
+    }
+}
+
+template <LuaIntf::TensorKernelLevel LEVEL>
+static void tensor_kernel_sum(benchmark::State & state) {
+    using namespace LuaIntf;
+
+    auto level = TensorKernels<float>::setLevel(LEVEL);
+    std::vector<float> data(state.range(0), 1.0f);
+    double result;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(result = TensorKernels<float>::sum(data.data(), data.size()));
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * sizeof(float));
+    state.SetLabel(level == LEVEL ? "" : "level not supported");
+    TensorKernels<float>::setLevel(TensorKernelLevel::AVX512);
+}
+
+template <LuaIntf::TensorKernelLevel LEVEL>
+static void tensor_kernel_sigmoid(benchmark::State & state) {
+    using namespace LuaIntf;
+
+    auto level = TensorKernels<float>::setLevel(LEVEL);
+    std::vector<float> data(state.range(0), 0.5f);
+
+    for (auto _ : state) {
+        TensorKernels<float>::sigmoid(data.data(), data.size());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * sizeof(float));
+    state.SetLabel(level == LEVEL ? "" : "level not supported");
+    TensorKernels<float>::setLevel(TensorKernelLevel::AVX512);
+}
+
+// argmax over rows of 80 class scores, as in a YOLO decoder
+template <LuaIntf::TensorKernelLevel LEVEL>
+static void tensor_kernel_argmax(benchmark::State & state) {
+    using namespace LuaIntf;
+
+    auto level = TensorKernels<float>::setLevel(LEVEL);
+    std::vector<float> data(state.range(0));
+    for (size_t i = 0; i < data.size(); i++) data[i] = float((i * 7919) % 1000);
+    size_t result;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(result = TensorKernels<float>::argmax(data.data(), data.size()));
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * sizeof(float));
+    state.SetLabel(level == LEVEL ? "" : "level not supported");
+    TensorKernels<float>::setLevel(TensorKernelLevel::AVX512);
+}
+
+template <LuaIntf::TensorKernelLevel LEVEL>
+static void tensor_convert_u8_f32(benchmark::State & state) {
+    using namespace LuaIntf;
+
+    auto level = TensorConvert::setLevel(LEVEL);
+    std::vector<uint8_t> src(state.range(0), 128);
+    std::vector<float> dst(state.range(0));
+
+    for (auto _ : state) {
+        TensorConvert::convert(TensorDType::U8, src.data(), TensorDType::F32, dst.data(), src.size(), 1.0 / 255);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * (sizeof(uint8_t) + sizeof(float)));
+    state.SetLabel(level == LEVEL ? "" : "level not supported");
+    TensorConvert::setLevel(TensorKernelLevel::AVX512);
+}
+
+BENCHMARK(tensor_view_get_method);
+BENCHMARK(tensor_view_get_index);
+BENCHMARK(tensor_view_set_index);
+BENCHMARK(table_get_index);
+BENCHMARK(tensor_view_sum_loop);
+BENCHMARK_TEMPLATE(tensor_kernel_sum, LuaIntf::TensorKernelLevel::SCALAR)->Range(1024, 16 << 20);
+BENCHMARK_TEMPLATE(tensor_kernel_sum, LuaIntf::TensorKernelLevel::SSE2)->Range(1024, 16 << 20);
+BENCHMARK_TEMPLATE(tensor_kernel_sum, LuaIntf::TensorKernelLevel::AVX2)->Range(1024, 16 << 20);
+BENCHMARK_TEMPLATE(tensor_kernel_sum, LuaIntf::TensorKernelLevel::AVX512)->Range(1024, 16 << 20);
+BENCHMARK_TEMPLATE(tensor_kernel_sigmoid, LuaIntf::TensorKernelLevel::SCALAR)->Range(1024, 1 << 20);
+BENCHMARK_TEMPLATE(tensor_kernel_sigmoid, LuaIntf::TensorKernelLevel::AVX2)->Range(1024, 1 << 20);
+BENCHMARK_TEMPLATE(tensor_kernel_sigmoid, LuaIntf::TensorKernelLevel::AVX512)->Range(1024, 1 << 20);
+BENCHMARK_TEMPLATE(tensor_kernel_argmax, LuaIntf::TensorKernelLevel::SCALAR)->Arg(80)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(tensor_kernel_argmax, LuaIntf::TensorKernelLevel::AVX2)->Arg(80)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(tensor_kernel_argmax, LuaIntf::TensorKernelLevel::AVX512)->Arg(80)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(tensor_convert_u8_f32, LuaIntf::TensorKernelLevel::SCALAR)->Arg(640 * 640 * 3);
+BENCHMARK_TEMPLATE(tensor_convert_u8_f32, LuaIntf::TensorKernelLevel::SSE2)->Arg(640 * 640 * 3);
+BENCHMARK_TEMPLATE(tensor_convert_u8_f32, LuaIntf::TensorKernelLevel::AVX2)->Arg(640 * 640 * 3);
+BENCHMARK_TEMPLATE(tensor_convert_u8_f32, LuaIntf::TensorKernelLevel::AVX512)->Arg(640 * 640 * 3);
@@ -27,6 +27,11 @@
 #ifndef LUACONTEXT_H
 #define LUACONTEXT_H
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <climits>
 #include <cstdint>
 #include <type_traits>
 
@@ -39,6 +44,490 @@ namespace LuaIntf
 
 //---------------------------------------------------------------------------
 
+/**
+ * Histogram of garbage collection pause times
+ *
+ * Bucket i counts the pauses in [2^i, 2^(i+1)) microseconds, pauses shorter
+ * than 1 microsecond are counted in bucket 0, and the last bucket also holds
+ * everything longer.
+ */
+class LuaGCStats
+{
+public:
+    static constexpr int BUCKETS = 24;
+
+    /**
+     * Record one pause
+     */
+    void record(std::chrono::nanoseconds pause)
+    {
+        auto us = static_cast<uint64_t>(std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::microseconds>(pause).count()));
+        int i = std::min(std::max(int(std::bit_width(us)) - 1, 0), BUCKETS - 1);
+        m_buckets[i]++;
+        m_count++;
+        m_total += pause;
+        if (pause > m_max) m_max = pause;
+    }
+
+    /**
+     * Clear all recorded pauses
+     */
+    void reset()
+    {
+        m_buckets.fill(0);
+        m_count = 0;
+        m_total = std::chrono::nanoseconds::zero();
+        m_max = std::chrono::nanoseconds::zero();
+    }
+
+    /**
+     * Number of recorded pauses
+     */
+    uint64_t count() const
+    {
+        return m_count;
+    }
+
+    /**
+     * Sum of all recorded pauses
+     */
+    std::chrono::nanoseconds total() const
+    {
+        return m_total;
+    }
+
+    /**
+     * The longest recorded pause
+     */
+    std::chrono::nanoseconds max() const
+    {
+        return m_max;
+    }
+
+    /**
+     * Number of pauses recorded in the given bucket
+     */
+    uint64_t bucket(int i) const
+    {
+        return (i >= 0 && i < BUCKETS) ? m_buckets[i] : 0;
+    }
+
+    /**
+     * The exclusive upper limit of the given bucket
+     */
+    static std::chrono::microseconds bucketLimit(int i)
+    {
+        return std::chrono::microseconds(int64_t(1) << (i + 1));
+    }
+
+    /**
+     * Upper bound of the pause time below which the given fraction (0 - 1) of pauses fall,
+     * the result is the limit of the matching bucket, capped by the longest pause.
+     */
+    std::chrono::nanoseconds percentile(double p) const
+    {
+        if (m_count == 0) return std::chrono::nanoseconds::zero();
+        uint64_t target = static_cast<uint64_t>(p * m_count);
+        if (target >= m_count) target = m_count - 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += m_buckets[i];
+            if (seen > target) {
+                return std::min<std::chrono::nanoseconds>(bucketLimit(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> m_buckets {};
+    uint64_t m_count = 0;
+    std::chrono::nanoseconds m_total {};
+    std::chrono::nanoseconds m_max {};
+};
+
+//---------------------------------------------------------------------------
+
+/**
+ * Memory held by C++ objects on behalf of Lua userdata
+ *
+ * Lua only sees the size of the userdata itself, so an object owning a large
+ * external buffer looks cheap to the collector. The bytes reported here are
+ * charged to the collector as allocation debt, so dead objects are reclaimed
+ * in proportion to their real footprint. See CppBindClass::addExternalSize.
+ *
+ * If the automatic collection is stopped the debt is kept pending, and paid
+ * by the next LuaGCPolicy::step.
+ */
+class LuaExternalMemory
+{
+public:
+    /**
+     * Pending debt below this size is not charged until more is added
+     */
+    static constexpr size_t STEP_THRESHOLD = 64 * 1024;
+
+    /**
+     * Report external bytes acquired by a Lua owned object
+     */
+    static void add(lua_State* L, size_t bytes)
+    {
+        Account* account = getAccount(L, true);
+        account->total += bytes;
+        account->pending += bytes;
+        if (account->pending >= STEP_THRESHOLD && isRunning(L)) {
+            size_t debt = account->pending;
+            account->pending = 0;
+            step(L, debt);
+        }
+    }
+
+    /**
+     * Report external bytes released by a Lua owned object,
+     * this does not run the collector so it is safe to call from __gc.
+     */
+    static void remove(lua_State* L, size_t bytes)
+    {
+        Account* account = getAccount(L, false);
+        if (account) {
+            account->total -= std::min(account->total, bytes);
+            account->pending -= std::min(account->pending, bytes);
+        }
+    }
+
+    /**
+     * Total external bytes held by live objects
+     */
+    static size_t total(lua_State* L)
+    {
+        Account* account = getAccount(L, false);
+        return account ? account->total : 0;
+    }
+
+    /**
+     * Take the debt that is not charged to the collector yet
+     */
+    static size_t takePending(lua_State* L)
+    {
+        Account* account = getAccount(L, false);
+        if (!account) return 0;
+        size_t debt = account->pending;
+        account->pending = 0;
+        return debt;
+    }
+
+    /**
+     * Perform an incremental step as if the given bytes were allocated,
+     * 0 means a basic step. This works even if the automatic collection is stopped.
+     *
+     * @return true if a collection cycle is finished
+     */
+    static bool step(lua_State* L, size_t bytes)
+    {
+#if defined(LUA_GCPARAM)
+        return lua_gc(L, LUA_GCSTEP, bytes) != 0;
+#else
+        int kb = int(std::min<size_t>((bytes + 1023) / 1024, INT_MAX));
+        return lua_gc(L, LUA_GCSTEP, kb) != 0;
+#endif
+    }
+
+private:
+    struct Account
+    {
+        size_t total;
+        size_t pending;
+    };
+
+    static void* key()
+    {
+        static char k = 0;
+        return &k;
+    }
+
+    static Account* getAccount(lua_State* L, bool create)
+    {
+        lua_rawgetp(L, LUA_REGISTRYINDEX, key());
+        Account* account = static_cast<Account*>(lua_touserdata(L, -1));
+        lua_pop(L, 1);
+        if (!account && create) {
+            account = static_cast<Account*>(lua_newuserdata(L, sizeof(Account)));
+            account->total = 0;
+            account->pending = 0;
+            lua_rawsetp(L, LUA_REGISTRYINDEX, key());
+        }
+        return account;
+    }
+
+    static bool isRunning(lua_State* L)
+    {
+#ifdef LUA_GCISRUNNING
+        return lua_gc(L, LUA_GCISRUNNING, 0) != 0;
+#else
+        return true;
+#endif
+    }
+};
+
+//---------------------------------------------------------------------------
+
+/**
+ * Garbage collection mode
+ */
+enum class LuaGCMode
+{
+    INCREMENTAL,
+    GENERATIONAL
+};
+
+/**
+ * Garbage collection policy
+ *
+ * Controls when and how much the collector runs, so latency sensitive code
+ * can stop the automatic collection and pay for it later at a chosen point,
+ * for example between frames:
+ *
+ * @code
+ *   LuaGCPolicy& gc = ctx.gcPolicy();
+ *   gc.stop();
+ *   for (;;) {
+ *       runFrame();
+ *       gc.step(std::chrono::milliseconds(2));
+ *   }
+ * @endcode
+ *
+ * Every step performed by the policy is timed and recorded in stats().
+ */
+class LuaGCPolicy
+{
+public:
+    /**
+     * Create policy for the given state, the state must outlive the policy.
+     */
+    explicit LuaGCPolicy(lua_State* state)
+        : L(state)
+        {}
+
+    /**
+     * Stop the automatic collection
+     */
+    void stop()
+    {
+        lua_gc(L, LUA_GCSTOP, 0);
+    }
+
+    /**
+     * Restart the automatic collection
+     */
+    void restart()
+    {
+        lua_gc(L, LUA_GCRESTART, 0);
+    }
+
+    /**
+     * Whether the automatic collection is running
+     */
+    bool isRunning() const
+    {
+#ifdef LUA_GCISRUNNING
+        return lua_gc(L, LUA_GCISRUNNING, 0) != 0;
+#else
+        return true;
+#endif
+    }
+
+    /**
+     * Run incremental collection steps until the time budget is used up or a cycle is finished.
+     * This works even if the automatic collection is stopped.
+     *
+     * The next step is not started if the previous step would not fit in the remaining budget,
+     * so the overshoot is bounded by the duration of a single step, see setStepSize().
+     * The first step also pays the external memory debt deferred while the collection was stopped.
+     *
+     * @param budget the time budget
+     * @return true if a collection cycle is finished
+     */
+    bool step(std::chrono::nanoseconds budget)
+    {
+        auto now = Clock::now();
+        auto deadline = now + budget;
+        size_t debt = LuaExternalMemory::takePending(L);
+        for (;;) {
+            auto start = now;
+            bool done = LuaExternalMemory::step(L, size_t(m_step_size) * 1024 + debt);
+            debt = 0;
+            now = Clock::now();
+            m_stats.record(now - start);
+            if (done) return true;
+            if (now + (now - start) > deadline) return false;
+        }
+    }
+
+    /**
+     * Run a full collection cycle, the pause is recorded in stats()
+     */
+    void collect()
+    {
+        auto start = Clock::now();
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        m_stats.record(Clock::now() - start);
+    }
+
+    /**
+     * Set the amount of work done by a single step in step(), in KB of allocation
+     * the collector should account for. 0 means a basic step.
+     */
+    void setStepSize(int kb)
+    {
+        m_step_size = kb > 0 ? kb : 0;
+    }
+
+    /**
+     * Switch to incremental mode, parameters are in the Lua manual units, 0 keeps the current value.
+     *
+     * @param pause how long the collector waits before starting a new cycle (percent)
+     * @param stepmul the speed of the collector relative to memory allocation (percent)
+     * @param stepsize the size of each incremental step
+     */
+    void setIncremental(int pause = 0, int stepmul = 0, int stepsize = 0)
+    {
+#if defined(LUA_GCPARAM)
+        lua_gc(L, LUA_GCINC);
+        setParam(LUA_GCPPAUSE, pause);
+        setParam(LUA_GCPSTEPMUL, stepmul);
+        setParam(LUA_GCPSTEPSIZE, stepsize);
+#elif defined(LUA_GCINC)
+        lua_gc(L, LUA_GCINC, pause, stepmul, stepsize);
+#else
+        if (pause > 0) lua_gc(L, LUA_GCSETPAUSE, pause);
+        if (stepmul > 0) lua_gc(L, LUA_GCSETSTEPMUL, stepmul);
+        (void)stepsize;
+#endif
+        m_mode = LuaGCMode::INCREMENTAL;
+    }
+
+    /**
+     * Switch to generational mode, parameters are in the Lua manual units, 0 keeps the current value.
+     * Generational mode requires Lua 5.4 or later.
+     *
+     * @param minormul the frequency of minor collections (percent)
+     * @param majormul the threshold for major collections (percent)
+     * @throw LuaException if the Lua version does not support generational mode
+     */
+    void setGenerational(int minormul = 0, int majormul = 0)
+    {
+#if defined(LUA_GCPARAM)
+        lua_gc(L, LUA_GCGEN);
+        setParam(LUA_GCPMINORMUL, minormul);
+        setParam(LUA_GCPMAJORMINOR, majormul);
+#elif defined(LUA_GCGEN)
+        lua_gc(L, LUA_GCGEN, minormul, majormul);
+#else
+        (void)minormul;
+        (void)majormul;
+        throw LuaException("generational gc is not supported by this Lua version");
+#endif
+        m_mode = LuaGCMode::GENERATIONAL;
+    }
+
+    /**
+     * The collector mode set by this policy
+     */
+    LuaGCMode mode() const
+    {
+        return m_mode;
+    }
+
+    /**
+     * Total memory in use by Lua, in bytes
+     */
+    size_t memoryInUse() const
+    {
+        return size_t(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + size_t(lua_gc(L, LUA_GCCOUNTB, 0));
+    }
+
+    /**
+     * External memory held by Lua owned objects, in bytes, see LuaExternalMemory
+     */
+    size_t externalMemory() const
+    {
+        return LuaExternalMemory::total(L);
+    }
+
+    /**
+     * Pause times of the steps and collections performed by this policy
+     */
+    const LuaGCStats& stats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * Clear the pause time histogram
+     */
+    void resetStats()
+    {
+        m_stats.reset();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+#if defined(LUA_GCPARAM)
+    void setParam(int param, int value)
+    {
+        if (value > 0) lua_gc(L, LUA_GCPARAM, param, value);
+    }
+#endif
+
+private:
+    lua_State* L;
+    int m_step_size = 0;
+    LuaGCMode m_mode = LuaGCMode::INCREMENTAL;
+    LuaGCStats m_stats;
+};
+
+//---------------------------------------------------------------------------
+
+/**
+ * Stop the automatic collection in the current scope, for latency critical sections.
+ * The previous running state is restored when the scope is left.
+ *
+ * @code
+ *   {
+ *       LuaGCPause no_gc(ctx);
+ *       runFrame();
+ *   }
+ * @endcode
+ */
+class LuaGCPause
+{
+public:
+    explicit LuaGCPause(lua_State* L)
+        : m_policy(L)
+        , m_was_running(m_policy.isRunning())
+    {
+        m_policy.stop();
+    }
+
+    ~LuaGCPause()
+    {
+        if (m_was_running) {
+            m_policy.restart();
+        }
+    }
+
+    LuaGCPause(const LuaGCPause&) = delete;
+    LuaGCPause& operator = (const LuaGCPause&) = delete;
+
+private:
+    LuaGCPolicy m_policy;
+    bool m_was_running;
+};
+
+//---------------------------------------------------------------------------
+
 /**
  * Lua state context
  *
@@ -53,10 +542,10 @@ public:
      * @param needImportLibs - true if need to import the standard libraries.
      */
     explicit LuaContext(bool needImportLibs = true)
-        : L(nullptr)
+        : L(luaL_newstate())
         , m_own(true)
+        , m_gc(L)
     {
-        L = luaL_newstate();
         if (!L) throw LuaException("can not allocate new lua state");
 
 #if LUAINTF_LINK_LUA_COMPILED_IN_CXX
@@ -79,6 +568,7 @@ public:
     explicit LuaContext(lua_State* state)
         : L(state)
         , m_own(false)
+        , m_gc(state)
         {}
 
     /**
@@ -194,6 +684,15 @@ public:
         return lua_gc(L, what, data);
     }
 
+    /**
+     * Get the garbage collection policy, for pacing the collector
+     * and measuring its pause times.
+     */
+    LuaGCPolicy& gcPolicy()
+    {
+        return m_gc;
+    }
+
 #if LUAINTF_LINK_LUA_COMPILED_IN_CXX
 private:
     static int panic(lua_State* L)
@@ -205,6 +704,7 @@ private:
 private:
     lua_State* L;
     bool m_own;
+    LuaGCPolicy m_gc;
 };
 
 //---------------------------------------------------------------------------
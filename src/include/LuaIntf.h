@@ -30,6 +30,26 @@
 //---------------------------------------------------------------------------
 
 #include "LuaContext.h"
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LUAINTF_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace LuaIntf
 {
@@ -42,7 +62,12 @@ namespace LuaIntf
 #include "impl/CppBindModule.h"
 #include "impl/CppBindClass.h"
 #include "impl/CppFunction.h"
+#include "impl/TensorKernels.h"
 #include "impl/TensorView.h"
+#include "impl/StridedTensorView.h"
+#include "impl/AnyTensorView.h"
+#include "impl/TensorMapping.h"
+#include "impl/TensorBuffer.h"
 
 #if LUAINTF_HEADERS_ONLY
 #include "../CppBindModule.cpp"
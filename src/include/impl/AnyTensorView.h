@@ -0,0 +1,457 @@
+//
+// https://github.com/SteveKChiu/lua-intf
+//
+// AnyTensorView: TensorView with element type chosen at runtime
+//
+// Copyright 2026, model_infer contributors
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+
+#ifndef ANYTENSORVIEW_H
+#define ANYTENSORVIEW_H
+
+/**
+ * AnyTensorView is a zero-copy 1-d view whose element type (u8, i8, i32, f16, f32, f64)
+ * is a runtime tag, so one Lua class serves every buffer a model produces.
+ *
+ * Elements are read as double and written with rounding and saturation. Bulk conversion
+ * between element types is vectorized, see TensorConvert.
+ *
+ * Any registered TensorView<T> of a supported type can be passed where an AnyTensorView
+ * is expected, so a bound function needs only one signature:
+ * @code
+ *   LuaBinding(L).beginClass<AnyTensorView>("AnyTensorView")
+ *       .addFunction("dtype", &AnyTensorView::dtypeName)
+ *       .addFunction("convertTo", &AnyTensorView::convertTo, LUA_ARGS(std::string, _def<double, 1>, _def<double, 0>))
+ *       .addRawMetaFunction("__index", &AnyTensorViewMetaMethod::index)
+ *   .endClass()
+ *   .addFunction("info", [](const AnyTensorView& t) { ... });
+ *
+ *   -- Lua side
+ *   local input = image:convertTo("f32", 1 / 255)
+ *   print(input:dtype(), #input, input[1])
+ *   info(float_tensor_view)                         -- TensorView<float> works too
+ * @endcode
+ */
+class AnyTensorView
+{
+public:
+    /**
+     * Default constructor - creates empty u8 view.
+     */
+    AnyTensorView()
+        : m_data(nullptr), m_length(0), m_dtype(TensorDType::U8), m_read_only(false), m_owner(nullptr) {}
+
+    /**
+     * Create view from raw pointer with explicit element type and ownership.
+     *
+     * @param data Raw pointer to array data (must remain valid)
+     * @param dtype Element type
+     * @param len Number of elements in array
+     * @param owner Shared pointer keeping data alive (optional but recommended)
+     */
+    AnyTensorView(void* data, TensorDType dtype, size_t len, std::shared_ptr<void> owner = nullptr)
+        : m_data(data), m_length(len), m_dtype(dtype), m_read_only(false), m_owner(std::move(owner)) {}
+
+    /**
+     * Create view sharing data with a typed view, TensorView<const T> gives a read-only view.
+     */
+    template <typename T>
+    AnyTensorView(const TensorView<T>& view)
+        : m_data(const_cast<void*>(static_cast<const void*>(view.data())))
+        , m_length(view.size())
+        , m_dtype(dtypeOf<T>())
+        , m_read_only(std::is_const<T>::value)
+        , m_owner(view.owner()) {}
+
+    /**
+     * Allocate a new zero filled view, aligned to 64 bytes.
+     */
+    static AnyTensorView allocate(TensorDType dtype, size_t len)
+    {
+        size_t bytes = len * TensorConvert::itemSize(dtype);
+        std::shared_ptr<void> owner(::operator new(bytes, std::align_val_t(64)),
+            [](void* p) { ::operator delete(p, std::align_val_t(64)); });
+        std::memset(owner.get(), 0, bytes);
+        return AnyTensorView(owner.get(), dtype, len, owner);
+    }
+
+    /**
+     * The TensorDType of element type T (const ignored), which must be one of TensorDTypeList
+     */
+    template <typename T>
+    static constexpr TensorDType dtypeOf()
+    {
+        return dtypeOf<std::remove_const_t<T>>(std::make_index_sequence<TENSOR_DTYPE_COUNT>());
+    }
+
+    /**
+     * Name of dtype: "u8", "i8", "i32", "f16", "f32" or "f64"
+     */
+    static const char* nameOf(TensorDType dtype)
+    {
+        static const char* const NAMES[] = { "u8", "i8", "i32", "f16", "f32", "f64" };
+        return NAMES[size_t(dtype)];
+    }
+
+    /**
+     * Parse dtype name.
+     *
+     * @throws std::invalid_argument if name is unknown
+     */
+    static TensorDType parseDType(const std::string& name)
+    {
+        for (size_t i = 0; i < TENSOR_DTYPE_COUNT; i++) {
+            if (name == nameOf(TensorDType(i))) return TensorDType(i);
+        }
+        throw std::invalid_argument("AnyTensorView: unknown dtype '" + name + "'");
+    }
+
+    TensorDType dtype() const { return m_dtype; }
+    const char* dtypeName() const { return nameOf(m_dtype); }
+
+    /**
+     * Size in bytes of one element
+     */
+    int itemSize() const { return static_cast<int>(TensorConvert::itemSize(m_dtype)); }
+
+    /**
+     * Size in bytes of all elements
+     */
+    size_t nbytes() const { return m_length * TensorConvert::itemSize(m_dtype); }
+
+    int length() const { return static_cast<int>(m_length); }
+    size_t size() const { return m_length; }
+    void* data() const { return m_data; }
+    const std::shared_ptr<void>& owner() const { return m_owner; }
+    bool empty() const { return m_length == 0; }
+    bool isValid() const { return m_data != nullptr; }
+
+    /**
+     * Read-only view can not be modified by set, fill or convertFrom
+     */
+    bool isReadOnly() const { return m_read_only; }
+    void setReadOnly(bool read_only) { m_read_only = read_only; }
+
+    /**
+     * Typed view sharing the same data, T must be const for read-only view.
+     *
+     * @throws std::invalid_argument if T does not match dtype
+     * @throws std::logic_error if view is read-only and T is not const
+     */
+    template <typename T>
+    TensorView<T> as() const
+    {
+        if (dtypeOf<T>() != m_dtype) {
+            throw std::invalid_argument(std::string("AnyTensorView: dtype is ") + dtypeName()
+                + ", not " + nameOf(dtypeOf<T>()));
+        }
+        if (!std::is_const<T>::value) checkWritable();
+        return TensorView<T>(static_cast<T*>(m_data), m_length, m_owner);
+    }
+
+    /**
+     * Get element at 1-based Lua index, converted to double.
+     *
+     * @throws std::out_of_range if index is invalid
+     */
+    double get(int idx) const
+    {
+        checkIndex(idx);
+        return visit([&](auto* p) { return load(p[idx - 1]); });
+    }
+
+    /**
+     * Set element at 1-based Lua index, rounded and saturated for integer dtype.
+     *
+     * @throws std::out_of_range if index is invalid
+     * @throws std::logic_error if view is read-only
+     */
+    void set(int idx, double val)
+    {
+        checkIndex(idx);
+        checkWritable();
+        visit([&](auto* p) { store(p[idx - 1], val); });
+    }
+
+    /**
+     * Set all elements to value, rounded and saturated for integer dtype.
+     */
+    void fill(double val)
+    {
+        checkWritable();
+        if (m_length == 0) return;
+        visit([&](auto* p) {
+            store(p[0], val);
+            for (size_t i = 1; i < m_length; i++) p[i] = p[0];
+        });
+    }
+
+    /**
+     * Convert elements from another view of the same length: x = src * scale + bias
+     *
+     * @throws std::invalid_argument if length does not match
+     */
+    void convertFrom(const AnyTensorView& src, double scale = 1, double bias = 0)
+    {
+        if (src.m_length != m_length) {
+            throw std::invalid_argument("AnyTensorView: length mismatch");
+        }
+        checkWritable();
+        TensorConvert::convert(src.m_dtype, src.m_data, m_dtype, m_data, m_length, scale, bias);
+    }
+
+    /**
+     * Convert to a new view of the given dtype name: y = x * scale + bias
+     *
+     * @throws std::invalid_argument if dtype is unknown
+     */
+    AnyTensorView convertTo(const std::string& dtype, double scale = 1, double bias = 0) const
+    {
+        AnyTensorView out = allocate(parseDType(dtype), m_length);
+        out.convertFrom(*this, scale, bias);
+        return out;
+    }
+
+    /**
+     * Sum of all elements (accumulated in double).
+     */
+    double sum() const
+    {
+        return reduce([](auto* p, size_t n) { return TensorKernels<std::remove_const_t<std::remove_pointer_t<decltype(p)>>>::sum(p, n); },
+            [](double a, double b) { return a + b; }, 0);
+    }
+
+    /**
+     * Smallest element.
+     *
+     * @throws std::out_of_range if view is empty
+     */
+    double min() const
+    {
+        checkNotEmpty();
+        return reduce([](auto* p, size_t n) { return double(TensorKernels<std::remove_const_t<std::remove_pointer_t<decltype(p)>>>::min(p, n)); },
+            [](double a, double b) { return b < a ? b : a; }, std::numeric_limits<double>::infinity());
+    }
+
+    /**
+     * Largest element.
+     *
+     * @throws std::out_of_range if view is empty
+     */
+    double max() const
+    {
+        checkNotEmpty();
+        return reduce([](auto* p, size_t n) { return double(TensorKernels<std::remove_const_t<std::remove_pointer_t<decltype(p)>>>::max(p, n)); },
+            [](double a, double b) { return b > a ? b : a; }, -std::numeric_limits<double>::infinity());
+    }
+
+private:
+    template <typename T, size_t... I>
+    static constexpr TensorDType dtypeOf(std::index_sequence<I...>)
+    {
+        static_assert((std::is_same<T, TensorDTypeAt<I>>::value || ...), "AnyTensorView: unsupported element type");
+        size_t index = 0;
+        (void)((std::is_same<T, TensorDTypeAt<I>>::value ? (index = I, true) : false) || ...);
+        return TensorDType(index);
+    }
+
+    /**
+     * Call f with data pointer cast to the element type
+     */
+    template <typename F>
+    auto visit(F&& f) const -> decltype(f(static_cast<double*>(nullptr)))
+    {
+        switch (m_dtype) {
+            case TensorDType::U8: return f(static_cast<uint8_t*>(m_data));
+            case TensorDType::I8: return f(static_cast<int8_t*>(m_data));
+            case TensorDType::I32: return f(static_cast<int32_t*>(m_data));
+            case TensorDType::F16: return f(static_cast<TensorHalf*>(m_data));
+            case TensorDType::F32: return f(static_cast<float*>(m_data));
+            default: return f(static_cast<double*>(m_data));
+        }
+    }
+
+    /**
+     * Reduce with typed kernel, f16 is converted to f32 in blocks first
+     */
+    template <typename K, typename R>
+    double reduce(K kernel, R combine, double init) const
+    {
+        return visit([&](auto* p) -> double {
+            if constexpr (std::is_same<std::remove_pointer_t<decltype(p)>, TensorHalf>::value) {
+                constexpr size_t BLOCK = 1024;
+                float buf[BLOCK];
+                double r = init;
+                for (size_t i = 0; i < m_length; i += BLOCK) {
+                    size_t n = std::min(BLOCK, m_length - i);
+                    TensorConvert::convert(TensorDType::F16, p + i, TensorDType::F32, buf, n);
+                    r = combine(r, kernel(static_cast<const float*>(buf), n));
+                }
+                return r;
+            } else {
+                return kernel(p, m_length);
+            }
+        });
+    }
+
+    template <typename T>
+    static double load(T v)
+    {
+        return TensorDTypeTraits<T>::template load<double>(v);
+    }
+
+    template <typename T>
+    static void store(T& v, double val)
+    {
+        v = TensorDTypeTraits<T>::template store<double>(val);
+    }
+
+    void checkIndex(int idx) const
+    {
+        if (idx < 1 || idx > static_cast<int>(m_length)) {
+            throw std::out_of_range("AnyTensorView: index out of range");
+        }
+    }
+
+    void checkWritable() const
+    {
+        if (m_read_only) {
+            throw std::logic_error("AnyTensorView: view is read-only");
+        }
+    }
+
+    void checkNotEmpty() const
+    {
+        if (m_length == 0) {
+            throw std::out_of_range("AnyTensorView: empty view");
+        }
+    }
+
+private:
+    void* m_data;
+    size_t m_length;
+    TensorDType m_dtype;
+    bool m_read_only;
+    std::shared_ptr<void> m_owner;
+};
+
+//---------------------------------------------------------------------------
+
+/**
+ * Lua conversion for AnyTensorView, accepts AnyTensorView, any registered TensorView<T>
+ * of a supported element type, TensorBuffer (u8) or Lua string (read-only u8).
+ * Pushing is the same as other bound classes.
+ */
+template <>
+struct LuaTypeMapping <AnyTensorView>
+{
+    static void push(lua_State* L, const AnyTensorView& view)
+    {
+        LuaClassMapping<AnyTensorView>::push(L, view);
+    }
+
+    // defined in TensorBuffer.h, after LuaStringView and TensorBuffer
+    static AnyTensorView get(lua_State* L, int index);
+
+    static AnyTensorView opt(lua_State* L, int index, const AnyTensorView& def)
+    {
+        return lua_isnoneornil(L, index) ? def : get(L, index);
+    }
+
+    template <size_t... I>
+    static bool castTyped(lua_State* L, int index, AnyTensorView& view, std::index_sequence<I...>)
+    {
+        return (castTyped<TensorDTypeAt<I>>(L, index, view) || ...);
+    }
+
+    template <typename T>
+    static bool castTyped(lua_State* L, int index, AnyTensorView& view)
+    {
+        // returns nullptr for unregistered class as well
+        TensorView<T>* typed = CppObject::cast<TensorView<T>>(L, index, true);
+        if (typed) view = AnyTensorView(*typed);
+        return typed != nullptr;
+    }
+};
+
+//---------------------------------------------------------------------------
+
+/**
+ * Raw metamethods for AnyTensorView, same as TensorViewMetaMethod but the element
+ * is converted from and to Lua number according to dtype.
+ */
+struct AnyTensorViewMetaMethod
+{
+    /**
+     * __index metamethod, view[i] or view.method
+     */
+    static int index(lua_State* L)
+    {
+        if (lua_type(L, 2) != LUA_TNUMBER) {
+            return CppBindClassMetaMethod::index(L);
+        }
+        AnyTensorView* view = CppObject::get<AnyTensorView>(L, 1, true);
+        int i = checkIndex(L, view);
+        if (view->dtype() == TensorDType::F16 || view->dtype() == TensorDType::F32 || view->dtype() == TensorDType::F64) {
+            lua_pushnumber(L, static_cast<lua_Number>(view->get(i)));
+        } else {
+            lua_pushinteger(L, static_cast<lua_Integer>(view->get(i)));
+        }
+        return 1;
+    }
+
+    /**
+     * __newindex metamethod, view[i] = value
+     */
+    static int newIndex(lua_State* L)
+    {
+        if (lua_type(L, 2) != LUA_TNUMBER) {
+            return CppBindClassMetaMethod::newIndex(L);
+        }
+        AnyTensorView* view = CppObject::get<AnyTensorView>(L, 1, false);
+        int i = checkIndex(L, view);
+        if (view->isReadOnly()) {
+            return luaL_error(L, "AnyTensorView: view is read-only");
+        }
+        view->set(i, static_cast<double>(luaL_checknumber(L, 3)));
+        return 0;
+    }
+
+    /**
+     * __newindex metamethod for const view, element is read-only
+     */
+    static int newIndexConst(lua_State* L)
+    {
+        if (lua_type(L, 2) != LUA_TNUMBER) {
+            return CppBindClassMetaMethod::newIndex(L);
+        }
+        return luaL_error(L, "AnyTensorView: can not modify element of const view");
+    }
+
+    /**
+     * __len metamethod, #view
+     */
+    static int len(lua_State* L)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(CppObject::get<AnyTensorView>(L, 1, true)->size()));
+        return 1;
+    }
+
+private:
+    static int checkIndex(lua_State* L, AnyTensorView* view)
+    {
+        int is_int = 0;
+        lua_Integer idx = lua_tointegerx(L, 2, &is_int);
+        if (!is_int) {
+            luaL_error(L, "AnyTensorView: index must be integer");
+        }
+        if (idx < 1 || static_cast<lua_Unsigned>(idx) > view->size()) {
+            luaL_error(L, "AnyTensorView: index %d out of range [1, %d]", int(idx), int(view->size()));
+        }
+        return static_cast<int>(idx);
+    }
+};
+
+#endif  // ANYTENSORVIEW_H
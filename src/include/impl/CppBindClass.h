@@ -87,7 +87,31 @@ struct CppBindClassDestructor
         
         try {
             CppObject* obj = CppObject::getExactObject<T>(L, 1, IS_CONST);
-            obj->~CppObject();
+            CppObject::destroy(L, obj);
+            return 0;
+        } catch (std::exception& e) {
+            return luaL_error(L, "%s", e.what());
+        }
+    }
+};
+
+template <typename T>
+struct CppBindClassRelease
+{
+    /**
+     * lua_CFunction to release CppObject before it is collected (for release() and __close)
+     *
+     * The object is destroyed in place (or the shared pointer is dropped), and the userdata is
+     * switched to the released metatable, so later access raises an error instead of touching
+     * the destroyed object.
+     */
+    static int call(lua_State* L)
+    {
+        try {
+            CppObject* obj = CppObject::getObject<T>(L, 1, true);
+            CppObject::destroy(L, obj);
+            lua_rawgetp(L, LUA_REGISTRYINDEX, CppReleasedSignature<T>::value());
+            lua_setmetatable(L, 1);
             return 0;
         } catch (std::exception& e) {
             return luaL_error(L, "%s", e.what());
@@ -359,6 +383,21 @@ struct CppBindClassMetaMethod
      * The name of the function is in the first upvalue.
      */
     static int errorConstMismatch(lua_State* L);
+
+    /**
+     * __index metamethod for released object, only the release function is accessible.
+     */
+    static int releasedIndex(lua_State* L);
+
+    /**
+     * __newindex metamethod for released object.
+     */
+    static int releasedNewIndex(lua_State* L);
+
+    /**
+     * lua_CFunction to release an object that is already released, it does nothing.
+     */
+    static int releasedNoOp(lua_State* L);
 };
 
 //--------------------------------------------------------------------------
@@ -393,6 +432,8 @@ protected:
     void setMemberSetter(const char* name, const LuaRef& setter);
     void setMemberReadOnly(const char* name);
     void setMemberFunction(const char* name, const LuaRef& proc, bool is_const);
+    void setMemberRelease(const char* name, void* released_id, lua_CFunction release);
+    void setMemberRawFunction(const char* name, lua_CFunction proc, lua_CFunction proc_const);
 
 public:
     /**
@@ -939,6 +980,59 @@ public:
         return *this;
     }
 
+    /**
+     * Declare the external memory held by the object, for example the size of a pixel buffer
+     * owned by the class. The size is charged to the Lua collector when an object is pushed into
+     * Lua (by value or shared pointer, not raw pointer), and uncharged when the userdata is
+     * collected, so objects with large buffers are collected in proportion to their real footprint.
+     *
+     * The size function is sampled once per userdata, and is shared by all Lua states.
+     *
+     * @param size_of the member function or function (const T*) that returns size in bytes
+     */
+    template <typename FN>
+    CppBindClass<T, PARENT>& addExternalSize(const FN& size_of)
+    {
+        CppObjectExternalSize<T>::function() = [size_of] (const T* obj) -> size_t {
+            return static_cast<size_t>(std::invoke(size_of, obj));
+        };
+        m_meta.rawget("___class").rawset("__gc", &CppBindClassDestructor<T, false>::call);
+        m_meta.rawget("___const").rawset("__gc", &CppBindClassDestructor<T, true>::call);
+        return *this;
+    }
+
+    /**
+     * Add release function and __close metamethod, to destroy the object before it is collected.
+     * This is useful for large temporaries, together with Lua to-be-closed variable:
+     *
+     *     local img <close> = CVLib.imread(path)
+     *
+     * The C++ object is destroyed (or shared pointer is dropped) immediately, and the userdata is
+     * marked released. Any later access raises an error, except calling release again.
+     *
+     * @param name the name of release function
+     */
+    CppBindClass<T, PARENT>& addRelease(const char* name = "release")
+    {
+        setMemberRelease(name, CppReleasedSignature<T>::value(), &CppBindClassRelease<T>::call);
+        return *this;
+    }
+
+    /**
+     * Add or replace a meta function with raw lua_CFunction, the function gets the Lua stack as is,
+     * and it is responsible for checking the object type. This is for hot metamethods like __index
+     * of array-like class, that can not afford the generic method dispatch.
+     *
+     * @param name the meta function name
+     * @param proc the function for non-const object
+     * @param proc_const the function for const object, or nullptr to use proc
+     */
+    CppBindClass<T, PARENT>& addRawMetaFunction(const char* name, lua_CFunction proc, lua_CFunction proc_const = nullptr)
+    {
+        setMemberRawFunction(name, proc, proc_const ? proc_const : proc);
+        return *this;
+    }
+
     /**
      * Open a new or existing class for registrations.
      */
@@ -45,6 +45,26 @@ using CppClassSignature = CppSignature<T, 1>;
 template <typename T>
 using CppConstSignature = CppSignature<T, 2>;
 
+template <typename T>
+using CppReleasedSignature = CppSignature<T, 3>;
+
+//--------------------------------------------------------------------------
+
+/**
+ * The external memory size function for type, set by CppBindClass::addExternalSize
+ */
+template <typename T>
+struct CppObjectExternalSize
+{
+    using Function = std::function<size_t(const T*)>;
+
+    static Function& function()
+    {
+        static Function fn;
+        return fn;
+    }
+};
+
 //--------------------------------------------------------------------------
 
 /**
@@ -73,6 +93,23 @@ protected:
         return mem;
     }
 
+    /**
+     * Charge the external memory held by the object to the Lua state, if the class has
+     * external size function. The size is sampled once here, and uncharged when the object is
+     * collected or released.
+     */
+    template <typename T>
+    void chargeExternalSize(lua_State* L, const T* obj)
+    {
+        auto& size_of = CppObjectExternalSize<T>::function();
+        if (size_of) {
+            m_external_size = size_of(obj);
+            if (m_external_size > 0) {
+                LuaExternalMemory::add(L, m_external_size);
+            }
+        }
+    }
+
 public:
     virtual ~CppObject() {}
 
@@ -92,6 +129,26 @@ public:
      */
     virtual void* objectPtr() = 0;
 
+    /**
+     * The external memory size charged to the Lua state for this object
+     */
+    size_t externalSize() const
+    {
+        return m_external_size;
+    }
+
+    /**
+     * Destroy the object, and uncharge its external memory size
+     */
+    static void destroy(lua_State* L, CppObject* obj)
+    {
+        size_t external_size = obj->m_external_size;
+        obj->~CppObject();
+        if (external_size > 0) {
+            LuaExternalMemory::remove(L, external_size);
+        }
+    }
+
     /**
      * Get internal class id of the given class
      */
@@ -148,6 +205,9 @@ private:
     static void typeMismatchError(lua_State* L, int index);
     static CppObject* getObject(lua_State* L, int index, void* class_id,
         bool is_const, bool is_exact, bool raise_error);
+
+private:
+    size_t m_external_size = 0;
 };
 
 //----------------------------------------------------------------------------
@@ -287,6 +347,7 @@ public:
         void* mem = allocate<CppObjectValue<T>>(L, getClassID<T>(is_const));
         CppObjectValue<T>* v = ::new (mem) CppObjectValue<T>();
         ::new (v->objectPtr()) T(std::forward<P>(args)...);
+        v->chargeExternalSize(L, static_cast<T*>(v->objectPtr()));
     }
 
     template <typename... P>
@@ -295,6 +356,7 @@ public:
         void* mem = allocate<CppObjectValue<T>>(L, getClassID<T>(is_const));
         CppObjectValue<T>* v = ::new (mem) CppObjectValue<T>();
         CppInvokeClassConstructor<T>::call(v->objectPtr(), args);
+        v->chargeExternalSize(L, static_cast<T*>(v->objectPtr()));
     }
 
     static void pushToStack(lua_State* L, const T& obj, bool is_const)
@@ -302,6 +364,7 @@ public:
         void* mem = allocate<CppObjectValue<T>>(L, getClassID<T>(is_const));
         CppObjectValue<T>* v = ::new (mem) CppObjectValue<T>();
         ::new (v->objectPtr()) T(obj);
+        v->chargeExternalSize(L, static_cast<T*>(v->objectPtr()));
     }
 
 private:
@@ -382,14 +445,16 @@ public:
     {
         void* mem = allocate<CppObjectSharedPtr<SP, T>>(L,
             CppAutoDowncast::getClassID(L, obj, is_const));
-        ::new (mem) CppObjectSharedPtr<SP, T>(obj);
+        auto v = ::new (mem) CppObjectSharedPtr<SP, T>(obj);
+        v->chargeExternalSize(L, obj);
     }
 
     static void pushToStack(lua_State* L, const SP& sp, bool is_const)
     {
         void* mem = allocate<CppObjectSharedPtr<SP, T>>(L,
             CppAutoDowncast::getClassID(L, const_cast<T*>(&*sp), is_const));
-        ::new (mem) CppObjectSharedPtr<SP, T>(sp);
+        auto v = ::new (mem) CppObjectSharedPtr<SP, T>(sp);
+        v->chargeExternalSize(L, &*sp);
     }
 
 private:
@@ -0,0 +1,461 @@
+//
+// https://github.com/SteveKChiu/lua-intf
+//
+// StridedTensorView: Zero-copy N-d view with shape and strides
+//
+// Copyright 2026, model_infer contributors
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+
+#ifndef STRIDEDTENSORVIEW_H
+#define STRIDEDTENSORVIEW_H
+
+/**
+ * StridedTensorView is the N-d variant of TensorView.
+ *
+ * The element at index (i1, i2, ..., in) is data[sum((ik - 1) * stride[k])], so slicing,
+ * selecting, transposing and permuting only change shape and strides, never the data.
+ * All views derived from a view share the same owner, the data stays alive as long as any
+ * of them is alive.
+ *
+ * Like TensorView, all indices and dimensions are 1-based (Lua convention).
+ * Negative indices count from the end, -1 is the last element.
+ *
+ * Usage:
+ * @code
+ *   // C++ side: [1, 25200, 85] model output
+ *   auto out = std::make_shared<std::vector<float>>(25200 * 85);
+ *   StridedTensorView<float> view(out->data(), {1, 25200, 85}, out);
+ *
+ *   LuaBinding(L).beginClass<StridedTensorView<float>>("FloatStridedView")
+ *       .addFunction("get", &StridedTensorView<float>::get)
+ *       .addFunction("row", &StridedTensorView<float>::row)
+ *       .addFunction("slice", &StridedTensorView<float>::slice, LUA_ARGS(int, int, int, _def<int, 1>))
+ *   .endClass();
+ *
+ *   -- Lua side: one detection at a time, without copying the output
+ *   for i = 1, view:rows() do
+ *       local det = view:row(i)     -- TensorView of 85 elements
+ *       local score = det:get(5)
+ *   end
+ * @endcode
+ */
+template <typename T>
+class StridedTensorView
+{
+public:
+    static constexpr int MAX_DIMS = 8;
+
+private:
+    T* data_;
+    int ndim_;
+    std::array<size_t, MAX_DIMS> shape_;
+    std::array<ptrdiff_t, MAX_DIMS> strides_;
+    std::shared_ptr<void> owner_;  // Keeps data alive
+
+public:
+    /**
+     * Default constructor - creates empty view.
+     */
+    StridedTensorView()
+        : data_(nullptr), ndim_(0), shape_{}, strides_{} {}
+
+    /**
+     * Create contiguous (row-major) view from raw pointer.
+     *
+     * @param data Raw pointer to array data (must remain valid)
+     * @param shape Size of each dimension
+     * @param owner Shared pointer keeping data alive (optional but recommended)
+     */
+    StridedTensorView(T* data, const std::vector<size_t>& shape, std::shared_ptr<void> owner = nullptr)
+        : data_(data), ndim_(0), shape_{}, strides_{}, owner_(std::move(owner))
+    {
+        setShape(shape);
+        ptrdiff_t stride = 1;
+        for (int d = ndim_ - 1; d >= 0; d--) {
+            strides_[d] = stride;
+            stride *= static_cast<ptrdiff_t>(shape_[d]);
+        }
+    }
+
+    /**
+     * Create view from raw pointer with explicit strides (in elements, not bytes).
+     *
+     * @param data Raw pointer to array data (must remain valid)
+     * @param shape Size of each dimension
+     * @param strides Distance between consecutive elements of each dimension
+     * @param owner Shared pointer keeping data alive (optional but recommended)
+     */
+    StridedTensorView(T* data, const std::vector<size_t>& shape, const std::vector<ptrdiff_t>& strides,
+            std::shared_ptr<void> owner = nullptr)
+        : data_(data), ndim_(0), shape_{}, strides_{}, owner_(std::move(owner))
+    {
+        if (strides.size() != shape.size()) {
+            throw std::invalid_argument("StridedTensorView: shape and strides size mismatch");
+        }
+        setShape(shape);
+        std::copy(strides.begin(), strides.end(), strides_.begin());
+    }
+
+    /**
+     * Create 1-d view sharing the data and owner of TensorView.
+     */
+    explicit StridedTensorView(const TensorView<T>& view)
+        : StridedTensorView(view.data(), {view.size()}, view.owner()) {}
+
+    /**
+     * Number of dimensions
+     */
+    int ndim() const { return ndim_; }
+
+    /**
+     * Total number of elements
+     */
+    size_t size() const
+    {
+        if (ndim_ == 0) return 0;
+        size_t n = 1;
+        for (int d = 0; d < ndim_; d++) n *= shape_[d];
+        return n;
+    }
+
+    /**
+     * Size of the given dimension (1-based)
+     */
+    size_t size(int dim) const { return shape_[checkDim(dim)]; }
+
+    /**
+     * Stride of the given dimension (1-based), in elements
+     */
+    ptrdiff_t stride(int dim) const { return strides_[checkDim(dim)]; }
+
+    /**
+     * Get shape as Lua table
+     */
+    std::vector<int> getShape() const
+    {
+        return std::vector<int>(shape_.begin(), shape_.begin() + ndim_);
+    }
+
+    /**
+     * Get strides as Lua table
+     */
+    std::vector<int> getStrides() const
+    {
+        return std::vector<int>(strides_.begin(), strides_.begin() + ndim_);
+    }
+
+    /**
+     * Whether the elements are laid out row-major without gaps
+     */
+    bool isContiguous() const
+    {
+        ptrdiff_t expected = 1;
+        for (int d = ndim_ - 1; d >= 0; d--) {
+            if (shape_[d] != 1 && strides_[d] != expected) return false;
+            expected *= static_cast<ptrdiff_t>(shape_[d]);
+        }
+        return true;
+    }
+
+    /**
+     * Get raw pointer to the first element.
+     */
+    T* data() const { return data_; }
+
+    /**
+     * Get the owner that keeps data alive (may be null).
+     */
+    const std::shared_ptr<void>& owner() const { return owner_; }
+
+    /**
+     * Check if view is empty.
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * Check if view is valid (has data pointer).
+     */
+    bool isValid() const { return data_ != nullptr; }
+
+    /**
+     * Get element reference at 1-based index (one index per dimension).
+     *
+     * @throws std::out_of_range if index is invalid
+     */
+    T& at(std::initializer_list<int> idx) const
+    {
+        if (static_cast<int>(idx.size()) != ndim_) {
+            throw std::out_of_range("StridedTensorView: index count does not match dimensions");
+        }
+        ptrdiff_t offset = 0;
+        int d = 0;
+        for (int i : idx) {
+            offset += static_cast<ptrdiff_t>(checkIndex(d, i)) * strides_[d];
+            d++;
+        }
+        return data_[offset];
+    }
+
+    /**
+     * Lua: view:get(i1, i2, ..., in) - get element at 1-based index
+     */
+    int get(lua_State* L) const
+    {
+        LuaType<T>::push(L, data_[offsetFromStack(L)]);
+        return 1;
+    }
+
+    /**
+     * Lua: view:set(i1, i2, ..., in, value) - set element at 1-based index
+     */
+    int set(lua_State* L)
+    {
+        ptrdiff_t offset = offsetFromStack(L);
+        data_[offset] = LuaType<T>::get(L, ndim_ + 2);
+        return 0;
+    }
+
+    /**
+     * Narrow a dimension to the range [first, last] (1-based, inclusive, like string.sub).
+     *
+     * @param dim Dimension to slice
+     * @param first First index
+     * @param last Last index, negative counts from the end
+     * @param step Step between selected elements (positive)
+     */
+    StridedTensorView slice(int dim, int first, int last, int step = 1) const
+    {
+        int d = checkDim(dim);
+        if (step < 1) {
+            throw std::invalid_argument("StridedTensorView: slice step must be positive");
+        }
+        size_t from = checkIndex(d, first);
+        size_t to = checkIndex(d, last);
+        StridedTensorView v(*this);
+        if (to < from) {
+            v.shape_[d] = 0;
+        } else {
+            v.data_ = data_ + static_cast<ptrdiff_t>(from) * strides_[d];
+            v.shape_[d] = (to - from) / step + 1;
+            v.strides_[d] = strides_[d] * step;
+        }
+        return v;
+    }
+
+    /**
+     * Select one index of a dimension, the dimension is removed from the result.
+     * A 1-d view has no 0-d result, use get(i) for its elements.
+     */
+    StridedTensorView select(int dim, int index) const
+    {
+        int d = checkDim(dim);
+        if (ndim_ == 1) {
+            throw std::logic_error("StridedTensorView: select needs 2 or more dimensions, use get(i) on 1-d view");
+        }
+        size_t i = checkIndex(d, index);
+        StridedTensorView v(*this);
+        v.data_ = data_ + static_cast<ptrdiff_t>(i) * strides_[d];
+        for (int k = d; k < ndim_ - 1; k++) {
+            v.shape_[k] = shape_[k + 1];
+            v.strides_[k] = strides_[k + 1];
+        }
+        v.ndim_ = ndim_ - 1;
+        return v;
+    }
+
+    /**
+     * Swap two dimensions.
+     */
+    StridedTensorView transpose(int dim0, int dim1) const
+    {
+        int d0 = checkDim(dim0);
+        int d1 = checkDim(dim1);
+        StridedTensorView v(*this);
+        std::swap(v.shape_[d0], v.shape_[d1]);
+        std::swap(v.strides_[d0], v.strides_[d1]);
+        return v;
+    }
+
+    /**
+     * Reorder dimensions, result dimension k is the source dimension dims[k].
+     */
+    StridedTensorView permute(const std::vector<int>& dims) const
+    {
+        if (static_cast<int>(dims.size()) != ndim_) {
+            throw std::invalid_argument("StridedTensorView: permute needs one entry per dimension");
+        }
+        std::array<bool, MAX_DIMS> used {};
+        StridedTensorView v(*this);
+        for (int k = 0; k < ndim_; k++) {
+            int d = checkDim(dims[k]);
+            if (used[d]) {
+                throw std::invalid_argument("StridedTensorView: permute has repeated dimension");
+            }
+            used[d] = true;
+            v.shape_[k] = shape_[d];
+            v.strides_[k] = strides_[d];
+        }
+        return v;
+    }
+
+    /**
+     * Change shape without copying, only for contiguous view.
+     * One dimension may be -1, it is inferred from the total size.
+     */
+    StridedTensorView reshape(const std::vector<int>& shape) const
+    {
+        if (!isContiguous()) {
+            throw std::logic_error("StridedTensorView: reshape needs contiguous view, use clone() first");
+        }
+        std::vector<size_t> new_shape(shape.size());
+        size_t known = 1;
+        int infer = -1;
+        for (size_t k = 0; k < shape.size(); k++) {
+            if (shape[k] == -1 && infer < 0) {
+                infer = static_cast<int>(k);
+            } else if (shape[k] < 0) {
+                throw std::invalid_argument("StridedTensorView: invalid reshape dimension");
+            } else {
+                new_shape[k] = static_cast<size_t>(shape[k]);
+                known *= new_shape[k];
+            }
+        }
+        if (infer >= 0) {
+            if (known == 0 || size() % known != 0) {
+                throw std::invalid_argument("StridedTensorView: can not infer reshape dimension");
+            }
+            new_shape[infer] = size() / known;
+            known *= new_shape[infer];
+        }
+        if (known != size()) {
+            throw std::invalid_argument("StridedTensorView: reshape size mismatch");
+        }
+        return StridedTensorView(data_, new_shape, owner_);
+    }
+
+    /**
+     * Number of rows, that is the number of lines along the last dimension.
+     */
+    size_t rows() const
+    {
+        return (ndim_ == 0 || shape_[ndim_ - 1] == 0) ? 0 : size() / shape_[ndim_ - 1];
+    }
+
+    /**
+     * Get the i-th line along the last dimension as 1-d TensorView (1-based),
+     * leading dimensions are counted in row-major order. The last dimension must be contiguous.
+     * For a [1, 25200, 85] output, row(i) is the i-th detection of 85 values.
+     */
+    TensorView<T> row(int index) const
+    {
+        if (ndim_ == 0) {
+            throw std::out_of_range("StridedTensorView: row of empty view");
+        }
+        if (shape_[ndim_ - 1] > 1 && strides_[ndim_ - 1] != 1) {
+            throw std::logic_error("StridedTensorView: row needs contiguous last dimension");
+        }
+        size_t n = rows();
+        if (index < 0) index += static_cast<int>(n) + 1;
+        if (index < 1 || static_cast<size_t>(index) > n) {
+            throw std::out_of_range("StridedTensorView: row index out of range");
+        }
+        size_t r = static_cast<size_t>(index - 1);
+        ptrdiff_t offset = 0;
+        for (int d = ndim_ - 2; d >= 0; d--) {
+            offset += static_cast<ptrdiff_t>(r % shape_[d]) * strides_[d];
+            r /= shape_[d];
+        }
+        return TensorView<T>(data_ + offset, shape_[ndim_ - 1], owner_);
+    }
+
+    /**
+     * Get contiguous view as 1-d TensorView.
+     */
+    TensorView<T> flat() const
+    {
+        if (!isContiguous()) {
+            throw std::logic_error("StridedTensorView: flat needs contiguous view, use clone() first");
+        }
+        return TensorView<T>(data_, size(), owner_);
+    }
+
+    /**
+     * Copy elements into new contiguous storage.
+     */
+    StridedTensorView<typename std::remove_const<T>::type> clone() const
+    {
+        using V = typename std::remove_const<T>::type;
+        auto storage = std::make_shared<std::vector<V>>(size());
+        V* dst = storage->data();
+        forEach([&dst] (T& v) { *dst++ = v; });
+        std::vector<size_t> shape(shape_.begin(), shape_.begin() + ndim_);
+        return StridedTensorView<V>(storage->data(), shape, storage);
+    }
+
+    /**
+     * Visit all elements in row-major order.
+     */
+    template <typename FN>
+    void forEach(FN&& fn) const
+    {
+        if (empty()) return;
+        std::array<size_t, MAX_DIMS> idx {};
+        int last = ndim_ - 1;
+        T* p = data_;
+        for (;;) {
+            T* q = p;
+            for (size_t i = 0; i < shape_[last]; i++, q += strides_[last]) {
+                fn(*q);
+            }
+            int d = last - 1;
+            for (; d >= 0; d--) {
+                p += strides_[d];
+                if (++idx[d] < shape_[d]) break;
+                p -= static_cast<ptrdiff_t>(shape_[d]) * strides_[d];
+                idx[d] = 0;
+            }
+            if (d < 0) return;
+        }
+    }
+
+private:
+    void setShape(const std::vector<size_t>& shape)
+    {
+        if (shape.size() > MAX_DIMS) {
+            throw std::invalid_argument("StridedTensorView: too many dimensions");
+        }
+        ndim_ = static_cast<int>(shape.size());
+        std::copy(shape.begin(), shape.end(), shape_.begin());
+    }
+
+    int checkDim(int dim) const
+    {
+        if (dim < 0) dim += ndim_ + 1;
+        if (dim < 1 || dim > ndim_) {
+            throw std::out_of_range("StridedTensorView: dimension out of range");
+        }
+        return dim - 1;
+    }
+
+    size_t checkIndex(int d, int index) const
+    {
+        if (index < 0) index += static_cast<int>(shape_[d]) + 1;
+        if (index < 1 || static_cast<size_t>(index) > shape_[d]) {
+            throw std::out_of_range("StridedTensorView: index out of range");
+        }
+        return static_cast<size_t>(index - 1);
+    }
+
+    ptrdiff_t offsetFromStack(lua_State* L) const
+    {
+        ptrdiff_t offset = 0;
+        for (int d = 0; d < ndim_; d++) {
+            offset += static_cast<ptrdiff_t>(checkIndex(d, static_cast<int>(luaL_checkinteger(L, d + 2)))) * strides_[d];
+        }
+        return offset;
+    }
+};
+
+#endif  // STRIDEDTENSORVIEW_H
@@ -0,0 +1,273 @@
+//
+// https://github.com/SteveKChiu/lua-intf
+//
+// TensorBuffer: Zero-copy tensor views over Lua strings and mutable byte buffers
+//
+// Copyright 2026, model_infer contributors
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+
+#ifndef TENSORBUFFER_H
+#define TENSORBUFFER_H
+
+/**
+ * Read-only views over Lua strings, without copying the string.
+ *
+ * The view pins the string with a LuaRef in its owner, so it stays valid while the view
+ * is alive, but the view must not outlive the lua_State and must be released on the
+ * thread that runs Lua.
+ *
+ * Usage:
+ * @code
+ *   // in a lua_CFunction or raw member function
+ *   TensorView<const uint8_t> bytes = LuaStringView::view<uint8_t>(L, 2);
+ *   TensorView<const float> floats = LuaStringView::view<float>(L, 2);   // reinterpret
+ *
+ *   // or as argument of bound function, Lua string is accepted directly
+ *   .addFunction("crc", [](TensorView<const uint8_t> bytes) { ... })
+ *   .addFunction("info", [](const AnyTensorView& view) { ... })        // read-only u8
+ * @endcode
+ */
+struct LuaStringView
+{
+    /**
+     * View Lua string at index as const T, string length must be a multiple of sizeof(T)
+     * and string data must be aligned for T. A Lua error is raised otherwise.
+     */
+    template <typename T>
+    static TensorView<const T> view(lua_State* L, int index)
+    {
+        size_t len = 0;
+        const char* data = checkString(L, index, len);
+        if (len % sizeof(T) != 0) {
+            luaL_error(L, "LuaStringView: string length %d is not a multiple of element size %d",
+                int(len), int(sizeof(T)));
+        }
+        if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0) {
+            luaL_error(L, "LuaStringView: string data is not aligned for element size %d", int(sizeof(T)));
+        }
+        return TensorView<const T>(reinterpret_cast<const T*>(data), len / sizeof(T), pin(L, index));
+    }
+
+    /**
+     * View Lua string at index as read-only AnyTensorView of dtype
+     */
+    static AnyTensorView anyView(lua_State* L, int index, TensorDType dtype = TensorDType::U8)
+    {
+        size_t len = 0;
+        const char* data = checkString(L, index, len);
+        size_t item_size = TensorConvert::itemSize(dtype);
+        if (len % item_size != 0 || reinterpret_cast<uintptr_t>(data) % item_size != 0) {
+            luaL_error(L, "LuaStringView: string is not a multiple of %s or not aligned",
+                AnyTensorView::nameOf(dtype));
+        }
+        AnyTensorView view(const_cast<char*>(data), dtype, len / item_size, pin(L, index));
+        view.setReadOnly(true);
+        return view;
+    }
+
+private:
+    static const char* checkString(lua_State* L, int index, size_t& len)
+    {
+        // numbers are not converted, that would replace the stack value
+        if (lua_type(L, index) != LUA_TSTRING) {
+            luaL_error(L, "LuaStringView: string expected, got %s", luaL_typename(L, index));
+        }
+        return lua_tolstring(L, index, &len);
+    }
+
+    static std::shared_ptr<void> pin(lua_State* L, int index)
+    {
+        return std::make_shared<LuaRef>(L, index);
+    }
+};
+
+//---------------------------------------------------------------------------
+
+/**
+ * Mutable byte buffer, 64 byte aligned and zero filled, for scripts to fill and pass to
+ * C++ kernels without copy. Typed views share the storage and keep it alive.
+ *
+ * Usage:
+ * @code
+ *   LuaBinding(L).beginClass<TensorBuffer>("Buffer")
+ *       .addConstructor(LUA_ARGS(size_t))
+ *       .addFunction("write", &TensorBuffer::write)
+ *       .addFunction("view", &TensorBuffer::anyView)
+ *       .addExternalSize(&TensorBuffer::size)
+ *   .endClass();
+ *
+ *   -- Lua side
+ *   local buf = Buffer(4096)
+ *   buf:write(1, sock:receive(4096))
+ *   run_kernel(buf:view("f32"))
+ * @endcode
+ */
+class TensorBuffer
+{
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    /**
+     * Default constructor - creates empty buffer.
+     */
+    TensorBuffer() : m_size(0) {}
+
+    /**
+     * Allocate zero filled buffer of nbytes.
+     */
+    explicit TensorBuffer(size_t nbytes)
+        : m_size(nbytes)
+        , m_storage(::operator new(std::max<size_t>(nbytes, 1), std::align_val_t(ALIGNMENT)),
+            [](void* p) { ::operator delete(p, std::align_val_t(ALIGNMENT)); })
+    {
+        std::memset(m_storage.get(), 0, nbytes);
+    }
+
+    /**
+     * Size in bytes
+     */
+    size_t size() const { return m_size; }
+    int length() const { return static_cast<int>(m_size); }
+
+    uint8_t* data() const { return static_cast<uint8_t*>(m_storage.get()); }
+    const std::shared_ptr<void>& owner() const { return m_storage; }
+
+    /**
+     * Set all bytes to value.
+     */
+    void fill(uint8_t value)
+    {
+        if (m_size > 0) std::memset(m_storage.get(), value, m_size);
+    }
+
+    /**
+     * Copy bytes into buffer at 1-based byte position (Lua convention).
+     *
+     * @throws std::out_of_range if bytes do not fit
+     */
+    void write(int pos, std::string_view bytes)
+    {
+        size_t offset = checkRange(pos, bytes.size());
+        if (!bytes.empty()) std::memcpy(data() + offset, bytes.data(), bytes.size());
+    }
+
+    /**
+     * Copy len bytes from 1-based byte position out as string.
+     *
+     * @throws std::out_of_range if range is outside buffer
+     */
+    std::string read(int pos, int len) const
+    {
+        size_t n = static_cast<size_t>(std::max(len, 0));
+        size_t offset = checkRange(pos, n);
+        return std::string(reinterpret_cast<const char*>(data()) + offset, n);
+    }
+
+    /**
+     * Typed view of whole buffer, size must be a multiple of sizeof(T).
+     *
+     * @throws std::invalid_argument if size is not a multiple of sizeof(T)
+     */
+    template <typename T>
+    TensorView<T> view() const
+    {
+        static_assert(alignof(T) <= ALIGNMENT, "TensorBuffer: element alignment too large");
+        if (m_size % sizeof(T) != 0) {
+            throw std::invalid_argument("TensorBuffer: size is not a multiple of element size");
+        }
+        return TensorView<T>(reinterpret_cast<T*>(data()), m_size / sizeof(T), m_storage);
+    }
+
+    /**
+     * Dtype-erased view of whole buffer.
+     *
+     * @throws std::invalid_argument if dtype is unknown or size is not a multiple of item size
+     */
+    AnyTensorView anyView(const std::string& dtype) const
+    {
+        TensorDType type = AnyTensorView::parseDType(dtype);
+        size_t item_size = TensorConvert::itemSize(type);
+        if (m_size % item_size != 0) {
+            throw std::invalid_argument("TensorBuffer: size is not a multiple of element size");
+        }
+        return AnyTensorView(data(), type, m_size / item_size, m_storage);
+    }
+
+private:
+    size_t checkRange(int pos, size_t n) const
+    {
+        if (pos < 1 || static_cast<size_t>(pos - 1) + n > m_size) {
+            throw std::out_of_range("TensorBuffer: range out of buffer");
+        }
+        return static_cast<size_t>(pos - 1);
+    }
+
+private:
+    size_t m_size;
+    std::shared_ptr<void> m_storage;
+};
+
+//---------------------------------------------------------------------------
+
+/**
+ * Lua conversion for TensorView<const T>, accepts a Lua string (see LuaStringView),
+ * TensorBuffer or a registered TensorView<T> object. Pushing is the same as other bound classes.
+ */
+template <typename T>
+struct LuaTypeMapping <TensorView<const T>>
+{
+    static void push(lua_State* L, const TensorView<const T>& view)
+    {
+        LuaClassMapping<TensorView<const T>>::push(L, view);
+    }
+
+    static TensorView<const T> get(lua_State* L, int index)
+    {
+        if (lua_type(L, index) == LUA_TSTRING) {
+            return LuaStringView::view<T>(L, index);
+        }
+        if (TensorView<T>* view = CppObject::cast<TensorView<T>>(L, index, true)) {
+            return TensorView<const T>(view->data(), view->size(), view->owner());
+        }
+        if (TensorBuffer* buffer = CppObject::cast<TensorBuffer>(L, index, true)) {
+            if (buffer->size() % sizeof(T) != 0) {
+                luaL_error(L, "TensorBuffer: size is not a multiple of element size %d", int(sizeof(T)));
+            }
+            return buffer->view<const T>();
+        }
+        if (TensorView<const T>* view = CppObject::cast<TensorView<const T>>(L, index, true)) {
+            return *view;
+        }
+        luaL_error(L, "string, TensorBuffer or TensorView expected, got %s", luaL_typename(L, index));
+        return TensorView<const T>();
+    }
+
+    static TensorView<const T> opt(lua_State* L, int index, const TensorView<const T>& def)
+    {
+        return lua_isnoneornil(L, index) ? def : get(L, index);
+    }
+};
+
+//---------------------------------------------------------------------------
+
+inline AnyTensorView LuaTypeMapping<AnyTensorView>::get(lua_State* L, int index)
+{
+    if (lua_type(L, index) == LUA_TSTRING) {
+        return LuaStringView::anyView(L, index);
+    }
+    if (AnyTensorView* view = CppObject::cast<AnyTensorView>(L, index, true)) {
+        return *view;
+    }
+    if (TensorBuffer* buffer = CppObject::cast<TensorBuffer>(L, index, true)) {
+        return AnyTensorView(buffer->data(), TensorDType::U8, buffer->size(), buffer->owner());
+    }
+    AnyTensorView view;
+    if (!castTyped(L, index, view, std::make_index_sequence<TENSOR_DTYPE_COUNT>())) {
+        luaL_error(L, "AnyTensorView, TensorView, TensorBuffer or string expected, got %s", luaL_typename(L, index));
+    }
+    return view;
+}
+
+#endif  // TENSORBUFFER_H
@@ -0,0 +1,885 @@
+//
+// https://github.com/SteveKChiu/lua-intf
+//
+// TensorKernels: Vectorized bulk operations for TensorView
+//
+// Copyright 2026, model_infer contributors
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+
+#ifndef TENSORKERNELS_H
+#define TENSORKERNELS_H
+
+/**
+ * Kernels are written once with GCC/Clang vector extensions and compiled for several
+ * instruction sets. On x86-64 the widest one supported by the CPU (SSE2, AVX2 or AVX-512)
+ * is selected once at first use. On other GNU targets the 16 byte version is used,
+ * and other compilers (or LUAINTF_NO_SIMD) get the scalar reference only.
+ */
+#if !defined(LUAINTF_NO_SIMD) && defined(__GNUC__)
+    #define LUAINTF_SIMD 1
+    #if defined(__x86_64__) || defined(__i386__)
+        #define LUAINTF_SIMD_X86 1
+    #endif
+#endif
+
+/**
+ * Instruction set level used by TensorKernels
+ */
+enum class TensorKernelLevel
+{
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+/**
+ * Name of level as used by the Lua modules: "scalar", "sse", "avx2" or "avx512"
+ */
+inline const char* tensorKernelLevelName(TensorKernelLevel level)
+{
+    switch (level) {
+        case TensorKernelLevel::AVX512: return "avx512";
+        case TensorKernelLevel::AVX2: return "avx2";
+        case TensorKernelLevel::SSE2: return "sse";
+        default: return "scalar";
+    }
+}
+
+/**
+ * Parse level name, see tensorKernelLevelName.
+ *
+ * @throws std::invalid_argument if name is unknown
+ */
+inline TensorKernelLevel parseTensorKernelLevel(const std::string& name)
+{
+    for (TensorKernelLevel level : { TensorKernelLevel::SCALAR, TensorKernelLevel::SSE2,
+            TensorKernelLevel::AVX2, TensorKernelLevel::AVX512 }) {
+        if (name == tensorKernelLevelName(level)) return level;
+    }
+    throw std::invalid_argument("kernel level must be scalar, sse, avx2 or avx512, got '" + name + "'");
+}
+
+//---------------------------------------------------------------------------
+
+/**
+ * Scalar reference kernels, used for types without vector kernels and for testing.
+ */
+template <typename T>
+struct TensorScalarKernel
+{
+    static void fill(T* x, size_t n, T v)
+    {
+        for (size_t i = 0; i < n; i++) x[i] = v;
+    }
+
+    static void scale(T* x, size_t n, T a)
+    {
+        for (size_t i = 0; i < n; i++) x[i] = static_cast<T>(x[i] * a);
+    }
+
+    static void addScalar(T* x, size_t n, T a)
+    {
+        for (size_t i = 0; i < n; i++) x[i] = static_cast<T>(x[i] + a);
+    }
+
+    static void axpy(T* y, const T* x, size_t n, T a)
+    {
+        for (size_t i = 0; i < n; i++) y[i] = static_cast<T>(y[i] + a * x[i]);
+    }
+
+    static void clamp(T* x, size_t n, T lo, T hi)
+    {
+        for (size_t i = 0; i < n; i++) x[i] = x[i] < lo ? lo : (x[i] > hi ? hi : x[i]);
+    }
+
+    static double sum(const T* x, size_t n)
+    {
+        double s = 0;
+        for (size_t i = 0; i < n; i++) s += x[i];
+        return s;
+    }
+
+    static double dot(const T* x, const T* y, size_t n)
+    {
+        double s = 0;
+        for (size_t i = 0; i < n; i++) s += double(x[i]) * double(y[i]);
+        return s;
+    }
+
+    static T min(const T* x, size_t n)
+    {
+        T m = x[0];
+        for (size_t i = 1; i < n; i++) m = x[i] < m ? x[i] : m;
+        return m;
+    }
+
+    static T max(const T* x, size_t n)
+    {
+        T m = x[0];
+        for (size_t i = 1; i < n; i++) m = x[i] > m ? x[i] : m;
+        return m;
+    }
+
+    static size_t argmax(const T* x, size_t n)
+    {
+        size_t best = 0;
+        for (size_t i = 1; i < n; i++) best = x[i] > x[best] ? i : best;
+        return best;
+    }
+
+    static void sigmoid(T* x, size_t n)
+    {
+        for (size_t i = 0; i < n; i++) x[i] = static_cast<T>(1 / (1 + std::exp(-double(x[i]))));
+    }
+};
+
+//---------------------------------------------------------------------------
+
+#if LUAINTF_SIMD
+
+/**
+ * Vector kernels for BYTES wide registers, T is float or double.
+ *
+ * All functions are forced inline, so they take the instruction set of the caller,
+ * see TensorKernelTarget. Loads and stores go through memcpy, data does not need to be aligned.
+ */
+template <typename T, int BYTES>
+struct TensorSimdKernel
+{
+    using I = typename std::conditional<sizeof(T) == 4, int32_t, int64_t>::type;
+    typedef T V __attribute__((vector_size(BYTES)));
+    typedef I VI __attribute__((vector_size(BYTES)));
+
+    static constexpr size_t N = BYTES / sizeof(T);
+    static constexpr int BYTES_D = int(N * sizeof(double));
+
+    // double has to be spelled as dependent type, or GCC ignores dependent vector_size
+    using D = typename std::conditional<sizeof(T) != 0, double, T>::type;
+    typedef D VD __attribute__((vector_size(BYTES_D)));
+
+    // reductions accumulate short blocks in T, then add block results in double lanes
+    static constexpr size_t BLOCK = 256;
+
+    [[gnu::always_inline]] static inline void fill(T* x, size_t n, T v)
+    {
+        V vv = V{} + v;
+        size_t i = 0;
+        for (; i + N <= n; i += N) std::memcpy(x + i, &vv, sizeof(V));
+        for (; i < n; i++) x[i] = v;
+    }
+
+    [[gnu::always_inline]] static inline void scale(T* x, size_t n, T a)
+    {
+        size_t i = 0;
+        for (; i + N <= n; i += N) {
+            V v;
+            std::memcpy(&v, x + i, sizeof(V));
+            v *= a;
+            std::memcpy(x + i, &v, sizeof(V));
+        }
+        for (; i < n; i++) x[i] *= a;
+    }
+
+    [[gnu::always_inline]] static inline void addScalar(T* x, size_t n, T a)
+    {
+        size_t i = 0;
+        for (; i + N <= n; i += N) {
+            V v;
+            std::memcpy(&v, x + i, sizeof(V));
+            v += a;
+            std::memcpy(x + i, &v, sizeof(V));
+        }
+        for (; i < n; i++) x[i] += a;
+    }
+
+    [[gnu::always_inline]] static inline void axpy(T* y, const T* x, size_t n, T a)
+    {
+        size_t i = 0;
+        for (; i + N <= n; i += N) {
+            V vx, vy;
+            std::memcpy(&vx, x + i, sizeof(V));
+            std::memcpy(&vy, y + i, sizeof(V));
+            vy += vx * a;
+            std::memcpy(y + i, &vy, sizeof(V));
+        }
+        for (; i < n; i++) y[i] += a * x[i];
+    }
+
+    [[gnu::always_inline]] static inline void clamp(T* x, size_t n, T lo, T hi)
+    {
+        V vlo = V{} + lo;
+        V vhi = V{} + hi;
+        size_t i = 0;
+        for (; i + N <= n; i += N) {
+            V v;
+            std::memcpy(&v, x + i, sizeof(V));
+            v = v < vlo ? vlo : v;
+            v = v > vhi ? vhi : v;
+            std::memcpy(x + i, &v, sizeof(V));
+        }
+        for (; i < n; i++) x[i] = x[i] < lo ? lo : (x[i] > hi ? hi : x[i]);
+    }
+
+    [[gnu::always_inline]] static inline double sum(const T* x, size_t n)
+    {
+        VD acc = VD{};
+        double s = 0;
+        for (size_t base = 0; base < n; base += BLOCK) {
+            size_t end = std::min(n, base + BLOCK);
+            V a0 = V{}, a1 = V{};
+            size_t i = base;
+            for (; i + 2 * N <= end; i += 2 * N) {
+                V v0, v1;
+                std::memcpy(&v0, x + i, sizeof(V));
+                std::memcpy(&v1, x + i + N, sizeof(V));
+                a0 += v0;
+                a1 += v1;
+            }
+            acc += __builtin_convertvector(a0 + a1, VD);
+            for (; i < end; i++) s += x[i];
+        }
+        for (size_t k = 0; k < N; k++) s += acc[k];
+        return s;
+    }
+
+    [[gnu::always_inline]] static inline double dot(const T* x, const T* y, size_t n)
+    {
+        VD acc = VD{};
+        double s = 0;
+        for (size_t base = 0; base < n; base += BLOCK) {
+            size_t end = std::min(n, base + BLOCK);
+            V a0 = V{}, a1 = V{};
+            size_t i = base;
+            for (; i + 2 * N <= end; i += 2 * N) {
+                V x0, x1, y0, y1;
+                std::memcpy(&x0, x + i, sizeof(V));
+                std::memcpy(&x1, x + i + N, sizeof(V));
+                std::memcpy(&y0, y + i, sizeof(V));
+                std::memcpy(&y1, y + i + N, sizeof(V));
+                a0 += x0 * y0;
+                a1 += x1 * y1;
+            }
+            acc += __builtin_convertvector(a0 + a1, VD);
+            for (; i < end; i++) s += double(x[i]) * double(y[i]);
+        }
+        for (size_t k = 0; k < N; k++) s += acc[k];
+        return s;
+    }
+
+    [[gnu::always_inline]] static inline T min(const T* x, size_t n)
+    {
+        size_t i = 0;
+        T m = x[0];
+        if (n >= N) {
+            V vm;
+            std::memcpy(&vm, x, sizeof(V));
+            for (i = N; i + N <= n; i += N) {
+                V v;
+                std::memcpy(&v, x + i, sizeof(V));
+                vm = v < vm ? v : vm;
+            }
+            m = vm[0];
+            for (size_t k = 1; k < N; k++) m = vm[k] < m ? vm[k] : m;
+        }
+        for (; i < n; i++) m = x[i] < m ? x[i] : m;
+        return m;
+    }
+
+    [[gnu::always_inline]] static inline T max(const T* x, size_t n)
+    {
+        size_t i = 0;
+        T m = x[0];
+        if (n >= N) {
+            V vm;
+            std::memcpy(&vm, x, sizeof(V));
+            for (i = N; i + N <= n; i += N) {
+                V v;
+                std::memcpy(&v, x + i, sizeof(V));
+                vm = v > vm ? v : vm;
+            }
+            m = vm[0];
+            for (size_t k = 1; k < N; k++) m = vm[k] > m ? vm[k] : m;
+        }
+        for (; i < n; i++) m = x[i] > m ? x[i] : m;
+        return m;
+    }
+
+    /**
+     * One pass, each lane keeps its maximum and the index where it was first seen.
+     * Lane indices are I, so longer arrays go to the scalar kernel.
+     */
+    [[gnu::always_inline]] static inline size_t argmax(const T* x, size_t n)
+    {
+        if (n < 2 * N || n > size_t(std::numeric_limits<I>::max())) {
+            return TensorScalarKernel<T>::argmax(x, n);
+        }
+        V vm;
+        VI vi, vbest;
+        std::memcpy(&vm, x, sizeof(V));
+        for (size_t k = 0; k < N; k++) vi[k] = I(k);
+        vbest = vi;
+        size_t i = N;
+        for (; i + N <= n; i += N) {
+            V v;
+            std::memcpy(&v, x + i, sizeof(V));
+            vi += I(N);
+            VI gt = v > vm;
+            vm = gt ? v : vm;
+            vbest = gt ? vi : vbest;
+        }
+        // first index of the maximum: lowest lane index among the lanes holding it
+        T m = vm[0];
+        for (size_t k = 1; k < N; k++) m = vm[k] > m ? vm[k] : m;
+        vbest = vm == m ? vbest : VI{} + std::numeric_limits<I>::max();
+        I first = vbest[0];
+        for (size_t k = 1; k < N; k++) first = vbest[k] < first ? vbest[k] : first;
+        size_t best = first == std::numeric_limits<I>::max() ? 0 : size_t(first);     // m is nan
+        for (; i < n; i++) {
+            if (x[i] > m) {
+                m = x[i];
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * x = exp(x) with range reduction x = k * ln2 + r and Taylor polynomial on |r| <= ln2 / 2,
+     * accurate to about 1 ulp for float and 2 ulp for double. Input must be clamped to the
+     * finite range of T. (Vector is passed by reference, to keep the ABI independent of target)
+     */
+    [[gnu::always_inline]] static inline void exp(V& x)
+    {
+        constexpr bool F32 = sizeof(T) == 4;
+        constexpr T LOG2E = T(1.44269504088896340736);
+        constexpr T LN2_HI = F32 ? T(0.693359375) : T(0.693145751953125);
+        constexpr T LN2_LO = F32 ? T(-2.12194440e-4) : T(1.42860682030941723212e-6);
+        constexpr T ROUND = F32 ? T(12582912.0) : T(6755399441055744.0);
+        constexpr int MANT = F32 ? 23 : 52;
+        constexpr I BIAS = F32 ? 127 : 1023;
+        constexpr int DEGREE = F32 ? 7 : 12;
+
+        V k = (x * LOG2E + ROUND) - ROUND;
+        V r = x - k * LN2_HI;
+        r = r - k * LN2_LO;
+
+        V p = V{} + T(1);
+        for (int d = DEGREE; d >= 1; d--) {
+            p = p * r * (T(1) / T(d)) + T(1);
+        }
+
+        VI e = (__builtin_convertvector(k, VI) + BIAS) << MANT;
+        V pow2k;
+        std::memcpy(&pow2k, &e, sizeof(V));
+        x = p * pow2k;
+    }
+
+    [[gnu::always_inline]] static inline void sigmoid(T* x, size_t n)
+    {
+        constexpr T LIMIT = sizeof(T) == 4 ? T(87) : T(708);
+        V vlo = V{} - LIMIT;
+        V vhi = V{} + LIMIT;
+        size_t i = 0;
+        for (; i + N <= n; i += N) {
+            V v;
+            std::memcpy(&v, x + i, sizeof(V));
+            v = -v;
+            v = v < vlo ? vlo : v;
+            v = v > vhi ? vhi : v;
+            exp(v);
+            v = T(1) / (T(1) + v);
+            std::memcpy(x + i, &v, sizeof(V));
+        }
+        for (; i < n; i++) x[i] = T(1) / (T(1) + std::exp(-x[i]));
+    }
+};
+
+/**
+ * Kernel entry points compiled for one instruction set.
+ */
+#define LUAINTF_TENSOR_KERNEL_TARGET(NAME, TARGET, BYTES) \
+    template <typename T> \
+    struct NAME \
+    { \
+        using K = TensorSimdKernel<T, BYTES>; \
+        TARGET static void fill(T* x, size_t n, T v) { K::fill(x, n, v); } \
+        TARGET static void scale(T* x, size_t n, T a) { K::scale(x, n, a); } \
+        TARGET static void addScalar(T* x, size_t n, T a) { K::addScalar(x, n, a); } \
+        TARGET static void axpy(T* y, const T* x, size_t n, T a) { K::axpy(y, x, n, a); } \
+        TARGET static void clamp(T* x, size_t n, T lo, T hi) { K::clamp(x, n, lo, hi); } \
+        TARGET static double sum(const T* x, size_t n) { return K::sum(x, n); } \
+        TARGET static double dot(const T* x, const T* y, size_t n) { return K::dot(x, y, n); } \
+        TARGET static T min(const T* x, size_t n) { return K::min(x, n); } \
+        TARGET static T max(const T* x, size_t n) { return K::max(x, n); } \
+        TARGET static size_t argmax(const T* x, size_t n) { return K::argmax(x, n); } \
+        TARGET static void sigmoid(T* x, size_t n) { K::sigmoid(x, n); } \
+    };
+
+LUAINTF_TENSOR_KERNEL_TARGET(TensorKernelTarget128, , 16)
+#if LUAINTF_SIMD_X86
+LUAINTF_TENSOR_KERNEL_TARGET(TensorKernelTarget256, __attribute__((target("avx2,fma"))), 32)
+LUAINTF_TENSOR_KERNEL_TARGET(TensorKernelTarget512, __attribute__((target("avx512f"))), 64)
+#endif
+
+#undef LUAINTF_TENSOR_KERNEL_TARGET
+
+#endif // LUAINTF_SIMD
+
+//---------------------------------------------------------------------------
+
+/**
+ * Bulk operations over contiguous arrays, with runtime instruction set dispatch.
+ *
+ * float and double use vector kernels, other types use the scalar reference.
+ * sum and dot accumulate in double. min, max and argmax require n > 0.
+ */
+template <typename T>
+class TensorKernels
+{
+public:
+    /**
+     * The instruction set level in use
+     */
+    static TensorKernelLevel level()
+    {
+        return table().level;
+    }
+
+    /**
+     * Limit the instruction set level, for testing and benchmarks.
+     * The level actually used is the lower of this and what the CPU supports.
+     *
+     * @return the level in use
+     */
+    static TensorKernelLevel setLevel(TensorKernelLevel max_level)
+    {
+        table() = select(max_level);
+        return table().level;
+    }
+
+    static void fill(T* x, size_t n, T v) { table().fill(x, n, v); }
+    static void scale(T* x, size_t n, T a) { table().scale(x, n, a); }
+    static void addScalar(T* x, size_t n, T a) { table().addScalar(x, n, a); }
+    static void axpy(T* y, const T* x, size_t n, T a) { table().axpy(y, x, n, a); }
+    static void clamp(T* x, size_t n, T lo, T hi) { table().clamp(x, n, lo, hi); }
+    static double sum(const T* x, size_t n) { return table().sum(x, n); }
+    static double dot(const T* x, const T* y, size_t n) { return table().dot(x, y, n); }
+    static T min(const T* x, size_t n) { return table().min(x, n); }
+    static T max(const T* x, size_t n) { return table().max(x, n); }
+    static void sigmoid(T* x, size_t n) { table().sigmoid(x, n); }
+
+    /**
+     * Index (0-based) of the first maximum element
+     */
+    static size_t argmax(const T* x, size_t n) { return table().argmax(x, n); }
+
+private:
+    struct Table
+    {
+        TensorKernelLevel level;
+        void (*fill)(T*, size_t, T);
+        void (*scale)(T*, size_t, T);
+        void (*addScalar)(T*, size_t, T);
+        void (*axpy)(T*, const T*, size_t, T);
+        void (*clamp)(T*, size_t, T, T);
+        double (*sum)(const T*, size_t);
+        double (*dot)(const T*, const T*, size_t);
+        T (*min)(const T*, size_t);
+        T (*max)(const T*, size_t);
+        size_t (*argmax)(const T*, size_t);
+        void (*sigmoid)(T*, size_t);
+    };
+
+    template <typename K>
+    static Table make(TensorKernelLevel level)
+    {
+        return Table { level, &K::fill, &K::scale, &K::addScalar, &K::axpy, &K::clamp,
+            &K::sum, &K::dot, &K::min, &K::max, &K::argmax, &K::sigmoid };
+    }
+
+    static Table select(TensorKernelLevel max_level)
+    {
+#if LUAINTF_SIMD
+        if constexpr (std::is_same<T, float>::value || std::is_same<T, double>::value) {
+#if LUAINTF_SIMD_X86
+            __builtin_cpu_init();
+            if (max_level >= TensorKernelLevel::AVX512 && __builtin_cpu_supports("avx512f")) {
+                return make<TensorKernelTarget512<T>>(TensorKernelLevel::AVX512);
+            }
+            if (max_level >= TensorKernelLevel::AVX2 && __builtin_cpu_supports("avx2")
+                && __builtin_cpu_supports("fma"))
+            {
+                return make<TensorKernelTarget256<T>>(TensorKernelLevel::AVX2);
+            }
+#endif
+            if (max_level >= TensorKernelLevel::SSE2) {
+                return make<TensorKernelTarget128<T>>(TensorKernelLevel::SSE2);
+            }
+        }
+#endif
+        (void)max_level;
+        return make<TensorScalarKernel<T>>(TensorKernelLevel::SCALAR);
+    }
+
+    static Table& table()
+    {
+        static Table t = select(TensorKernelLevel::AVX512);
+        return t;
+    }
+};
+
+//---------------------------------------------------------------------------
+
+/**
+ * Element type of a type-erased tensor, see AnyTensorView
+ */
+enum class TensorDType
+{
+    U8,
+    I8,
+    I32,
+    F16,
+    F32,
+    F64
+};
+
+/**
+ * IEEE 754 half precision storage type, converted in software.
+ */
+struct TensorHalf
+{
+    uint16_t bits;
+
+    static float toFloat(uint16_t h)
+    {
+        uint32_t sign = uint32_t(h & 0x8000) << 16;
+        uint32_t exp = (h >> 10) & 0x1f;
+        uint32_t mant = h & 0x3ff;
+        uint32_t bits;
+        if (exp == 0x1f) {
+            bits = sign | 0x7f800000 | (mant << 13);                // inf or nan
+        } else if (exp != 0) {
+            bits = sign | ((exp + 112) << 23) | (mant << 13);
+        } else if (mant != 0) {
+            float f = float(mant) * (1.0f / 16777216.0f);         // subnormal, mant * 2^-24
+            return sign ? -f : f;
+        } else {
+            bits = sign;
+        }
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    /**
+     * Round to nearest even, overflow goes to infinity
+     */
+    static uint16_t fromFloat(float f)
+    {
+        uint32_t x;
+        std::memcpy(&x, &f, sizeof(x));
+        uint16_t sign = uint16_t((x >> 16) & 0x8000);
+        uint32_t abs_x = x & 0x7fffffff;
+        if (abs_x >= 0x7f800000) {
+            return sign | 0x7c00 | (abs_x > 0x7f800000 ? 0x200 : 0);    // inf or nan
+        }
+        if (abs_x >= 0x477ff000) {
+            return sign | 0x7c00;                                       // >= 65520
+        }
+        if (abs_x < 0x38800000) {
+            float a;
+            std::memcpy(&a, &abs_x, sizeof(a));
+            return sign | uint16_t(std::nearbyint(a * 16777216.0f));   // subnormal
+        }
+        uint32_t h = (((abs_x >> 23) - 112) << 10) | ((abs_x >> 13) & 0x3ff);
+        uint32_t rest = abs_x & 0x1fff;
+        if (rest > 0x1000 || (rest == 0x1000 && (h & 1))) h++;
+        return sign | uint16_t(h);
+    }
+};
+
+/**
+ * Element types in TensorDType order
+ */
+using TensorDTypeList = std::tuple<uint8_t, int8_t, int32_t, TensorHalf, float, double>;
+
+static constexpr size_t TENSOR_DTYPE_COUNT = std::tuple_size<TensorDTypeList>::value;
+
+template <size_t I>
+using TensorDTypeAt = typename std::tuple_element<I, TensorDTypeList>::type;
+
+/**
+ * Load and store of element type T through work type W (float or double).
+ *
+ * Stores to integer types round half away from zero and saturate, nan is stored as 0.
+ */
+template <typename T>
+struct TensorDTypeTraits
+{
+    template <typename W>
+    static W load(T v)
+    {
+        return W(v);
+    }
+
+    template <typename W>
+    static T store(W v)
+    {
+        if constexpr (std::is_integral<T>::value) {
+            constexpr W LO = W(std::numeric_limits<T>::lowest());
+            constexpr W HI = W(std::numeric_limits<T>::max());
+            v = v == v ? v : W(0);
+            v = v < LO ? LO : (v > HI ? HI : v);
+            return T(v < W(0) ? v - W(0.5) : v + W(0.5));
+        } else {
+            return T(v);
+        }
+    }
+};
+
+template <>
+struct TensorDTypeTraits <TensorHalf>
+{
+    template <typename W>
+    static W load(TensorHalf v)
+    {
+        return W(TensorHalf::toFloat(v.bits));
+    }
+
+    template <typename W>
+    static TensorHalf store(W v)
+    {
+        return TensorHalf { TensorHalf::fromFloat(float(v)) };
+    }
+};
+
+/**
+ * Work type for conversion from S to D, double if either side does not fit in float
+ */
+template <typename S, typename D>
+using TensorConvertWork = typename std::conditional<
+    std::is_same<S, double>::value || std::is_same<D, double>::value
+        || std::is_same<S, int32_t>::value || std::is_same<D, int32_t>::value,
+    double, float>::type;
+
+/**
+ * Conversion kernels round after the multiply and again after the add. FMA targets would
+ * fuse src * scale + bias into one rounding, and results on a rounding tie of an integer
+ * type would then depend on the instruction set, so contraction is off for all of them.
+ */
+#if defined(__clang__)
+    #define LUAINTF_NO_FP_CONTRACT _Pragma("clang fp contract(off)")
+#else
+    #define LUAINTF_NO_FP_CONTRACT
+    #pragma GCC push_options
+    #pragma GCC optimize("fp-contract=off")
+#endif
+
+/**
+ * Scalar reference conversion: dst[i] = D(src[i] * scale + bias)
+ */
+template <typename S, typename D>
+struct TensorConvertScalar
+{
+    using W = TensorConvertWork<S, D>;
+
+    static void convert(const void* src, void* dst, size_t n, double scale, double bias)
+    {
+        LUAINTF_NO_FP_CONTRACT
+        const S* s = static_cast<const S*>(src);
+        D* d = static_cast<D*>(dst);
+        W a = W(scale), b = W(bias);
+        for (size_t i = 0; i < n; i++) {
+            d[i] = TensorDTypeTraits<D>::template store<W>(TensorDTypeTraits<S>::template load<W>(s[i]) * a + b);
+        }
+    }
+};
+
+#if LUAINTF_SIMD
+
+/**
+ * Vector conversion for BYTES wide work registers, S and D are not TensorHalf.
+ * Same rounding and saturation as TensorConvertScalar, contraction is off as for it.
+ */
+template <typename S, typename D, int BYTES>
+struct TensorConvertSimd
+{
+    using W = TensorConvertWork<S, D>;
+    using I = typename std::conditional<sizeof(W) == 4, int32_t, int64_t>::type;
+
+    static constexpr size_t N = BYTES / sizeof(W);
+    static constexpr int BYTES_S = int(N * sizeof(S));
+    static constexpr int BYTES_D = int(N * sizeof(D));
+
+    typedef W VW __attribute__((vector_size(BYTES)));
+    typedef S VS __attribute__((vector_size(BYTES_S)));
+    typedef D VD __attribute__((vector_size(BYTES_D)));
+
+    [[gnu::always_inline]] static inline void convert(const void* src, void* dst, size_t n, double scale, double bias)
+    {
+        LUAINTF_NO_FP_CONTRACT
+        const S* s = static_cast<const S*>(src);
+        D* d = static_cast<D*>(dst);
+        W a = W(scale), b = W(bias);
+        size_t i = 0;
+        for (; i + N <= n; i += N) {
+            VS vs;
+            std::memcpy(&vs, s + i, sizeof(VS));
+            VW v = __builtin_convertvector(vs, VW) * a + b;
+            if constexpr (std::is_integral<D>::value) {
+                constexpr W LO = W(std::numeric_limits<D>::lowest());
+                constexpr W HI = W(std::numeric_limits<D>::max());
+                VW zero = VW{};
+                v = v == v ? v : zero;
+                v = v < LO ? zero + LO : v;
+                v = v > HI ? zero + HI : v;
+                v += v < W(0) ? zero - W(0.5) : zero + W(0.5);
+            }
+            VD vd = __builtin_convertvector(v, VD);
+            std::memcpy(d + i, &vd, sizeof(VD));
+        }
+        TensorConvertScalar<S, D>::convert(s + i, d + i, n - i, scale, bias);
+    }
+};
+
+/**
+ * Conversion entry point compiled for one instruction set, TensorHalf goes to the scalar kernel.
+ */
+#define LUAINTF_TENSOR_CONVERT_TARGET(NAME, TARGET, BYTES) \
+    template <typename S, typename D> \
+    struct NAME \
+    { \
+        TARGET static void convert(const void* src, void* dst, size_t n, double scale, double bias) \
+        { \
+            if constexpr (std::is_same<S, TensorHalf>::value || std::is_same<D, TensorHalf>::value) { \
+                TensorConvertScalar<S, D>::convert(src, dst, n, scale, bias); \
+            } else { \
+                TensorConvertSimd<S, D, BYTES>::convert(src, dst, n, scale, bias); \
+            } \
+        } \
+    };
+
+LUAINTF_TENSOR_CONVERT_TARGET(TensorConvertTarget128, , 16)
+#if LUAINTF_SIMD_X86
+LUAINTF_TENSOR_CONVERT_TARGET(TensorConvertTarget256, __attribute__((target("avx2,fma"))), 32)
+LUAINTF_TENSOR_CONVERT_TARGET(TensorConvertTarget512, __attribute__((target("avx512f"))), 64)
+#endif
+
+#undef LUAINTF_TENSOR_CONVERT_TARGET
+
+#endif // LUAINTF_SIMD
+
+#if !defined(__clang__)
+    #pragma GCC pop_options
+#endif
+#undef LUAINTF_NO_FP_CONTRACT
+
+/**
+ * Bulk conversion between element types: dst[i] = dst_type(src[i] * scale + bias),
+ * with runtime instruction set dispatch like TensorKernels.
+ *
+ * Conversion is done in float, or in double if either side is int32 or double.
+ * Conversion from or to f16 is always scalar.
+ */
+class TensorConvert
+{
+public:
+    using Function = void (*)(const void*, void*, size_t, double, double);
+
+    /**
+     * The instruction set level in use
+     */
+    static TensorKernelLevel level()
+    {
+        return table().level;
+    }
+
+    /**
+     * Limit the instruction set level, for testing and benchmarks.
+     *
+     * @return the level in use
+     */
+    static TensorKernelLevel setLevel(TensorKernelLevel max_level)
+    {
+        table() = select(max_level);
+        return table().level;
+    }
+
+    /**
+     * Convert n elements, src and dst must not overlap unless they are the same type.
+     */
+    static void convert(TensorDType src_type, const void* src, TensorDType dst_type, void* dst, size_t n,
+        double scale = 1, double bias = 0)
+    {
+        if (n == 0) return;
+        if (src_type == dst_type && scale == 1 && bias == 0) {
+            std::memmove(dst, src, n * itemSize(src_type));
+        } else {
+            table().fn[size_t(src_type)][size_t(dst_type)](src, dst, n, scale, bias);
+        }
+    }
+
+    /**
+     * Size in bytes of one element
+     */
+    static size_t itemSize(TensorDType dtype)
+    {
+        static constexpr size_t SIZES[] = { 1, 1, 4, 2, 4, 8 };
+        return SIZES[size_t(dtype)];
+    }
+
+private:
+    struct Table
+    {
+        TensorKernelLevel level;
+        Function fn[TENSOR_DTYPE_COUNT][TENSOR_DTYPE_COUNT];
+    };
+
+    template <template <typename, typename> class K, size_t... I>
+    static Table make(TensorKernelLevel level, std::index_sequence<I...>)
+    {
+        constexpr size_t C = TENSOR_DTYPE_COUNT;
+        Table t { level, {} };
+        ((t.fn[I / C][I % C] = &K<TensorDTypeAt<I / C>, TensorDTypeAt<I % C>>::convert), ...);
+        return t;
+    }
+
+    template <template <typename, typename> class K>
+    static Table make(TensorKernelLevel level)
+    {
+        return make<K>(level, std::make_index_sequence<TENSOR_DTYPE_COUNT * TENSOR_DTYPE_COUNT>());
+    }
+
+    static Table select(TensorKernelLevel max_level)
+    {
+#if LUAINTF_SIMD
+#if LUAINTF_SIMD_X86
+        __builtin_cpu_init();
+        if (max_level >= TensorKernelLevel::AVX512 && __builtin_cpu_supports("avx512f")) {
+            return make<TensorConvertTarget512>(TensorKernelLevel::AVX512);
+        }
+        if (max_level >= TensorKernelLevel::AVX2 && __builtin_cpu_supports("avx2")
+            && __builtin_cpu_supports("fma"))
+        {
+            return make<TensorConvertTarget256>(TensorKernelLevel::AVX2);
+        }
+#endif
+        if (max_level >= TensorKernelLevel::SSE2) {
+            return make<TensorConvertTarget128>(TensorKernelLevel::SSE2);
+        }
+#endif
+        (void)max_level;
+        return make<TensorConvertScalar>(TensorKernelLevel::SCALAR);
+    }
+
+    static Table& table()
+    {
+        static Table t = select(TensorKernelLevel::AVX512);
+        return t;
+    }
+};
+
+#endif  // TENSORKERNELS_H
@@ -0,0 +1,368 @@
+//
+// https://github.com/SteveKChiu/lua-intf
+//
+// TensorMapping: Memory-mapped file as TensorView
+//
+// Copyright 2026, model_infer contributors
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+
+#ifndef TENSORMAPPING_H
+#define TENSORMAPPING_H
+
+/**
+ * TensorMapping maps a file into memory, so anchor tables, LUTs and cached feature maps are
+ * paged in on demand and shared between processes through the page cache, instead of being
+ * read into a private std::vector by every worker.
+ *
+ * Views created from the mapping hold it in their owner, the file stays mapped until the
+ * last view is gone. The file may start with a TensorFileHeader describing dtype and shape,
+ * otherwise the whole file is the payload.
+ *
+ * On platforms without mmap (LUAINTF_HAS_MMAP not set in LuaIntf.h) the file is read into
+ * memory instead, with the same interface.
+ *
+ * Usage:
+ * @code
+ *   // read-only, shared with other processes
+ *   TensorView<const float> anchors = TensorMapping::mapFile<const float>("anchors.bin");
+ *
+ *   // copy-on-write, writes stay private to this process
+ *   auto lut = TensorMapping::open("lut.tensor", TensorMapMode::COPY_ON_WRITE,
+ *       TensorMapAdvice::WILLNEED);
+ *   TensorView<float> table = lut->view<float>();
+ *   StridedTensorView<float> grid = lut->stridedView<float>();   // shape from header
+ *
+ *   // write a file with header
+ *   TensorMapping::write("lut.tensor", TensorDType::F32, {256, 3}, data);
+ * @endcode
+ */
+
+/**
+ * Access mode of the mapping
+ */
+enum class TensorMapMode
+{
+    READ_ONLY,          // pages shared with other processes, views must be const
+    COPY_ON_WRITE       // pages shared until written, writes are private and not saved
+};
+
+/**
+ * Paging hints for the mapping, may be combined with |
+ */
+namespace TensorMapAdvice
+{
+    enum : unsigned
+    {
+        NORMAL = 0,
+        SEQUENTIAL = 1,     // read ahead aggressively, drop pages behind
+        WILLNEED = 2,       // start reading the whole file in background
+        HUGEPAGE = 4        // back with huge pages if the kernel supports it for files
+    };
+}
+
+/**
+ * Optional file header, all fields in host byte order.
+ * The payload starts at dataOffset, which is a multiple of 64.
+ */
+struct TensorFileHeader
+{
+    static constexpr uint32_t MAGIC = 0x534e544c;     // "LTNS"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int MAX_DIMS = 8;
+    static constexpr uint64_t DATA_OFFSET = 128;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t dtype;
+    uint32_t ndim;
+    uint64_t shape[MAX_DIMS];
+    uint64_t dataOffset;
+};
+
+class TensorMapping : public std::enable_shared_from_this<TensorMapping>
+{
+public:
+    /**
+     * Map file into memory.
+     *
+     * @param path File path
+     * @param mode READ_ONLY or COPY_ON_WRITE
+     * @param advice TensorMapAdvice flags
+     * @throws std::runtime_error if the file can not be mapped or the header is invalid
+     */
+    static std::shared_ptr<TensorMapping> open(const std::string& path,
+        TensorMapMode mode = TensorMapMode::READ_ONLY, unsigned advice = TensorMapAdvice::NORMAL)
+    {
+        std::shared_ptr<TensorMapping> mapping(new TensorMapping(path, mode));
+        mapping->readHeader();
+        mapping->advise(advice);
+        return mapping;
+    }
+
+    /**
+     * Map file and return the payload as TensorView<T>, use const T for READ_ONLY.
+     * The view keeps the mapping alive.
+     */
+    template <typename T>
+    static TensorView<T> mapFile(const std::string& path,
+        TensorMapMode mode = TensorMapMode::READ_ONLY, unsigned advice = TensorMapAdvice::NORMAL)
+    {
+        return open(path, mode, advice)->template view<T>();
+    }
+
+    /**
+     * Write file with header, which can be mapped later with shape and dtype.
+     *
+     * @throws std::runtime_error if the file can not be written
+     */
+    static void write(const std::string& path, TensorDType dtype, const std::vector<size_t>& shape, const void* data)
+    {
+        if (shape.size() > size_t(TensorFileHeader::MAX_DIMS)) {
+            throw std::invalid_argument("TensorMapping: too many dimensions");
+        }
+        TensorFileHeader header {};
+        header.magic = TensorFileHeader::MAGIC;
+        header.version = TensorFileHeader::VERSION;
+        header.dtype = uint32_t(dtype);
+        header.ndim = uint32_t(shape.size());
+        header.dataOffset = TensorFileHeader::DATA_OFFSET;
+        size_t bytes = TensorConvert::itemSize(dtype);
+        for (size_t i = 0; i < shape.size(); i++) {
+            header.shape[i] = shape[i];
+            if (__builtin_mul_overflow(bytes, shape[i], &bytes)) {
+                throw std::invalid_argument("TensorMapping: shape too large");
+            }
+        }
+
+        std::unique_ptr<FILE, int(*)(FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+        char padding[TensorFileHeader::DATA_OFFSET - sizeof(TensorFileHeader)] = {};
+        if (!file
+            || std::fwrite(&header, sizeof(header), 1, file.get()) != 1
+            || std::fwrite(padding, sizeof(padding), 1, file.get()) != 1
+            || (bytes > 0 && std::fwrite(data, bytes, 1, file.get()) != 1)
+            || std::fclose(file.release()) != 0)
+        {
+            throw std::runtime_error("TensorMapping: can not write '" + path + "'");
+        }
+    }
+
+    ~TensorMapping()
+    {
+#if LUAINTF_HAS_MMAP
+        if (m_base) ::munmap(m_base, m_file_size);
+#else
+        ::operator delete(m_base, std::align_val_t(64));
+#endif
+    }
+
+    TensorMapping(const TensorMapping&) = delete;
+    TensorMapping& operator = (const TensorMapping&) = delete;
+
+    /**
+     * Apply TensorMapAdvice hints, unsupported hints are ignored
+     */
+    void advise(unsigned advice)
+    {
+#if LUAINTF_HAS_MMAP
+        if (!m_base) return;
+        if (advice & TensorMapAdvice::SEQUENTIAL) ::madvise(m_base, m_file_size, MADV_SEQUENTIAL);
+        if (advice & TensorMapAdvice::WILLNEED) ::madvise(m_base, m_file_size, MADV_WILLNEED);
+#if defined(MADV_HUGEPAGE)
+        if (advice & TensorMapAdvice::HUGEPAGE) ::madvise(m_base, m_file_size, MADV_HUGEPAGE);
+#endif
+#else
+        (void)advice;
+#endif
+    }
+
+    /**
+     * Apply TensorMapAdvice hints to payload bytes [offset, offset + length), for example to
+     * read ahead a window while streaming. The range is clipped to the payload.
+     */
+    void advise(unsigned advice, size_t offset, size_t length)
+    {
+#if LUAINTF_HAS_MMAP
+        if (!m_base || offset >= m_nbytes) return;
+        length = std::min(length, m_nbytes - offset);
+        // madvise needs a page aligned start
+        uintptr_t page = uintptr_t(::sysconf(_SC_PAGESIZE));
+        uintptr_t begin = reinterpret_cast<uintptr_t>(m_data) + offset;
+        uintptr_t aligned = begin & ~(page - 1);
+        void* addr = reinterpret_cast<void*>(aligned);
+        size_t len = length + (begin - aligned);
+        if (advice & TensorMapAdvice::SEQUENTIAL) ::madvise(addr, len, MADV_SEQUENTIAL);
+        if (advice & TensorMapAdvice::WILLNEED) ::madvise(addr, len, MADV_WILLNEED);
+#if defined(MADV_HUGEPAGE)
+        if (advice & TensorMapAdvice::HUGEPAGE) ::madvise(addr, len, MADV_HUGEPAGE);
+#endif
+#else
+        (void)advice;
+        (void)offset;
+        (void)length;
+#endif
+    }
+
+    const std::string& path() const { return m_path; }
+    TensorMapMode mode() const { return m_mode; }
+    bool isReadOnly() const { return m_mode == TensorMapMode::READ_ONLY; }
+
+    /**
+     * Whether the file starts with TensorFileHeader, dtype and shape are only known if so
+     */
+    bool hasHeader() const { return m_has_header; }
+    TensorDType dtype() const { return m_dtype; }
+    const std::vector<size_t>& shape() const { return m_shape; }
+
+    /**
+     * Payload pointer and size in bytes
+     */
+    void* data() const { return m_data; }
+    size_t nbytes() const { return m_nbytes; }
+
+    /**
+     * Payload as 1-d view, T must be const for READ_ONLY mapping.
+     * T (const ignored) must be one of TensorDTypeList, see AnyTensorView::dtypeOf.
+     *
+     * @throws std::invalid_argument if header dtype does not match T
+     * @throws std::logic_error if mapping is read-only and T is not const
+     */
+    template <typename T>
+    TensorView<T> view()
+    {
+        checkType<T>();
+        return TensorView<T>(static_cast<T*>(m_data), m_nbytes / sizeof(T), shared_from_this());
+    }
+
+    /**
+     * Payload as N-d view with shape from header (1-d if no header), T must be const for READ_ONLY mapping.
+     */
+    template <typename T>
+    StridedTensorView<T> stridedView()
+    {
+        checkType<T>();
+        std::vector<size_t> shape = m_has_header ? m_shape : std::vector<size_t> { m_nbytes / sizeof(T) };
+        return StridedTensorView<T>(static_cast<T*>(m_data), shape, shared_from_this());
+    }
+
+    /**
+     * Payload as dtype-erased view, read-only for READ_ONLY mapping.
+     *
+     * @throws std::logic_error if file has no header
+     */
+    AnyTensorView anyView()
+    {
+        if (!m_has_header) {
+            throw std::logic_error("TensorMapping: dtype unknown, file has no header");
+        }
+        AnyTensorView view(m_data, m_dtype, m_nbytes / TensorConvert::itemSize(m_dtype), shared_from_this());
+        view.setReadOnly(isReadOnly());
+        return view;
+    }
+
+private:
+    TensorMapping(const std::string& path, TensorMapMode mode)
+        : m_path(path), m_mode(mode)
+    {
+#if LUAINTF_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("TensorMapping: can not open '" + path + "': " + std::strerror(errno));
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error("TensorMapping: can not stat '" + path + "': " + std::strerror(err));
+        }
+        m_file_size = size_t(st.st_size);
+        if (m_file_size > 0) {
+            int prot = mode == TensorMapMode::READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+            int flags = mode == TensorMapMode::READ_ONLY ? MAP_SHARED : MAP_PRIVATE;
+            void* base = ::mmap(nullptr, m_file_size, prot, flags, fd, 0);
+            if (base == MAP_FAILED) {
+                int err = errno;
+                ::close(fd);
+                throw std::runtime_error("TensorMapping: can not map '" + path + "': " + std::strerror(err));
+            }
+            m_base = base;
+        }
+        // the mapping stays valid after close
+        ::close(fd);
+#else
+        std::unique_ptr<FILE, int(*)(FILE*)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+        if (!file || std::fseek(file.get(), 0, SEEK_END) != 0) {
+            throw std::runtime_error("TensorMapping: can not open '" + path + "'");
+        }
+        m_file_size = size_t(std::ftell(file.get()));
+        std::rewind(file.get());
+        m_base = ::operator new(m_file_size, std::align_val_t(64));
+        if (m_file_size > 0 && std::fread(m_base, m_file_size, 1, file.get()) != 1) {
+            ::operator delete(m_base, std::align_val_t(64));
+            throw std::runtime_error("TensorMapping: can not read '" + path + "'");
+        }
+#endif
+    }
+
+    void readHeader()
+    {
+        m_data = m_base;
+        m_nbytes = m_file_size;
+
+        TensorFileHeader header;
+        if (m_file_size < sizeof(header)) return;
+        std::memcpy(&header, m_base, sizeof(header));
+        if (header.magic != TensorFileHeader::MAGIC) return;
+
+        if (header.version != TensorFileHeader::VERSION
+            || header.dtype >= TENSOR_DTYPE_COUNT
+            || header.ndim > uint32_t(TensorFileHeader::MAX_DIMS)
+            || header.dataOffset % 64 != 0
+            || header.dataOffset > m_file_size)
+        {
+            throw std::runtime_error("TensorMapping: invalid header in '" + m_path + "'");
+        }
+
+        m_dtype = TensorDType(header.dtype);
+        // bytes = item size * product of shape, a wrapped product would pass the size check
+        size_t bytes = TensorConvert::itemSize(m_dtype);
+        for (uint32_t i = 0; i < header.ndim; i++) {
+            if (__builtin_mul_overflow(bytes, header.shape[i], &bytes)) {
+                throw std::runtime_error("TensorMapping: invalid header in '" + m_path + "'");
+            }
+            m_shape.push_back(size_t(header.shape[i]));
+        }
+        if (bytes > m_file_size - header.dataOffset) {
+            throw std::runtime_error("TensorMapping: file '" + m_path + "' is shorter than header shape");
+        }
+        m_has_header = true;
+        m_data = static_cast<char*>(m_base) + header.dataOffset;
+        m_nbytes = bytes;
+    }
+
+    template <typename T>
+    void checkType() const
+    {
+        if (m_has_header && AnyTensorView::dtypeOf<T>() != m_dtype) {
+            throw std::invalid_argument(std::string("TensorMapping: dtype is ")
+                + AnyTensorView::nameOf(m_dtype) + ", not " + AnyTensorView::nameOf(AnyTensorView::dtypeOf<T>()));
+        }
+        if (!std::is_const<T>::value && isReadOnly()) {
+            throw std::logic_error("TensorMapping: read-only mapping needs const element type");
+        }
+    }
+
+private:
+    std::string m_path;
+    TensorMapMode m_mode;
+    void* m_base = nullptr;
+    size_t m_file_size = 0;
+    void* m_data = nullptr;
+    size_t m_nbytes = 0;
+    bool m_has_header = false;
+    TensorDType m_dtype = TensorDType::U8;
+    std::vector<size_t> m_shape;
+};
+
+#endif  // TENSORMAPPING_H
@@ -11,10 +11,6 @@
 #ifndef TENSORVIEW_H
 #define TENSORVIEW_H
 
-#include <memory>
-#include <stdexcept>
-#include <cstddef>
-
 /**
  * TensorView provides zero-copy access to C++ array data from Lua.
  * 
@@ -48,6 +44,8 @@
  *   print(view:get(1))     -- access element
  *   view:set(1, 3.14)      -- modify element
  * @endcode
+ *
+ * For element access with view[i], see TensorViewMetaMethod.
  */
 template<typename T>
 class TensorView {
@@ -124,6 +122,11 @@ public:
      */
     T* data() const { return data_; }
     
+    /**
+     * Get the owner that keeps data alive (may be null).
+     */
+    const std::shared_ptr<void>& owner() const { return owner_; }
+    
     /**
      * Check if view is empty.
      * 
@@ -137,6 +140,219 @@ public:
      * @return true if view points to valid data
      */
     bool isValid() const { return data_ != nullptr; }
+    
+    //-----------------------------------------------------------------------
+    // Bulk operations, vectorized for float and double (see TensorKernels)
+    //-----------------------------------------------------------------------
+    
+    /**
+     * Set all elements to value.
+     */
+    void fill(T val) { TensorKernels<T>::fill(data_, length_, val); }
+    
+    /**
+     * Copy all elements from another view of the same length (may overlap).
+     * 
+     * @throws std::invalid_argument if length does not match
+     */
+    void copyFrom(const TensorView<T>& src) {
+        checkSameLength(src);
+        if (length_ > 0) std::memmove(data_, src.data_, length_ * sizeof(T));
+    }
+    
+    /**
+     * Multiply all elements by a: x = a * x
+     */
+    void scale(T a) { TensorKernels<T>::scale(data_, length_, a); }
+    
+    /**
+     * Add another view scaled by alpha (axpy): x = x + alpha * other
+     * 
+     * @throws std::invalid_argument if length does not match
+     */
+    void add(const TensorView<T>& other, T alpha = T(1)) {
+        checkSameLength(other);
+        TensorKernels<T>::axpy(data_, other.data_, length_, alpha);
+    }
+    
+    /**
+     * Add a to all elements: x = x + a
+     */
+    void addScalar(T a) { TensorKernels<T>::addScalar(data_, length_, a); }
+    
+    /**
+     * Limit all elements to [lo, hi].
+     */
+    void clamp(T lo, T hi) { TensorKernels<T>::clamp(data_, length_, lo, hi); }
+    
+    /**
+     * Apply logistic function to all elements: x = 1 / (1 + exp(-x))
+     */
+    void sigmoid() { TensorKernels<T>::sigmoid(data_, length_); }
+    
+    /**
+     * Sum of all elements (accumulated in double).
+     */
+    double sum() const { return TensorKernels<T>::sum(data_, length_); }
+    
+    /**
+     * Dot product with another view of the same length (accumulated in double).
+     * 
+     * @throws std::invalid_argument if length does not match
+     */
+    double dot(const TensorView<T>& other) const {
+        checkSameLength(other);
+        return TensorKernels<T>::dot(data_, other.data_, length_);
+    }
+    
+    /**
+     * Smallest element.
+     * 
+     * @throws std::out_of_range if view is empty
+     */
+    T min() const {
+        checkNotEmpty();
+        return TensorKernels<T>::min(data_, length_);
+    }
+    
+    /**
+     * Largest element.
+     * 
+     * @throws std::out_of_range if view is empty
+     */
+    T max() const {
+        checkNotEmpty();
+        return TensorKernels<T>::max(data_, length_);
+    }
+    
+    /**
+     * 1-based index (Lua convention) of the first largest element.
+     * 
+     * @throws std::out_of_range if view is empty
+     */
+    int argmax() const {
+        checkNotEmpty();
+        return static_cast<int>(TensorKernels<T>::argmax(data_, length_)) + 1;
+    }
+    
+private:
+    void checkSameLength(const TensorView<T>& other) const {
+        if (other.length_ != length_) {
+            throw std::invalid_argument("TensorView: length mismatch");
+        }
+    }
+    
+    void checkNotEmpty() const {
+        if (length_ == 0) {
+            throw std::out_of_range("TensorView: empty view");
+        }
+    }
+};
+
+//---------------------------------------------------------------------------
+
+/**
+ * Raw metamethods for TensorView<T>, so view[i] costs about as much as a table index.
+ *
+ * Integer keys are handled directly with bounds check (1-based), other keys fall back to
+ * the class method table, so view:get(i) and other bound methods still work.
+ *
+ * Usage:
+ * @code
+ *   using Meta = TensorViewMetaMethod<float>;
+ *   LuaBinding(L).beginClass<TensorView<float>>("FloatTensorView")
+ *       .addFunction("get", &TensorView<float>::get)
+ *       .addRawMetaFunction("__index", &Meta::index)
+ *       .addRawMetaFunction("__newindex", &Meta::newIndex, &Meta::newIndexConst)
+ *       .addRawMetaFunction("__len", &Meta::len)
+ *   .endClass();
+ *
+ *   -- Lua side
+ *   for i = 1, #view do view[i] = view[i] * 2 end
+ * @endcode
+ */
+template <typename T>
+struct TensorViewMetaMethod
+{
+    /**
+     * __index metamethod, view[i] or view.method
+     */
+    static int index(lua_State* L)
+    {
+        if (lua_type(L, 2) != LUA_TNUMBER) {
+            return CppBindClassMetaMethod::index(L);
+        }
+        TensorView<T>* view = checkView(L);
+        size_t i = checkIndex(L, view);
+        LuaType<T>::push(L, view->data()[i]);
+        return 1;
+    }
+
+    /**
+     * __newindex metamethod, view[i] = value
+     */
+    static int newIndex(lua_State* L)
+    {
+        if (lua_type(L, 2) != LUA_TNUMBER) {
+            return CppBindClassMetaMethod::newIndex(L);
+        }
+        TensorView<T>* view = checkView(L);
+        size_t i = checkIndex(L, view);
+        view->data()[i] = LuaType<T>::get(L, 3);
+        return 0;
+    }
+
+    /**
+     * __newindex metamethod for const view, element is read-only
+     */
+    static int newIndexConst(lua_State* L)
+    {
+        if (lua_type(L, 2) != LUA_TNUMBER) {
+            return CppBindClassMetaMethod::newIndex(L);
+        }
+        return luaL_error(L, "TensorView: can not modify element of const view");
+    }
+
+    /**
+     * __len metamethod, #view
+     */
+    static int len(lua_State* L)
+    {
+        lua_pushinteger(L, static_cast<lua_Integer>(checkView(L)->size()));
+        return 1;
+    }
+
+private:
+    static TensorView<T>* checkView(lua_State* L)
+    {
+        // compare the type id tagged in metatable, no need for the full class hierarchy lookup
+        void* type_id = nullptr;
+        if (lua_getmetatable(L, 1)) {
+            lua_rawgetp(L, -1, CppSignature<CppObject>::value());
+            type_id = lua_touserdata(L, -1);
+            lua_pop(L, 2);
+        }
+        if (type_id != CppClassSignature<TensorView<T>>::value()
+            && type_id != CppConstSignature<TensorView<T>>::value())
+        {
+            // not exact match, could be subclass or error
+            return CppObject::get<TensorView<T>>(L, 1, true);
+        }
+        return static_cast<TensorView<T>*>(static_cast<CppObject*>(lua_touserdata(L, 1))->objectPtr());
+    }
+
+    static size_t checkIndex(lua_State* L, TensorView<T>* view)
+    {
+        int is_int = 0;
+        lua_Integer idx = lua_tointegerx(L, 2, &is_int);
+        if (!is_int) {
+            luaL_error(L, "TensorView: index must be integer");
+        }
+        if (idx < 1 || static_cast<lua_Unsigned>(idx) > view->size()) {
+            luaL_error(L, "TensorView: index %d out of range [1, %d]", int(idx), int(view->size()));
+        }
+        return static_cast<size_t>(idx - 1);
+    }
 };
 
 #endif  // TENSORVIEW_H
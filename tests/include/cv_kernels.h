@@ -0,0 +1,403 @@
+#pragma once
+
+#include "LuaIntf.h"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace CVLib {
+
+using LuaIntf::TensorKernelLevel;
+
+/**
+ * Scalar reference pixel kernels, used without SIMD and as reference for testing.
+ *
+ * Kernels work on one contiguous run of pixels, callers loop over rows.
+ * Only swapRB may work in place, other kernels need separate src and dst.
+ */
+struct PixelScalarKernel {
+    /**
+     * Swap channels 0 and 2 of 3 or 4 channel pixels, channel 3 is copied.
+     */
+    static void swapRB(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) {
+        for (size_t i = 0; i < pixels; i++) {
+            const uint8_t* s = src + i * channels;
+            uint8_t* d = dst + i * channels;
+            uint8_t b = s[0], g = s[1], r = s[2];
+            d[0] = r;
+            d[1] = g;
+            d[2] = b;
+            if (channels == 4) d[3] = s[3];
+        }
+    }
+
+    /**
+     * Expand gray pixels to 3 equal channels.
+     */
+    static void grayToBGR(const uint8_t* src, uint8_t* dst, size_t pixels) {
+        for (size_t i = 0; i < pixels; i++) {
+            dst[i * 3 + 0] = src[i];
+            dst[i * 3 + 1] = src[i];
+            dst[i * 3 + 2] = src[i];
+        }
+    }
+
+    /**
+     * Write pixels in reverse order, channels of a pixel stay in order.
+     */
+    static void mirror(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) {
+        for (size_t i = 0; i < pixels; i++) {
+            std::memcpy(dst + (pixels - 1 - i) * channels, src + i * channels, channels);
+        }
+    }
+
+    /**
+     * Exchange n bytes of a and b, for in-place vertical flip.
+     */
+    static void swapBytes(uint8_t* a, uint8_t* b, size_t n) {
+        for (size_t i = 0; i < n; i++) std::swap(a[i], b[i]);
+    }
+
+    /**
+     * Interleaved 3-channel pixels to float, dst[i] = src[i] * scale[c] + bias[c].
+     */
+    static void normalize(const uint8_t* src, float* dst, size_t pixels, const float* scale, const float* bias) {
+        for (size_t i = 0; i < pixels * 3; i++) {
+            dst[i] = src[i] * scale[i % 3] + bias[i % 3];
+        }
+    }
+
+    /**
+     * Interleaved 3-channel pixels to 3 float planes, planes[c][i] = src[i * 3 + c] * scale[c] + bias[c].
+     */
+    static void normalizePlanar(const uint8_t* src, float* const* planes, size_t pixels,
+                                const float* scale, const float* bias) {
+        for (size_t i = 0; i < pixels; i++) {
+            for (int c = 0; c < 3; c++) {
+                planes[c][i] = src[i * 3 + c] * scale[c] + bias[c];
+            }
+        }
+    }
+};
+
+#if LUAINTF_SIMD
+
+/**
+ * Vector pixel kernels for BYTES wide registers, written with GCC/Clang vector extensions.
+ *
+ * 3-channel rows do not fill whole registers: a register holds BYTES / 3 pixels and the
+ * spare bytes belong to the next pixel, which the next step writes again. Every load and
+ * store stays inside the run, the scalar kernel finishes the tail.
+ * All functions are forced inline, so they take the instruction set of the caller.
+ */
+template <int BYTES>
+struct PixelSimdKernel {
+    // element types have to be dependent, or GCC ignores dependent vector_size
+    using B = typename std::conditional<BYTES != 0, uint8_t, void>::type;
+    using F = typename std::conditional<BYTES != 0, float, void>::type;
+    using H = typename std::conditional<BYTES != 0, uint16_t, void>::type;
+    using I = typename std::conditional<BYTES != 0, int32_t, void>::type;
+
+    static constexpr size_t NF = BYTES / sizeof(float);
+
+    typedef B VB __attribute__((vector_size(BYTES)));
+    typedef F VF __attribute__((vector_size(BYTES)));
+    typedef I VI __attribute__((vector_size(BYTES)));
+    typedef B VBF __attribute__((vector_size(NF)));     // bytes of one float vector
+    typedef H VHF __attribute__((vector_size(NF * 2)));
+
+    // byte masks for __builtin_shufflevector
+    template <int C>
+    static constexpr int swapIndex(int k) {
+        constexpr int USED = BYTES / C * C;
+        return k >= USED || k % C == 1 || k % C == 3 ? k : k - k % C + 2 - k % C;
+    }
+
+    template <int C>
+    static constexpr int mirrorIndex(int k) {
+        constexpr int PIXELS = BYTES / C;
+        constexpr int SPARE = BYTES - PIXELS * C;
+        return k >= PIXELS * C ? 0 : SPARE + (PIXELS - 1 - k / C) * C + k % C;
+    }
+
+    // vectors are passed by reference, to keep the ABI independent of target
+    template <int C, size_t... K>
+    [[gnu::always_inline]] static inline void swapPixels(VB& v, std::index_sequence<K...>) {
+        v = __builtin_shufflevector(v, v, swapIndex<C>(K)...);
+    }
+
+    template <int C, size_t... K>
+    [[gnu::always_inline]] static inline void mirrorPixels(VB& v, std::index_sequence<K...>) {
+        v = __builtin_shufflevector(v, v, mirrorIndex<C>(K)...);
+    }
+
+    template <int J, size_t... K>
+    [[gnu::always_inline]] static inline void expandGray(const VB& v, VB& out, std::index_sequence<K...>) {
+        out = __builtin_shufflevector(v, v, int((J * BYTES + K) / 3)...);
+    }
+
+    // widen one step at a time, GCC converts bytes to int32 or float one lane at a time
+    [[gnu::always_inline]] static inline void toFloat(const VBF& b, VF& out) {
+        VHF h = __builtin_convertvector(b, VHF);
+        out = __builtin_convertvector(__builtin_convertvector(h, VI), VF);
+    }
+
+    template <int C, size_t... K>
+    [[gnu::always_inline]] static inline void channel(const VB& v, VF& out, F scale, F bias, std::index_sequence<K...>) {
+        VBF b = __builtin_shufflevector(v, v, int(K * 3 + C)...);
+        toFloat(b, out);
+        out = out * scale + bias;
+    }
+
+    template <int C>
+    [[gnu::always_inline]] static inline void swapRBRun(const uint8_t* src, uint8_t* dst, size_t pixels) {
+        constexpr size_t STEP = BYTES / C;
+        size_t n = pixels * C;
+        size_t i = 0;
+        for (; i * C + BYTES <= n; i += STEP) {
+            VB v;
+            std::memcpy(&v, src + i * C, BYTES);
+            swapPixels<C>(v, std::make_index_sequence<BYTES>());
+            std::memcpy(dst + i * C, &v, BYTES);
+        }
+        PixelScalarKernel::swapRB(src + i * C, dst + i * C, pixels - i, C);
+    }
+
+    [[gnu::always_inline]] static inline void swapRB(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) {
+        if (channels == 3) {
+            swapRBRun<3>(src, dst, pixels);
+        } else {
+            swapRBRun<4>(src, dst, pixels);
+        }
+    }
+
+    [[gnu::always_inline]] static inline void grayToBGR(const uint8_t* src, uint8_t* dst, size_t pixels) {
+        size_t i = 0;
+        for (; i + BYTES <= pixels; i += BYTES) {
+            VB v, out[3];
+            std::memcpy(&v, src + i, BYTES);
+            expandGray<0>(v, out[0], std::make_index_sequence<BYTES>());
+            expandGray<1>(v, out[1], std::make_index_sequence<BYTES>());
+            expandGray<2>(v, out[2], std::make_index_sequence<BYTES>());
+            std::memcpy(dst + i * 3, out, sizeof(out));
+        }
+        PixelScalarKernel::grayToBGR(src + i, dst + i * 3, pixels - i);
+    }
+
+    /**
+     * Each step reverses the PIXELS pixels that end at src pixel (pixels - i). With spare
+     * bytes the load starts SPARE bytes early, so the first step needs one pixel before it.
+     */
+    template <int C>
+    [[gnu::always_inline]] static inline void mirrorRun(const uint8_t* src, uint8_t* dst, size_t pixels) {
+        constexpr size_t PIXELS = BYTES / C;
+        constexpr size_t SPARE = BYTES - PIXELS * C;
+        constexpr size_t AHEAD = SPARE ? 1 : 0;
+        size_t i = 0;
+        for (; i + PIXELS + AHEAD <= pixels; i += PIXELS) {
+            VB v;
+            std::memcpy(&v, src + (pixels - i - PIXELS) * C - SPARE, BYTES);
+            mirrorPixels<C>(v, std::make_index_sequence<BYTES>());
+            std::memcpy(dst + i * C, &v, BYTES);
+        }
+        PixelScalarKernel::mirror(src, dst + i * C, pixels - i, C);
+    }
+
+    [[gnu::always_inline]] static inline void mirror(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) {
+        switch (channels) {
+            case 1: mirrorRun<1>(src, dst, pixels); break;
+            case 3: mirrorRun<3>(src, dst, pixels); break;
+            case 4: mirrorRun<4>(src, dst, pixels); break;
+            default: PixelScalarKernel::mirror(src, dst, pixels, channels); break;
+        }
+    }
+
+    [[gnu::always_inline]] static inline void swapBytes(uint8_t* a, uint8_t* b, size_t n) {
+        size_t i = 0;
+        for (; i + BYTES <= n; i += BYTES) {
+            VB va, vb;
+            std::memcpy(&va, a + i, BYTES);
+            std::memcpy(&vb, b + i, BYTES);
+            std::memcpy(a + i, &vb, BYTES);
+            std::memcpy(b + i, &va, BYTES);
+        }
+        PixelScalarKernel::swapBytes(a + i, b + i, n - i);
+    }
+
+    /**
+     * The channel pattern repeats every 3 vectors.
+     */
+    [[gnu::always_inline]] static inline void normalize(const uint8_t* src, float* dst, size_t pixels,
+                                                        const float* scale, const float* bias) {
+        VF vscale[3], vbias[3];
+        for (size_t v = 0; v < 3; v++) {
+            for (size_t j = 0; j < NF; j++) {
+                vscale[v][j] = scale[(v * NF + j) % 3];
+                vbias[v][j] = bias[(v * NF + j) % 3];
+            }
+        }
+
+        size_t n = pixels * 3;
+        size_t i = 0;
+        for (; i + 3 * NF <= n; i += 3 * NF) {
+            for (size_t v = 0; v < 3; v++) {
+                VBF b;
+                std::memcpy(&b, src + i + v * NF, sizeof(b));
+                VF f;
+                toFloat(b, f);
+                f = f * vscale[v] + vbias[v];
+                std::memcpy(dst + i + v * NF, &f, sizeof(f));
+            }
+        }
+        PixelScalarKernel::normalize(src + i, dst + i, (n - i) / 3, scale, bias);
+    }
+
+    /**
+     * One step loads BYTES bytes and splits the first 3 * NF into channels.
+     */
+    [[gnu::always_inline]] static inline void normalizePlanar(const uint8_t* src, float* const* planes, size_t pixels,
+                                                              const float* scale, const float* bias) {
+        size_t i = 0;
+        for (; i * 3 + BYTES <= pixels * 3; i += NF) {
+            VB v;
+            std::memcpy(&v, src + i * 3, BYTES);
+            VF f0, f1, f2;
+            channel<0>(v, f0, scale[0], bias[0], std::make_index_sequence<NF>());
+            channel<1>(v, f1, scale[1], bias[1], std::make_index_sequence<NF>());
+            channel<2>(v, f2, scale[2], bias[2], std::make_index_sequence<NF>());
+            std::memcpy(planes[0] + i, &f0, sizeof(f0));
+            std::memcpy(planes[1] + i, &f1, sizeof(f1));
+            std::memcpy(planes[2] + i, &f2, sizeof(f2));
+        }
+        float* rest[3] = { planes[0] + i, planes[1] + i, planes[2] + i };
+        PixelScalarKernel::normalizePlanar(src + i * 3, rest, pixels - i, scale, bias);
+    }
+};
+
+/**
+ * Pixel kernel entry points compiled for one instruction set.
+ */
+#define CVLIB_PIXEL_KERNEL_TARGET(NAME, TARGET, BYTES) \
+    struct NAME { \
+        using K = PixelSimdKernel<BYTES>; \
+        TARGET static void swapRB(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) \
+            { K::swapRB(src, dst, pixels, channels); } \
+        TARGET static void grayToBGR(const uint8_t* src, uint8_t* dst, size_t pixels) \
+            { K::grayToBGR(src, dst, pixels); } \
+        TARGET static void mirror(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) \
+            { K::mirror(src, dst, pixels, channels); } \
+        TARGET static void swapBytes(uint8_t* a, uint8_t* b, size_t n) \
+            { K::swapBytes(a, b, n); } \
+        TARGET static void normalize(const uint8_t* src, float* dst, size_t pixels, const float* scale, const float* bias) \
+            { K::normalize(src, dst, pixels, scale, bias); } \
+        TARGET static void normalizePlanar(const uint8_t* src, float* const* planes, size_t pixels, \
+                                           const float* scale, const float* bias) \
+            { K::normalizePlanar(src, planes, pixels, scale, bias); } \
+    };
+
+#if LUAINTF_SIMD_X86
+CVLIB_PIXEL_KERNEL_TARGET(PixelKernelTarget128, __attribute__((target("sse4.1"))), 16)
+CVLIB_PIXEL_KERNEL_TARGET(PixelKernelTarget256, __attribute__((target("avx2"))), 32)
+CVLIB_PIXEL_KERNEL_TARGET(PixelKernelTarget512, __attribute__((target("avx512f,avx512bw"))), 64)
+#else
+CVLIB_PIXEL_KERNEL_TARGET(PixelKernelTarget128, , 16)
+#endif
+
+#undef CVLIB_PIXEL_KERNEL_TARGET
+
+#endif // LUAINTF_SIMD
+
+/**
+ * Pixel conversion kernels of CVLib, with the instruction set chosen once on first use,
+ * like LuaIntf::TensorKernels. On x86-64 the SSE2 level needs SSE4.1 here and AVX512
+ * needs AVX-512BW, a CPU without them gets the next lower level.
+ */
+class PixelKernels {
+public:
+    /**
+     * The instruction set level in use
+     */
+    static TensorKernelLevel level() {
+        return table().level;
+    }
+
+    /**
+     * Limit the instruction set level, for testing and benchmarks.
+     *
+     * @return the level in use
+     */
+    static TensorKernelLevel setLevel(TensorKernelLevel max_level) {
+        table() = select(max_level);
+        return table().level;
+    }
+
+    static void swapRB(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) {
+        table().swapRB(src, dst, pixels, channels);
+    }
+    static void grayToBGR(const uint8_t* src, uint8_t* dst, size_t pixels) {
+        table().grayToBGR(src, dst, pixels);
+    }
+    static void mirror(const uint8_t* src, uint8_t* dst, size_t pixels, int channels) {
+        table().mirror(src, dst, pixels, channels);
+    }
+    static void swapBytes(uint8_t* a, uint8_t* b, size_t n) {
+        table().swapBytes(a, b, n);
+    }
+    static void normalize(const uint8_t* src, float* dst, size_t pixels, const float* scale, const float* bias) {
+        table().normalize(src, dst, pixels, scale, bias);
+    }
+    static void normalizePlanar(const uint8_t* src, float* const* planes, size_t pixels,
+                                const float* scale, const float* bias) {
+        table().normalizePlanar(src, planes, pixels, scale, bias);
+    }
+
+private:
+    struct Table {
+        TensorKernelLevel level;
+        void (*swapRB)(const uint8_t*, uint8_t*, size_t, int);
+        void (*grayToBGR)(const uint8_t*, uint8_t*, size_t);
+        void (*mirror)(const uint8_t*, uint8_t*, size_t, int);
+        void (*swapBytes)(uint8_t*, uint8_t*, size_t);
+        void (*normalize)(const uint8_t*, float*, size_t, const float*, const float*);
+        void (*normalizePlanar)(const uint8_t*, float* const*, size_t, const float*, const float*);
+    };
+
+    template <typename K>
+    static Table make(TensorKernelLevel level) {
+        return Table { level, &K::swapRB, &K::grayToBGR, &K::mirror, &K::swapBytes,
+            &K::normalize, &K::normalizePlanar };
+    }
+
+    static Table select(TensorKernelLevel max_level) {
+#if LUAINTF_SIMD
+#if LUAINTF_SIMD_X86
+        __builtin_cpu_init();
+        if (max_level >= TensorKernelLevel::AVX512 && __builtin_cpu_supports("avx512f")
+            && __builtin_cpu_supports("avx512bw"))
+        {
+            return make<PixelKernelTarget512>(TensorKernelLevel::AVX512);
+        }
+        if (max_level >= TensorKernelLevel::AVX2 && __builtin_cpu_supports("avx2")) {
+            return make<PixelKernelTarget256>(TensorKernelLevel::AVX2);
+        }
+        if (max_level >= TensorKernelLevel::SSE2 && __builtin_cpu_supports("sse4.1")) {
+            return make<PixelKernelTarget128>(TensorKernelLevel::SSE2);
+        }
+#else
+        if (max_level >= TensorKernelLevel::SSE2) {
+            return make<PixelKernelTarget128>(TensorKernelLevel::SSE2);
+        }
+#endif
+#endif
+        (void)max_level;
+        return make<PixelScalarKernel>(TensorKernelLevel::SCALAR);
+    }
+
+    static Table& table() {
+        static Table t = select(TensorKernelLevel::AVX512);
+        return t;
+    }
+};
+
+} // namespace CVLib
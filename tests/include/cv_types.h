@@ -1,28 +1,338 @@
 #pragma once
 
+#include "LuaIntf.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <stdexcept>
 
 namespace CVLib {
 
+/**
+ * Allocator of image pixel buffers, pluggable with Image::setAllocator().
+ * Buffers are returned with the same size they were allocated with, possibly from another thread.
+ */
+class ImageAllocator {
+public:
+    virtual ~ImageAllocator() {}
+    virtual uint8_t* allocate(size_t nbytes) = 0;
+    virtual void deallocate(uint8_t* data, size_t nbytes) = 0;
+};
+
+/**
+ * Plain heap allocator, 64 byte aligned. Every image gets fresh memory.
+ */
+class HeapImageAllocator : public ImageAllocator {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    
+    uint8_t* allocate(size_t nbytes) override {
+        return static_cast<uint8_t*>(::operator new(nbytes, std::align_val_t(ALIGNMENT)));
+    }
+    
+    void deallocate(uint8_t* data, size_t) override {
+        ::operator delete(data, std::align_val_t(ALIGNMENT));
+    }
+};
+
+/**
+ * Advice for fresh pool buffers (bit flags)
+ */
+namespace ImagePoolAdvice {
+    enum : unsigned {
+        NONE = 0,
+        HUGEPAGE = 1,   // 2 MB aligned and madvise(MADV_HUGEPAGE) for buffers of 2 MB or more
+        POPULATE = 2,   // madvise(MADV_POPULATE_WRITE), fault all pages in one call
+    };
+}
+
+/**
+ * Pool of image buffers keyed by exact byte size. A stream has only a few distinct frame
+ * sizes, so released buffers are handed to the next image of the same size instead of
+ * faulting in fresh zeroed pages. At most max_retained_bytes are kept; buffers beyond that
+ * are freed. The advice is fixed for the pool lifetime, replace the pool to change it.
+ * Thread safe.
+ */
+class ImageBufferPool : public ImageAllocator {
+public:
+    static constexpr size_t DEFAULT_MAX_RETAINED = 64 << 20;
+    static constexpr size_t HUGEPAGE_SIZE = 2 << 20;
+    
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t retained_bytes = 0;
+        size_t retained_buffers = 0;
+    };
+    
+    explicit ImageBufferPool(size_t max_retained_bytes = DEFAULT_MAX_RETAINED, unsigned advice = ImagePoolAdvice::NONE)
+        : max_retained_(max_retained_bytes), advice_(advice) {}
+    
+    ~ImageBufferPool() override {
+        clear();
+    }
+    
+    uint8_t* allocate(size_t nbytes) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = free_.find(nbytes);
+            if (it != free_.end() && !it->second.empty()) {
+                uint8_t* data = it->second.back();
+                it->second.pop_back();
+                stats_.hits++;
+                stats_.retained_bytes -= nbytes;
+                stats_.retained_buffers--;
+                return data;
+            }
+            stats_.misses++;
+        }
+        return allocateFresh(nbytes);
+    }
+    
+    void deallocate(uint8_t* data, size_t nbytes) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stats_.retained_bytes + nbytes <= max_retained_) {
+                free_[nbytes].push_back(data);
+                stats_.retained_bytes += nbytes;
+                stats_.retained_buffers++;
+                return;
+            }
+        }
+        freeFresh(data, nbytes);
+    }
+    
+    /**
+     * Free all retained buffers, buffers in use are returned to the pool later as usual
+     */
+    void clear() {
+        std::unordered_map<size_t, std::vector<uint8_t*>> retained;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            retained.swap(free_);
+            stats_.retained_bytes = 0;
+            stats_.retained_buffers = 0;
+        }
+        for (auto& bucket : retained) {
+            for (uint8_t* data : bucket.second) {
+                freeFresh(data, bucket.first);
+            }
+        }
+    }
+    
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+    
+    size_t maxRetainedBytes() const { return max_retained_; }
+    unsigned advice() const { return advice_; }
+
+private:
+    bool isHuge(size_t nbytes) const {
+        return (advice_ & ImagePoolAdvice::HUGEPAGE) && nbytes >= HUGEPAGE_SIZE;
+    }
+    
+    uint8_t* allocateFresh(size_t nbytes) {
+        size_t align = isHuge(nbytes) ? HUGEPAGE_SIZE : HeapImageAllocator::ALIGNMENT;
+        uint8_t* data = static_cast<uint8_t*>(::operator new(nbytes, std::align_val_t(align)));
+#if defined(MADV_HUGEPAGE)
+        if (isHuge(nbytes)) {
+            madvise(data, nbytes / HUGEPAGE_SIZE * HUGEPAGE_SIZE, MADV_HUGEPAGE);
+        }
+#endif
+#if defined(MADV_POPULATE_WRITE)
+        if (advice_ & ImagePoolAdvice::POPULATE) {
+            // madvise needs page aligned range, populate the whole pages inside the buffer
+            const uintptr_t page = 4096;
+            uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + page - 1) & ~(page - 1);
+            uintptr_t end = (reinterpret_cast<uintptr_t>(data) + nbytes) & ~(page - 1);
+            if (end > begin) {
+                madvise(reinterpret_cast<void*>(begin), end - begin, MADV_POPULATE_WRITE);
+            }
+        }
+#endif
+        return data;
+    }
+    
+    void freeFresh(uint8_t* data, size_t nbytes) {
+        size_t align = isHuge(nbytes) ? HUGEPAGE_SIZE : HeapImageAllocator::ALIGNMENT;
+        ::operator delete(data, std::align_val_t(align));
+    }
+    
+    mutable std::mutex mutex_;
+    std::unordered_map<size_t, std::vector<uint8_t*>> free_;
+    Stats stats_;
+    size_t max_retained_;
+    unsigned advice_;
+};
+
 /**
  * Image represents a computer vision image with width, height, and pixel data.
  * Used throughout the preprocessing pipeline.
+ *
+ * Pixels come from the current ImageAllocator (an ImageBufferPool by default) and go back
+ * to it when the last Image sharing them is gone.
+ *
+ * Rows are stride() bytes apart, so an Image may be a view (see roi()) into a larger
+ * buffer; kernels must step rows by stride(). Copying an Image object aliases the same
+ * pixels, like the views. clone() shares the pixels copy-on-write instead: the first
+ * mutating access through data(), at() or fill() of either side copies the buffer.
+ * The sharing check is not atomic, an Image and its clones must not be mutated from
+ * different threads at the same time.
+ *
+ * rowView(), plane() and pixels() export the pixels as zero-copy tensor views that keep
+ * the buffer alive. While such views exist clone() copies eagerly, so they never see
+ * copy-on-write sharing.
  */
 class Image {
 private:
+    /**
+     * Buffer shared by an image and its views. Clones get their own Storage pointing at
+     * the same bytes, so a write detaches all views of one side together.
+     */
+    struct Storage {
+        std::shared_ptr<uint8_t> bytes;
+        std::shared_ptr<void> copies;   // token held by each Storage sharing bytes, null if none
+        size_t size = 0;
+        bool read_only = false;         // external memory (see wrapReadOnly), always copied on write
+    };
+    
     int width_;
     int height_;
     int channels_;
-    std::shared_ptr<std::vector<uint8_t>> data_;
+    size_t stride_ = 0;
+    size_t offset_ = 0;
+    std::shared_ptr<Storage> storage_;
+
+    struct AllocatorSlot {
+        std::mutex mutex;
+        std::shared_ptr<ImageAllocator> allocator = std::make_shared<ImageBufferPool>();
+    };
+    
+    static AllocatorSlot& allocatorSlot() {
+        static AllocatorSlot slot;
+        return slot;
+    }
+    
+    // Negative or zero dimensions give an empty buffer
+    static size_t byteSize(int width, int height, int channels) {
+        if (width <= 0 || height <= 0 || channels <= 0) return 0;
+        return static_cast<size_t>(width) * height * channels;
+    }
+    
+    Image(int width, int height, int channels, bool zero_fill)
+        : width_(width), height_(height), channels_(channels) {
+        size_t size = byteSize(width, height, channels);
+        if (size > 0) {
+            stride_ = static_cast<size_t>(width) * channels;
+            storage_ = std::make_shared<Storage>();
+            storage_->bytes = allocateBuffer(size);
+            storage_->size = size;
+            if (zero_fill) {
+                std::memset(storage_->bytes.get(), 0, size);
+            }
+        }
+    }
+    
+    static std::shared_ptr<uint8_t> allocateBuffer(size_t nbytes) {
+        if (nbytes == 0) return nullptr;
+        std::shared_ptr<ImageAllocator> allocator = getAllocator();
+        uint8_t* data = allocator->allocate(nbytes);
+        try {
+            return std::shared_ptr<uint8_t>(data, [allocator, nbytes](uint8_t* p) {
+                allocator->deallocate(p, nbytes);
+            });
+        } catch (...) {
+            allocator->deallocate(data, nbytes);
+            throw;
+        }
+    }
+    
+    /**
+     * Stop sharing bytes with clones before a write. Without views only the own pixels
+     * are copied (compact), otherwise the whole buffer so the views keep their layout.
+     */
+    void detach() {
+        if (!storage_ || (!storage_->read_only && storage_->copies.use_count() <= 1)) return;
+        if (storage_.use_count() == 1) {
+            Image copy = uninitialized(width_, height_, channels_);
+            copyRows(*this, copy);
+            *this = std::move(copy);
+        } else {
+            std::shared_ptr<uint8_t> bytes = allocateBuffer(storage_->size);
+            std::memcpy(bytes.get(), storage_->bytes.get(), storage_->size);
+            storage_->bytes = std::move(bytes);
+            storage_->copies.reset();
+            storage_->read_only = false;
+        }
+    }
+    
+    // Tensor views exported from the buffer, they hold bytes without a Storage
+    bool hasExportedViews() const {
+        long holders = std::max<long>(storage_->copies.use_count(), 1);
+        return storage_->bytes.use_count() > holders;
+    }
+    
+    static void copyRows(const Image& src, Image& dst) {
+        size_t row_bytes = src.rowBytes();
+        for (int y = 0; y < src.height_; y++) {
+            std::memcpy(dst.storage_->bytes.get() + dst.offset_ + y * dst.stride_,
+                src.storage_->bytes.get() + src.offset_ + y * src.stride_, row_bytes);
+        }
+    }
 
 public:
     Image() : width_(0), height_(0), channels_(0) {}
     
     Image(int width, int height, int channels = 3)
-        : width_(width), height_(height), channels_(channels) {
-        data_ = std::make_shared<std::vector<uint8_t>>(width * height * channels);
+        : Image(width, height, channels, true) {}
+    
+    /**
+     * Image without zero fill, for results that are about to be fully overwritten
+     */
+    static Image uninitialized(int width, int height, int channels = 3) {
+        return Image(width, height, channels, false);
+    }
+    
+    /**
+     * Image over external read-only memory, such as a frame of a mapped file, without copy.
+     * owner keeps the memory alive; the first mutating access copies the pixels into a
+     * buffer of the current allocator, like a clone.
+     */
+    static Image wrapReadOnly(const uint8_t* data, int width, int height, int channels, size_t stride,
+                              std::shared_ptr<void> owner) {
+        Image img;
+        img.width_ = width;
+        img.height_ = height;
+        img.channels_ = channels;
+        size_t row_bytes = byteSize(width, 1, channels);
+        if (row_bytes > 0 && height > 0) {
+            img.stride_ = stride;
+            img.storage_ = std::make_shared<Storage>();
+            img.storage_->bytes = std::shared_ptr<uint8_t>(std::move(owner), const_cast<uint8_t*>(data));
+            img.storage_->size = (height - 1) * stride + row_bytes;
+            img.storage_->read_only = true;
+        }
+        return img;
+    }
+    
+    /**
+     * Allocator used by new images; images keep the allocator of their buffer alive
+     */
+    static std::shared_ptr<ImageAllocator> getAllocator() {
+        AllocatorSlot& slot = allocatorSlot();
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        return slot.allocator;
+    }
+    
+    static void setAllocator(std::shared_ptr<ImageAllocator> allocator) {
+        AllocatorSlot& slot = allocatorSlot();
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.allocator = allocator ? std::move(allocator) : std::make_shared<HeapImageAllocator>();
     }
     
     // Lua-accessible properties
@@ -30,32 +340,137 @@ public:
     int getHeight() const { return height_; }
     int getChannels() const { return channels_; }
     
-    // Data access
-    uint8_t* data() { return data_->data(); }
-    const uint8_t* data() const { return data_->data(); }
-    size_t size() const { return data_->size(); }
+    // Row layout: stride() bytes between rows, rowBytes() of them are pixels
+    size_t stride() const { return stride_; }
+    size_t rowBytes() const { return byteSize(width_, 1, channels_); }
+    bool isContinuous() const { return stride_ == rowBytes(); }
+    
+    // Data access, pixel (0, 0); the mutable form detaches from clones
+    uint8_t* data() {
+        detach();
+        return storage_ ? storage_->bytes.get() + offset_ : nullptr;
+    }
+    const uint8_t* data() const {
+        return storage_ ? storage_->bytes.get() + offset_ : nullptr;
+    }
+    
+    uint8_t* row(int y) { return data() + y * stride_; }
+    const uint8_t* row(int y) const { return data() + y * stride_; }
+    
+    // Pixel bytes, without the gaps between rows of a view
+    size_t size() const { return byteSize(width_, height_, channels_); }
     
     bool empty() const { return width_ == 0 || height_ == 0; }
     
+    /**
+     * True if both are the same buffer or views of it, so writing one can change the other.
+     * Clones are not aliases, they detach on write.
+     */
+    bool aliases(const Image& other) const {
+        return storage_ && storage_ == other.storage_;
+    }
+    
+    /**
+     * View of region, sharing pixels with this image (writes go through)
+     *
+     * @throws std::out_of_range if region is outside image
+     */
+    Image roi(int x, int y, int w, int h) {
+        if (x < 0 || y < 0 || w < 0 || h < 0 || x > width_ - w || y > height_ - h) {
+            throw std::out_of_range("Image::roi - region out of bounds");
+        }
+        Image view(*this);
+        view.width_ = w;
+        view.height_ = h;
+        if (w == 0 || h == 0) {
+            view.storage_.reset();
+            view.offset_ = 0;
+            view.stride_ = 0;
+        } else {
+            view.offset_ = offset_ + y * stride_ + static_cast<size_t>(x) * channels_;
+        }
+        return view;
+    }
+    
+    /**
+     * Zero-copy view of row y (0-based), width * channels bytes
+     *
+     * @throws std::out_of_range if y is outside image
+     */
+    LuaIntf::TensorView<uint8_t> rowView(int y) {
+        if (y < 0 || y >= height_) {
+            throw std::out_of_range("Image::rowView - row out of range");
+        }
+        uint8_t* p = row(y);
+        return LuaIntf::TensorView<uint8_t>(p, rowBytes(), storage_->bytes);
+    }
+    
+    /**
+     * Zero-copy view of channel c (0-based) as height x width, strided by channels
+     *
+     * @throws std::out_of_range if c is outside channels
+     */
+    LuaIntf::StridedTensorView<uint8_t> plane(int c) {
+        if (c < 0 || c >= channels_) {
+            throw std::out_of_range("Image::plane - channel out of range");
+        }
+        if (size() == 0) {
+            return LuaIntf::StridedTensorView<uint8_t>();
+        }
+        uint8_t* p = data();
+        return LuaIntf::StridedTensorView<uint8_t>(p + c,
+            { static_cast<size_t>(height_), static_cast<size_t>(width_) },
+            { static_cast<ptrdiff_t>(stride_), channels_ }, storage_->bytes);
+    }
+    
+    /**
+     * Zero-copy view of all pixel bytes, interleaved in row-major order
+     *
+     * @throws std::logic_error if image is a view with gaps between rows
+     */
+    LuaIntf::TensorView<uint8_t> pixels() {
+        if (size() == 0) {
+            return LuaIntf::TensorView<uint8_t>();
+        }
+        if (!isContinuous()) {
+            throw std::logic_error("Image::pixels - image is not continuous, use clone() or rowView()");
+        }
+        uint8_t* p = data();
+        return LuaIntf::TensorView<uint8_t>(p, size(), storage_->bytes);
+    }
+    
     // Utility methods
     Image clone() const {
-        Image img(width_, height_, channels_);
-        if (data_) {
-            std::copy(data_->begin(), data_->end(), img.data_->begin());
+        if (!storage_) {
+            return *this;
+        }
+        if (!storage_->read_only && hasExportedViews()) {
+            // views would keep writing the shared bytes, copy now
+            Image img = uninitialized(width_, height_, channels_);
+            copyRows(*this, img);
+            return img;
         }
+        if (!storage_->copies) {
+            storage_->copies = std::make_shared<char>();
+        }
+        Image img(*this);
+        img.storage_ = std::make_shared<Storage>(*storage_);
         return img;
     }
     
     void copyFrom(const Image& other) {
-        width_ = other.width_;
-        height_ = other.height_;
-        channels_ = other.channels_;
-        data_ = std::make_shared<std::vector<uint8_t>>(*other.data_);
+        *this = other.clone();
     }
     
     void fill(uint8_t value) {
-        if (data_) {
-            std::fill(data_->begin(), data_->end(), value);
+        if (size() == 0) return;
+        uint8_t* p = data();
+        if (isContinuous()) {
+            std::memset(p, value, size());
+            return;
+        }
+        for (int y = 0; y < height_; y++) {
+            std::memset(p + y * stride_, value, rowBytes());
         }
     }
     
@@ -64,88 +479,123 @@ public:
         if (y < 0 || y >= height_ || x < 0 || x >= width_ || c < 0 || c >= channels_) {
             throw std::out_of_range("Image::at - index out of range");
         }
-        return (*data_)[(y * width_ + x) * channels_ + c];
+        return row(y)[x * channels_ + c];
     }
     
     uint8_t& at(int y, int x, int c) {
         if (y < 0 || y >= height_ || x < 0 || x >= width_ || c < 0 || c >= channels_) {
             throw std::out_of_range("Image::at - index out of range");
         }
-        return (*data_)[(y * width_ + x) * channels_ + c];
+        return row(y)[x * channels_ + c];
     }
 };
 
 /**
- * Tensor represents multi-dimensional array data (typically float).
+ * Tensor represents multi-dimensional array data, float32 by default (see Tensor below).
  * Used for model input/output.
+ *
+ * Data is held by a shared owner: view() exports it to Lua without copy, and a tensor can
+ * adopt an external buffer (model output, mapped file, TensorView) instead of copying it.
  */
-class Tensor {
+template <typename T>
+class BasicTensor {
 private:
     std::vector<int> shape_;
-    std::shared_ptr<std::vector<double>> data_;
+    T* data_ = nullptr;
+    size_t length_ = 0;
+    std::shared_ptr<void> owner_;
+
+    static size_t count(const std::vector<int>& shape) {
+        size_t total = 1;
+        for (int dim : shape) total *= dim;
+        return total;
+    }
 
 public:
-    Tensor() {}
+    using ValueType = T;
+
+    BasicTensor() {}
     
-    explicit Tensor(const std::vector<int>& shape)
+    explicit BasicTensor(const std::vector<int>& shape)
         : shape_(shape) {
-        size_t total = 1;
-        for (int dim : shape) total *= dim;
-        data_ = std::make_shared<std::vector<double>>(total, 0.0);
+        auto storage = std::make_shared<std::vector<T>>(count(shape), T(0));
+        data_ = storage->data();
+        length_ = storage->size();
+        owner_ = storage;
+    }
+    
+    // Adopt external buffer without copy, owner keeps it alive (null if caller guarantees lifetime)
+    BasicTensor(T* data, const std::vector<int>& shape, std::shared_ptr<void> owner)
+        : shape_(shape), data_(data), length_(count(shape)), owner_(std::move(owner)) {}
+    
+    // Adopt buffer of a view without copy, shape must match view length
+    BasicTensor(const LuaIntf::TensorView<T>& view, const std::vector<int>& shape)
+        : BasicTensor(view.data(), shape, view.owner()) {
+        if (length_ != view.size()) {
+            throw std::invalid_argument("Tensor - shape does not match view length");
+        }
     }
     
     // Lua-accessible methods
     std::vector<int> getShapeCpp() const { return shape_; }
-    size_t length() const { return data_ ? data_->size() : 0; }
+    size_t length() const { return length_; }
     int ndim() const { return shape_.size(); }
     
     // Data access
-    double* data() { return data_->data(); }
-    const double* data() const { return data_->data(); }
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    const std::shared_ptr<void>& owner() const { return owner_; }
     
-    bool empty() const { return !data_ || data_->empty(); }
+    bool empty() const { return length_ == 0; }
+    
+    // Zero-copy view sharing ownership of data
+    LuaIntf::TensorView<T> view() const {
+        return LuaIntf::TensorView<T>(data_, length_, owner_);
+    }
     
     // Utility methods
-    Tensor clone() const {
-        Tensor t;
+    BasicTensor clone() const {
+        BasicTensor t;
         t.shape_ = shape_;
         if (data_) {
-            t.data_ = std::make_shared<std::vector<double>>(*data_);
+            auto storage = std::make_shared<std::vector<T>>(data_, data_ + length_);
+            t.data_ = storage->data();
+            t.length_ = storage->size();
+            t.owner_ = storage;
         }
         return t;
     }
     
-    void fill(double value) {
-        if (data_) {
-            std::fill(data_->begin(), data_->end(), value);
-        }
+    void fill(T value) {
+        std::fill(data_, data_ + length_, value);
     }
     
     void reshapeCpp(const std::vector<int>& new_shape) {
-        size_t new_size = 1;
-        for (int dim : new_shape) new_size *= dim;
-        if (new_size != length()) {
+        if (count(new_shape) != length()) {
             throw std::runtime_error("Tensor::reshape - incompatible shape");
         }
         shape_ = new_shape;
     }
     
     // Element access (flattened index)
-    double at(size_t idx) const {
+    T at(size_t idx) const {
         if (idx >= length()) {
             throw std::out_of_range("Tensor::at - index out of range");
         }
-        return (*data_)[idx];
+        return data_[idx];
     }
     
-    double& at(size_t idx) {
+    T& at(size_t idx) {
         if (idx >= length()) {
             throw std::out_of_range("Tensor::at - index out of range");
         }
-        return (*data_)[idx];
+        return data_[idx];
     }
 };
 
+// Model inputs and outputs are float32
+using Tensor = BasicTensor<float>;
+
 /**
  * PadInfo is represented as plain Lua table (no C++ class needed).
  * Structure: {top=N, left=N, bottom=N, right=N}
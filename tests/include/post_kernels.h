@@ -0,0 +1,264 @@
+#pragma once
+
+#include "LuaIntf.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace PostLib {
+
+using LuaIntf::TensorKernelLevel;
+
+/**
+ * Box columns compared by the kernels, area[i] = (x2[i] - x1[i]) * (y2[i] - y1[i]).
+ */
+struct BoxColumns {
+    const float* x1;
+    const float* y1;
+    const float* x2;
+    const float* y2;
+    const float* area;
+};
+
+/**
+ * Scalar reference box kernels, used without SIMD and as reference for testing.
+ *
+ * Kernels compare one box {x1, y1, x2, y2, area} with n boxes of the columns.
+ * The overlap is IoU, or DIoU (IoU minus squared center distance over squared
+ * diagonal of the enclosing box) with diou set. Boxes without area overlap by 0.
+ */
+struct BoxScalarKernel {
+    static float overlapOne(const float* box, const BoxColumns& c, size_t j, bool diou) {
+        float iw = std::max(std::min(box[2], c.x2[j]) - std::max(box[0], c.x1[j]), 0.0f);
+        float ih = std::max(std::min(box[3], c.y2[j]) - std::max(box[1], c.y1[j]), 0.0f);
+        float inter = iw * ih;
+        float uni = box[4] + c.area[j] - inter;
+        float iou = uni > 0 ? inter / uni : 0.0f;
+        if (!diou) return iou;
+
+        float cw = std::max(box[2], c.x2[j]) - std::min(box[0], c.x1[j]);
+        float ch = std::max(box[3], c.y2[j]) - std::min(box[1], c.y1[j]);
+        float dx = (box[0] + box[2] - c.x1[j] - c.x2[j]) * 0.5f;
+        float dy = (box[1] + box[3] - c.y1[j] - c.y2[j]) * 0.5f;
+        float c2 = cw * cw + ch * ch;
+        return c2 > 0 ? iou - (dx * dx + dy * dy) / c2 : iou;
+    }
+
+    /**
+     * out[j] = overlap of box and box j.
+     */
+    static void overlap(const float* box, const BoxColumns& c, size_t n, bool diou, float* out) {
+        for (size_t j = 0; j < n; j++) {
+            out[j] = overlapOne(box, c, j, diou);
+        }
+    }
+
+    /**
+     * removed[j] = -1 if overlap of box and box j > threshold, other entries are kept.
+     */
+    static void suppress(const float* box, const BoxColumns& c, size_t n, float threshold, bool diou,
+                         int32_t* removed) {
+        for (size_t j = 0; j < n; j++) {
+            if (overlapOne(box, c, j, diou) > threshold) removed[j] = -1;
+        }
+    }
+
+    /**
+     * v[i] = (v[i] - offset) * scale clamped to [0, hi], in place. NaN becomes 0.
+     */
+    static void scaleClamp(float* v, size_t n, float offset, float scale, float hi) {
+        for (size_t i = 0; i < n; i++) {
+            v[i] = std::max(0.0f, std::min((v[i] - offset) * scale, hi));
+        }
+    }
+};
+
+#if LUAINTF_SIMD
+
+/**
+ * Vector box kernels for BYTES wide registers, written with GCC/Clang vector extensions.
+ * Columns are loaded unaligned, the scalar kernel finishes the tail.
+ * All functions are forced inline, so they take the instruction set of the caller.
+ */
+template <int BYTES>
+struct BoxSimdKernel {
+    // element types have to be dependent, or GCC ignores dependent vector_size
+    using F = typename std::conditional<BYTES != 0, float, void>::type;
+    using I = typename std::conditional<BYTES != 0, int32_t, void>::type;
+
+    static constexpr size_t N = BYTES / sizeof(float);
+
+    typedef F VF __attribute__((vector_size(BYTES)));
+    typedef I VI __attribute__((vector_size(BYTES)));
+
+    // vectors are passed by reference, to keep the ABI independent of target
+    [[gnu::always_inline]] static inline void overlapAt(const float* box, const BoxColumns& c, size_t j,
+                                                        bool diou, VF& out) {
+        const VF zero = VF{} + 0.0f;
+        const VF bx1 = zero + box[0], by1 = zero + box[1], bx2 = zero + box[2], by2 = zero + box[3];
+        VF x1, y1, x2, y2, area;
+        std::memcpy(&x1, c.x1 + j, sizeof(VF));
+        std::memcpy(&y1, c.y1 + j, sizeof(VF));
+        std::memcpy(&x2, c.x2 + j, sizeof(VF));
+        std::memcpy(&y2, c.y2 + j, sizeof(VF));
+        std::memcpy(&area, c.area + j, sizeof(VF));
+        
+        VF iw = (x2 < bx2 ? x2 : bx2) - (x1 > bx1 ? x1 : bx1);
+        VF ih = (y2 < by2 ? y2 : by2) - (y1 > by1 ? y1 : by1);
+        iw = iw > zero ? iw : zero;
+        ih = ih > zero ? ih : zero;
+        VF inter = iw * ih;
+        VF uni = box[4] + area - inter;
+        VF iou = uni > zero ? inter / uni : zero;
+        if (diou) {
+            VF cw = (x2 > bx2 ? x2 : bx2) - (x1 < bx1 ? x1 : bx1);
+            VF ch = (y2 > by2 ? y2 : by2) - (y1 < by1 ? y1 : by1);
+            VF dx = (bx1 + bx2 - x1 - x2) * 0.5f;
+            VF dy = (by1 + by2 - y1 - y2) * 0.5f;
+            VF c2 = cw * cw + ch * ch;
+            iou = c2 > zero ? iou - (dx * dx + dy * dy) / c2 : iou;
+        }
+        out = iou;
+    }
+
+    [[gnu::always_inline]] static inline void overlap(const float* box, const BoxColumns& c, size_t n,
+                                                      bool diou, float* out) {
+        size_t j = 0;
+        for (; j + N <= n; j += N) {
+            VF v;
+            overlapAt(box, c, j, diou, v);
+            std::memcpy(out + j, &v, sizeof(v));
+        }
+        for (; j < n; j++) out[j] = BoxScalarKernel::overlapOne(box, c, j, diou);
+    }
+
+    [[gnu::always_inline]] static inline void suppress(const float* box, const BoxColumns& c, size_t n,
+                                                       float threshold, bool diou, int32_t* removed) {
+        size_t j = 0;
+        for (; j + N <= n; j += N) {
+            VF v;
+            overlapAt(box, c, j, diou, v);
+            VI r;
+            std::memcpy(&r, removed + j, sizeof(r));
+            r |= v > threshold;
+            std::memcpy(removed + j, &r, sizeof(r));
+        }
+        BoxColumns rest = { c.x1 + j, c.y1 + j, c.x2 + j, c.y2 + j, c.area + j };
+        BoxScalarKernel::suppress(box, rest, n - j, threshold, diou, removed + j);
+    }
+
+    [[gnu::always_inline]] static inline void scaleClamp(float* v, size_t n, float offset, float scale, float hi) {
+        const VF zero = VF{} + 0.0f;
+        const VF vhi = zero + hi;
+        size_t i = 0;
+        for (; i + N <= n; i += N) {
+            VF x;
+            std::memcpy(&x, v + i, sizeof(x));
+            x = (x - offset) * scale;
+            x = vhi < x ? vhi : x;
+            x = zero < x ? x : zero;
+            std::memcpy(v + i, &x, sizeof(x));
+        }
+        BoxScalarKernel::scaleClamp(v + i, n - i, offset, scale, hi);
+    }
+};
+
+/**
+ * Box kernel entry points compiled for one instruction set.
+ */
+#define POSTLIB_BOX_KERNEL_TARGET(NAME, TARGET, BYTES) \
+    struct NAME { \
+        using K = BoxSimdKernel<BYTES>; \
+        TARGET static void overlap(const float* box, const BoxColumns& c, size_t n, bool diou, float* out) \
+            { K::overlap(box, c, n, diou, out); } \
+        TARGET static void suppress(const float* box, const BoxColumns& c, size_t n, float threshold, bool diou, \
+                                    int32_t* removed) \
+            { K::suppress(box, c, n, threshold, diou, removed); } \
+        TARGET static void scaleClamp(float* v, size_t n, float offset, float scale, float hi) \
+            { K::scaleClamp(v, n, offset, scale, hi); } \
+    };
+
+POSTLIB_BOX_KERNEL_TARGET(BoxKernelTarget128, , 16)
+#if LUAINTF_SIMD_X86
+POSTLIB_BOX_KERNEL_TARGET(BoxKernelTarget256, __attribute__((target("avx2"))), 32)
+POSTLIB_BOX_KERNEL_TARGET(BoxKernelTarget512, __attribute__((target("avx512f"))), 64)
+#endif
+
+#undef POSTLIB_BOX_KERNEL_TARGET
+
+#endif // LUAINTF_SIMD
+
+/**
+ * Box kernels of PostLib, with the instruction set chosen once on first use,
+ * like LuaIntf::TensorKernels.
+ */
+class BoxKernels {
+public:
+    /**
+     * The instruction set level in use
+     */
+    static TensorKernelLevel level() {
+        return table().level;
+    }
+
+    /**
+     * Limit the instruction set level, for testing and benchmarks.
+     *
+     * @return the level in use
+     */
+    static TensorKernelLevel setLevel(TensorKernelLevel max_level) {
+        table() = select(max_level);
+        return table().level;
+    }
+
+    static void overlap(const float* box, const BoxColumns& c, size_t n, bool diou, float* out) {
+        table().overlap(box, c, n, diou, out);
+    }
+    static void suppress(const float* box, const BoxColumns& c, size_t n, float threshold, bool diou,
+                         int32_t* removed) {
+        table().suppress(box, c, n, threshold, diou, removed);
+    }
+    static void scaleClamp(float* v, size_t n, float offset, float scale, float hi) {
+        table().scaleClamp(v, n, offset, scale, hi);
+    }
+
+private:
+    struct Table {
+        TensorKernelLevel level;
+        void (*overlap)(const float*, const BoxColumns&, size_t, bool, float*);
+        void (*suppress)(const float*, const BoxColumns&, size_t, float, bool, int32_t*);
+        void (*scaleClamp)(float*, size_t, float, float, float);
+    };
+
+    template <typename K>
+    static Table make(TensorKernelLevel level) {
+        return Table { level, &K::overlap, &K::suppress, &K::scaleClamp };
+    }
+
+    static Table select(TensorKernelLevel max_level) {
+#if LUAINTF_SIMD
+#if LUAINTF_SIMD_X86
+        __builtin_cpu_init();
+        if (max_level >= TensorKernelLevel::AVX512 && __builtin_cpu_supports("avx512f")) {
+            return make<BoxKernelTarget512>(TensorKernelLevel::AVX512);
+        }
+        if (max_level >= TensorKernelLevel::AVX2 && __builtin_cpu_supports("avx2")) {
+            return make<BoxKernelTarget256>(TensorKernelLevel::AVX2);
+        }
+#endif
+        if (max_level >= TensorKernelLevel::SSE2) {
+            return make<BoxKernelTarget128>(TensorKernelLevel::SSE2);
+        }
+#endif
+        (void)max_level;
+        return make<BoxScalarKernel>(TensorKernelLevel::SCALAR);
+    }
+
+    static Table& table() {
+        static Table t = select(TensorKernelLevel::AVX512);
+        return t;
+    }
+};
+
+} // namespace PostLib
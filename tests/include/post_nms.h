@@ -0,0 +1,195 @@
+#pragma once
+
+#include "post_types.h"
+#include "post_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace PostLib {
+
+/**
+ * How NMS treats a box that overlaps a kept box by more than the threshold:
+ * HARD removes it, LINEAR (soft-NMS) scales its score by 1 - overlap, GAUSSIAN
+ * (soft-NMS) scales its score by exp(-overlap^2 / sigma) whatever the overlap.
+ */
+enum class NmsMethod { HARD, LINEAR, GAUSSIAN };
+
+struct NmsOptions {
+    float iou_threshold = 0.45f;
+    NmsMethod method = NmsMethod::HARD;
+    bool diou = false;               // compare DIoU instead of IoU
+    bool agnostic = false;           // boxes of different classes suppress each other too
+    size_t max_detections = 0;       // 0 for no limit
+    float sigma = 0.5f;              // GAUSSIAN only
+    float score_threshold = 0.001f;  // soft-NMS drops boxes whose score decays below it
+};
+
+/**
+ * Non-maximum suppression over a BoxArray.
+ *
+ * Boxes are sorted once, by class then score, and copied into columns so each class is
+ * a contiguous bucket. A kept box is compared with the rest of its bucket in one
+ * BoxKernels call. A bucket stops after max_detections kept boxes, since no class can
+ * contribute more, and the best max_detections of all buckets are kept.
+ *
+ * The scratch arrays are kept between runs, so an engine reused for inputs of similar
+ * size does not allocate. One engine must not be used by two threads at once.
+ */
+class NmsEngine {
+public:
+    /**
+     * Run NMS on boxes, boxes with NaN confidence are dropped.
+     * keep() is then the kept indices into boxes, ascending, and scores() their final
+     * scores (decayed by soft-NMS).
+     */
+    void run(const BoxArray& boxes, const NmsOptions& opts) {
+        sortBoxes(boxes, opts.agnostic);
+        kept_.clear();
+
+        size_t n = order_.size();
+        size_t limit = opts.max_detections > 0 ? opts.max_detections : n;
+        const int* class_id = boxes.classId();
+        for (size_t begin = 0; begin < n;) {
+            size_t end = begin + 1;
+            if (!opts.agnostic) {
+                while (end < n && class_id[order_[end]] == class_id[order_[begin]]) end++;
+            } else {
+                end = n;
+            }
+            if (opts.method == NmsMethod::HARD) {
+                hardBucket(begin, end, limit, opts);
+            } else {
+                softBucket(begin, end, limit, opts);
+            }
+            begin = end;
+        }
+
+        // best of all buckets, ties in input order
+        if (kept_.size() > limit) {
+            auto better = [this](size_t a, size_t b) {
+                return score_[a] > score_[b] || (score_[a] == score_[b] && order_[a] < order_[b]);
+            };
+            std::nth_element(kept_.begin(), kept_.begin() + limit, kept_.end(), better);
+            kept_.resize(limit);
+        }
+        std::sort(kept_.begin(), kept_.end(), [this](size_t a, size_t b) { return order_[a] < order_[b]; });
+
+        keep_.resize(kept_.size());
+        scores_.resize(kept_.size());
+        for (size_t k = 0; k < kept_.size(); k++) {
+            keep_[k] = order_[kept_[k]];
+            scores_[k] = score_[kept_[k]];
+        }
+    }
+
+    const std::vector<size_t>& keep() const { return keep_; }
+    const std::vector<float>& scores() const { return scores_; }
+
+private:
+    // order_ = boxes by class (unless agnostic), score descending, index; columns follow it
+    void sortBoxes(const BoxArray& boxes, bool agnostic) {
+        const float* conf = boxes.confidence();
+        const int* class_id = boxes.classId();
+        order_.clear();
+        for (size_t i = 0; i < boxes.size(); i++) {
+            if (!std::isnan(conf[i])) order_.push_back(i);
+        }
+        std::sort(order_.begin(), order_.end(), [conf, class_id, agnostic](size_t a, size_t b) {
+            if (!agnostic && class_id[a] != class_id[b]) return class_id[a] < class_id[b];
+            if (conf[a] != conf[b]) return conf[a] > conf[b];
+            return a < b;
+        });
+
+        size_t n = order_.size();
+        x1_.resize(n);
+        y1_.resize(n);
+        x2_.resize(n);
+        y2_.resize(n);
+        area_.resize(n);
+        score_.resize(n);
+        removed_.assign(n, 0);
+        overlap_.resize(n);
+        for (size_t k = 0; k < n; k++) {
+            size_t i = order_[k];
+            x1_[k] = boxes.x1()[i];
+            y1_[k] = boxes.y1()[i];
+            x2_[k] = boxes.x2()[i];
+            y2_[k] = boxes.y2()[i];
+            area_[k] = (x2_[k] - x1_[k]) * (y2_[k] - y1_[k]);
+            score_[k] = conf[i];
+        }
+    }
+
+    BoxColumns columnsFrom(size_t k) const {
+        return BoxColumns { x1_.data() + k, y1_.data() + k, x2_.data() + k, y2_.data() + k, area_.data() + k };
+    }
+
+    void boxAt(size_t k, float* box) const {
+        box[0] = x1_[k];
+        box[1] = y1_[k];
+        box[2] = x2_[k];
+        box[3] = y2_[k];
+        box[4] = area_[k];
+    }
+
+    // boxes are in score order, a box not removed by a better one is kept
+    void hardBucket(size_t begin, size_t end, size_t limit, const NmsOptions& opts) {
+        size_t kept = 0;
+        float box[5];
+        for (size_t k = begin; k < end && kept < limit; k++) {
+            if (removed_[k]) continue;
+            kept_.push_back(k);
+            kept++;
+            boxAt(k, box);
+            BoxKernels::suppress(box, columnsFrom(k + 1), end - k - 1, opts.iou_threshold, opts.diou,
+                removed_.data() + k + 1);
+        }
+    }
+
+    // decayed scores change the order, so the best remaining box is searched every step
+    void softBucket(size_t begin, size_t end, size_t limit, const NmsOptions& opts) {
+        size_t kept = 0;
+        float box[5];
+        for (size_t k = begin; k < end && kept < limit; k++) {
+            swap(k, k + LuaIntf::TensorKernels<float>::argmax(score_.data() + k, end - k));
+            if (!(score_[k] >= opts.score_threshold)) break;
+            kept_.push_back(k);
+            kept++;
+
+            boxAt(k, box);
+            BoxKernels::overlap(box, columnsFrom(k + 1), end - k - 1, opts.diou, overlap_.data() + k + 1);
+            for (size_t j = k + 1; j < end; j++) {
+                float o = std::max(overlap_[j], 0.0f);
+                if (opts.method == NmsMethod::LINEAR) {
+                    if (o > opts.iou_threshold) score_[j] *= 1 - o;
+                } else {
+                    score_[j] *= std::exp(-o * o / opts.sigma);
+                }
+            }
+        }
+    }
+
+    void swap(size_t a, size_t b) {
+        if (a == b) return;
+        std::swap(order_[a], order_[b]);
+        std::swap(x1_[a], x1_[b]);
+        std::swap(y1_[a], y1_[b]);
+        std::swap(x2_[a], x2_[b]);
+        std::swap(y2_[a], y2_[b]);
+        std::swap(area_[a], area_[b]);
+        std::swap(score_[a], score_[b]);
+    }
+
+private:
+    std::vector<size_t> order_;
+    std::vector<float> x1_, y1_, x2_, y2_, area_, score_;
+    std::vector<int32_t> removed_;
+    std::vector<float> overlap_;
+    std::vector<size_t> kept_;          // positions in order_
+    std::vector<size_t> keep_;
+    std::vector<float> scores_;
+};
+
+} // namespace PostLib
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 namespace PostLib {
 
@@ -51,4 +52,127 @@ public:
     }
 };
 
+/**
+ * Packed detections, stored as struct of arrays: one contiguous column per field.
+ * Decoders append to it directly, so no Lua table is built per box.
+ * clear() keeps the capacity, so an array reused every frame stops allocating.
+ *
+ * Column storage is shared with the views taken of it (see owner()). Growing while a view
+ * is alive moves the array to new storage and leaves the view on the old one: the view
+ * stays valid but no longer follows the array. Views never see boxes appended later.
+ */
+class BoxArray {
+public:
+    BoxArray() : size_(0), storage_(std::make_shared<Storage>(0)) {}
+    
+    explicit BoxArray(size_t capacity) : size_(0), storage_(std::make_shared<Storage>(capacity)) {}
+    
+    // Copies own their columns, they are never shared with the source
+    BoxArray(const BoxArray& other) : size_(other.size_), storage_(std::make_shared<Storage>(*other.storage_)) {}
+    
+    BoxArray& operator=(const BoxArray& other) {
+        if (this != &other) {
+            size_ = other.size_;
+            storage_ = std::make_shared<Storage>(*other.storage_);
+        }
+        return *this;
+    }
+    
+    size_t size() const { return size_; }
+    int length() const { return static_cast<int>(size_); }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return storage_->capacity(); }
+    
+    void clear() { size_ = 0; }
+    
+    void reserve(size_t n) {
+        if (n > capacity()) grow(n);
+    }
+    
+    void push(float x1, float y1, float x2, float y2, float confidence, int class_id) {
+        if (size_ == capacity()) grow(std::max<size_t>(16, size_ * 2));
+        Storage& s = *storage_;
+        s.x1[size_] = x1;
+        s.y1[size_] = y1;
+        s.x2[size_] = x2;
+        s.y2[size_] = y2;
+        s.confidence[size_] = confidence;
+        s.class_id[size_] = class_id;
+        size_++;
+    }
+    
+    void push(const Box& box) {
+        push(box.x1, box.y1, box.x2, box.y2, box.confidence, box.class_id);
+    }
+    
+    // Box at 0-based index, no bounds check
+    Box at(size_t i) const {
+        const Storage& s = *storage_;
+        return Box(s.x1[i], s.y1[i], s.x2[i], s.y2[i], s.confidence[i], s.class_id[i]);
+    }
+    
+    /**
+     * Keep only the boxes at the given 0-based indices, which must be ascending.
+     * Boxes are moved down in place, so the storage and capacity are kept.
+     */
+    void keep(const size_t* indices, size_t n) {
+        Storage& s = *storage_;
+        for (size_t k = 0; k < n; k++) {
+            size_t i = indices[k];
+            s.x1[k] = s.x1[i];
+            s.y1[k] = s.y1[i];
+            s.x2[k] = s.x2[i];
+            s.y2[k] = s.y2[i];
+            s.confidence[k] = s.confidence[i];
+            s.class_id[k] = s.class_id[i];
+        }
+        size_ = n;
+    }
+    
+    // Columns, valid until the array grows
+    float* x1() { return storage_->x1.data(); }
+    float* y1() { return storage_->y1.data(); }
+    float* x2() { return storage_->x2.data(); }
+    float* y2() { return storage_->y2.data(); }
+    float* confidence() { return storage_->confidence.data(); }
+    int* classId() { return storage_->class_id.data(); }
+    
+    const float* x1() const { return storage_->x1.data(); }
+    const float* y1() const { return storage_->y1.data(); }
+    const float* x2() const { return storage_->x2.data(); }
+    const float* y2() const { return storage_->y2.data(); }
+    const float* confidence() const { return storage_->confidence.data(); }
+    const int* classId() const { return storage_->class_id.data(); }
+    
+    // Keeps the current column storage alive, for views of the columns
+    std::shared_ptr<void> owner() const { return storage_; }
+
+private:
+    // Columns are sized to the capacity, so every element up to it is initialized
+    struct Storage {
+        explicit Storage(size_t n) : x1(n), y1(n), x2(n), y2(n), confidence(n), class_id(n) {}
+        size_t capacity() const { return confidence.size(); }
+        
+        std::vector<float> x1, y1, x2, y2;
+        std::vector<float> confidence;
+        std::vector<int> class_id;
+    };
+    
+    void grow(size_t n) {
+        auto next = std::make_shared<Storage>(n);
+        const Storage& s = *storage_;
+        std::copy_n(s.x1.begin(), size_, next->x1.begin());
+        std::copy_n(s.y1.begin(), size_, next->y1.begin());
+        std::copy_n(s.x2.begin(), size_, next->x2.begin());
+        std::copy_n(s.y2.begin(), size_, next->y2.begin());
+        std::copy_n(s.confidence.begin(), size_, next->confidence.begin());
+        std::copy_n(s.class_id.begin(), size_, next->class_id.begin());
+        storage_ = std::move(next);
+    }
+
+private:
+    size_t size_;
+    std::shared_ptr<Storage> storage_;
+};
+
 } // namespace PostLib
@@ -0,0 +1,46 @@
+-- Benchmark CVLib pixel kernels at every instruction set level, in GB/s of bytes read and written
+-- Usage: ./phase2_cli scripts/bench_kernels.lua
+
+print("=== Benchmarking pixel kernels ===")
+
+local W, H = 1920, 1080
+local pixels = W * H
+
+local function bench(name, bytes, iterations, fn)
+    fn()   -- warm up
+    collectgarbage()
+    local start = Test.clock()
+    for _ = 1, iterations do
+        fn()
+    end
+    local sec = (Test.clock() - start) / iterations
+    print(string.format("  %-30s %8.3f ms %8.2f GB/s", name, sec * 1000, bytes / sec / 1e9))
+end
+
+local bgr = CVLib.Image(W, H, 3)
+bgr:fill(77)
+local bgra = CVLib.Image(W, H, 4)
+bgra:fill(77)
+local gray = CVLib.Image(W, H, 1)
+gray:fill(77)
+local out3 = CVLib.Image(W, H, 3)
+local out4 = CVLib.Image(W, H, 4)
+local hwc = PostLib.Tensor({H, W, 3})
+local chw = PostLib.Tensor({3, H, W})
+local iterations = 50
+
+for _, name in ipairs({"scalar", "sse", "avx2", "avx512"}) do
+    local level = CVLib.setKernelLevel(name)
+    if level == name then
+        print(string.format("\n%dx%d, %s", W, H, level))
+        bench("bgr2rgb", pixels * 6, iterations, function() CVLib.bgr2rgb(bgr, out3) end)
+        bench("bgr2rgb (4 channels)", pixels * 8, iterations, function() CVLib.bgr2rgb(bgra, out4) end)
+        bench("bgr2rgb (in place)", pixels * 6, iterations, function() CVLib.bgr2rgb(out3, out3) end)
+        bench("gray2bgr", pixels * 4, iterations, function() CVLib.gray2bgr(gray, out3) end)
+        bench("flipHorizontal", pixels * 6, iterations, function() CVLib.flipHorizontal(bgr, out3) end)
+        bench("flipVertical (in place)", pixels * 6, iterations, function() CVLib.flipVertical(out3, out3) end)
+        bench("normalize", pixels * 15, iterations, function() CVLib.normalize(bgr, hwc) end)
+        bench("hwc2chw", pixels * 15, iterations, function() CVLib.hwc2chw(bgr, chw) end)
+    end
+end
+CVLib.setKernelLevel("avx512")
@@ -0,0 +1,96 @@
+-- Benchmark PostLib YOLO decoding of a 640x640 YOLOv5 output [1, 25200, 85] and NMS
+-- Usage: ./phase2_cli scripts/bench_postprocess.lua
+
+print("=== Benchmarking postprocess ===")
+
+local N, C = 25200, 80
+local attrs = 5 + C
+
+local function bench(name, iterations, fn)
+    fn()   -- warm up
+    collectgarbage()
+    local start = Test.clock()
+    for _ = 1, iterations do
+        fn()
+    end
+    local sec = (Test.clock() - start) / iterations
+    print(string.format("  %-34s %10.1f us", name, sec * 1e6))
+end
+
+-- typical output: most rows have negative objectness logits, about 1% pass the threshold
+local output = PostLib.Tensor({1, N, attrs})
+local view = output:view()
+for row = 0, N - 1 do
+    local base = row * attrs
+    view[base + 1], view[base + 2], view[base + 3], view[base + 4] = 320, 320, 32, 32
+    view[base + 5] = (row % 100 == 0) and 3 or -6
+    view[base + 6 + row % C] = 2
+end
+
+local dense = output:clone()
+local dense_view = dense:view()
+for row = 0, N - 1 do
+    dense_view[row * attrs + 5] = 6
+end
+
+local dst = PostLib.BoxArray()
+local iterations = 100
+
+print(string.format("\n[1, %d, %d], conf 0.25", N, attrs))
+bench("parseYoloOutput (1% kept)", iterations, function() PostLib.parseYoloOutput(output, nil, dst) end)
+bench("parseYoloOutput (all kept)", iterations, function() PostLib.parseYoloOutput(dense, nil, dst) end)
+print(string.format("  kept %d boxes", #dst))
+
+-- NMS over random boxes of 80 classes, as left by a low confidence threshold
+local function randomBoxes(n)
+    local arr = PostLib.BoxArray()
+    local x = 1
+    local function rand(m)
+        x = (x * 1103515245 + 12345) % 2147483648
+        return x % m
+    end
+    for _ = 1, n do
+        local bx, by = rand(600), rand(600)
+        arr:push(bx, by, bx + 20 + rand(80), by + 20 + rand(80), rand(10000) / 10000, rand(80))
+    end
+    return arr
+end
+
+local source = randomBoxes(5000)
+local work = PostLib.BoxArray()
+local function refill()
+    work:clear()
+    for i = 1, #source do work:push(source:get(i)) end
+end
+
+for _, name in ipairs({"scalar", "avx512"}) do
+    local level = PostLib.setKernelLevel(name)
+    if level == name then
+        print(string.format("\n5000 boxes, 80 classes, %s (includes refill of the input)", level))
+        bench("refill only", 20, refill)
+        bench("nms", 20, function() refill(); PostLib.nms(work, 0.45) end)
+        bench("nms agnostic", 20, function() refill(); PostLib.nms(work, {agnostic = true}) end)
+        bench("nms agnostic, max_detections 100", 20, function()
+            refill(); PostLib.nms(work, {agnostic = true, max_detections = 100})
+        end)
+        bench("nms gaussian", 20, function() refill(); PostLib.nms(work, {method = "gaussian"}) end)
+    end
+end
+PostLib.setKernelLevel("avx512")
+
+-- nms input read: Box userdata are read from the C++ object, tables field by field
+print("\n5000 boxes, table input (includes building the table)")
+bench("createLargeBoxes (Box userdata)", 20, function() PostLib.createLargeBoxes(5000) end)
+bench("nms on Box userdata", 20, function() PostLib.nms(PostLib.createLargeBoxes(5000), 0.45) end)
+bench("toTable (box tables)", 20, function() source:toTable() end)
+bench("nms on box tables", 20, function() PostLib.nms(source:toTable(), 0.45) end)
+
+-- scaleBoxes back to a 1920x1080 frame, in place repeats map already mapped boxes, the cost is the same
+local letterbox = {pad = {top = 140, left = 0, bottom = 140, right = 0,
+                          orig_w = 1920, orig_h = 1080, new_w = 640, new_h = 360}}
+local tables = source:toTable()
+print("\n5000 boxes, scaleBoxes to 1920x1080")
+bench("scaleBoxes BoxArray (copy)", 100, function() PostLib.scaleBoxes(source, letterbox) end)
+bench("scaleBoxes BoxArray (in place)", 100, function() PostLib.scaleBoxes(work, letterbox, true) end)
+bench("scaleBoxes box tables (new tables)", 20, function() PostLib.scaleBoxes(tables, letterbox) end)
+bench("scaleBoxes box tables (in place)", 20, function() PostLib.scaleBoxes(tables, letterbox, true) end)
@@ -0,0 +1,73 @@
+-- Benchmark fused CVLib.preprocess against the four-call chain, batches, and resize modes
+-- Usage: ./phase2_cli scripts/bench_preprocess.lua
+
+print("=== Benchmarking fused preprocess ===")
+
+local function bench(name, iterations, fn)
+    fn()   -- warm up
+    collectgarbage()
+    local start = Test.clock()
+    for _ = 1, iterations do
+        fn()
+    end
+    local ms = (Test.clock() - start) * 1000 / iterations
+    print(string.format("  %-40s %8.3f ms", name, ms))
+    return ms
+end
+
+for _, size in ipairs({{640, 480}, {1920, 1080}}) do
+    local w, h = size[1], size[2]
+    print(string.format("\n%dx%d -> 640x640 NCHW", w, h))
+    local img = CVLib.Image(w, h, 3)
+    img:fill(77)
+    local iterations = 50
+
+    local chain = bench("letterbox+bgr2rgb+normalize+hwc2chw", iterations, function()
+        local lb = CVLib.letterbox(img, 640, 640)
+        local rgb = CVLib.bgr2rgb(lb.image)
+        CVLib.normalize(rgb)
+        CVLib.hwc2chw(rgb)
+    end)
+
+    local opts = {w = 640, h = 640, swapRB = true, layout = "NCHW"}
+    bench("preprocess", iterations, function()
+        CVLib.preprocess(img, opts)
+    end)
+
+    local dst = PostLib.Tensor({1, 3, 640, 640})
+    local fused = bench("preprocess (reused dst)", iterations, function()
+        CVLib.preprocess(img, opts, dst)
+    end)
+
+    print(string.format("  speedup %.1fx", chain / fused))
+end
+
+print("\n1920x1080 batch -> N x 3 x 640x640")
+local frame = CVLib.Image(1920, 1080, 3)
+frame:fill(77)
+local batch_opts = {w = 640, h = 640, swapRB = true}
+for _, n in ipairs({1, 4, 8}) do
+    local frames = {}
+    for i = 1, n do
+        frames[i] = frame
+    end
+    local dst = PostLib.Tensor({n, 3, 640, 640})
+    local ms = bench("preprocessBatch N=" .. n, 20, function()
+        CVLib.preprocessBatch(frames, batch_opts, dst)
+    end)
+    print(string.format("  %-40s %8.3f ms", "per image", ms / n))
+end
+
+for _, size in ipairs({{640, 480}, {1920, 1080}}) do
+    local w, h = size[1], size[2]
+    print(string.format("\n%dx%d resize -> 640x360", w, h))
+    local img = CVLib.Image(w, h, 3)
+    img:fill(77)
+    for _, mode in ipairs({"nearest", "bilinear", "area"}) do
+        bench("resize " .. mode, 50, function()
+            CVLib.resize(img, 640, 360, mode)
+        end)
+    end
+end
+
+print("\n✓ preprocess benchmark done")
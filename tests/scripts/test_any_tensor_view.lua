@@ -0,0 +1,101 @@
+-- Test dtype-erased AnyTensorView with runtime element type
+
+print("=== Testing AnyTensorView ===")
+
+local function near(a, b, tol) return math.abs(a - b) <= (tol or 1e-6) * math.max(1, math.abs(b)) end
+
+-- u8 elements: rounded and saturated on write, integer on read
+local u8 = Test.createAnyView("u8", 8)
+assert(u8:dtype() == "u8" and #u8 == 8, "u8 view shape mismatch")
+assert(u8:itemSize() == 1 and u8:nbytes() == 8, "u8 size mismatch")
+u8[1] = 300
+u8[2] = -5
+u8[3] = 2.4
+u8[4] = 2.6
+assert(u8[1] == 255 and u8[2] == 0, "u8 should saturate")
+assert(u8[3] == 2 and u8[4] == 3, "u8 should round to nearest")
+assert(math.type(u8[1]) == "integer", "integer dtype should read as Lua integer")
+print("✓ u8 element access")
+
+-- u8 -> f32 normalize, odd length exercises vector body and scalar tail
+local n = 1003
+local img = Test.createAnyView("u8", n)
+for i = 1, n do img[i] = (i - 1) % 256 end
+for _, level in ipairs({"scalar", "avx512"}) do
+    Test.setKernelLevel(level)
+    local input = img:convertTo("f32", 1 / 255, -0.5)
+    assert(input:dtype() == "f32" and #input == n, "convertTo shape mismatch")
+    for i = 1, n do
+        assert(near(input[i], ((i - 1) % 256) / 255 - 0.5), "u8 -> f32 mismatch at " .. i .. " (" .. level .. ")")
+    end
+end
+print("✓ u8 -> f32 conversion with scale and bias")
+
+-- f32 -> f16 -> f32 round trip, half keeps about 3 decimal digits
+local f32 = img:convertTo("f32", 0.1)
+local f16 = f32:convertTo("f16")
+assert(f16:itemSize() == 2, "f16 item size mismatch")
+for i = 1, n do
+    assert(near(f16[i], f32[i], 1e-3), "f16 round trip mismatch at " .. i)
+end
+f16[1] = 70000
+assert(f16[1] == math.huge, "f16 overflow should be inf")
+assert(f16:sum() == math.huge, "f16 sum should include inf")
+f16[1] = 0
+assert(near(f16:sum(), f32:sum() - f32[1], 1e-3), "f16 sum mismatch")
+assert(f16:max() == f16[256] and f16:min() == 0, "f16 min/max mismatch")
+print("✓ f16 conversion")
+
+-- f32 -> i8 quantize saturates
+local q = f32:convertTo("i8", 10)
+assert(q[2] == 1 and q[11] == 10 and q[256] == 127, "i8 quantize mismatch")
+assert(img:convertTo("i32"):sum() == img:sum(), "i32 sum mismatch")
+assert(img:min() == 0 and img:max() == 255, "u8 min/max mismatch")
+print("✓ quantize to integer dtype")
+
+-- Integer outputs are identical at every kernel level: v * 0.7 + 3 hits rounding ties
+-- (e.g. -25, -93625) that a fused multiply-add would round differently
+local ints = {i8 = Test.createAnyView("i8", 256), i32 = Test.createAnyView("i32", 4003)}
+for i = 1, 256 do ints.i8[i] = i - 129 end
+for i = 1, 4001 do ints.i32[i] = i - 2001 end
+ints.i32[4002], ints.i32[4003] = -93625, -46815
+local reference = {}
+for _, level in ipairs({"scalar", "sse", "avx2", "avx512"}) do
+    local used = Test.setKernelLevel(level)
+    for _, pair in ipairs({{"i8", "i8"}, {"i8", "i32"}, {"i32", "i8"}, {"i32", "i32"}}) do
+        local src, out = ints[pair[1]], ints[pair[1]]:convertTo(pair[2], 0.7, 3)
+        local id = pair[1] .. "->" .. pair[2]
+        reference[id] = reference[id] or out
+        for i = 1, #src do
+            assert(out[i] == reference[id][i], id .. " differs at level " .. used .. " for " .. src[i])
+        end
+    end
+end
+Test.setKernelLevel("avx512")
+print("✓ integer conversion equal at every kernel level")
+
+-- One signature accepts AnyTensorView and typed views
+assert(Test.tensorInfo(img) == "u8[1003]", "tensorInfo(AnyTensorView) mismatch")
+local fv = Test.createFloatView(10, 1.5)
+assert(Test.tensorInfo(fv) == "f32[10]", "tensorInfo(FloatTensorView) mismatch")
+local d = Test.createAnyView("f64", 10)
+d:convertFrom(fv, 2, 1)
+assert(d[10] == 4, "convertFrom typed view mismatch")
+d:fill(-1)
+local back = Test.createAnyView("f32", 10)
+back:convertFrom(d)
+assert(back[1] == -1 and back:sum() == -10, "f64 -> f32 mismatch")
+print("✓ typed views accepted as AnyTensorView")
+
+-- Errors
+local ok, err = pcall(function() return Test.createAnyView("f8", 1) end)
+assert(not ok and err:find("unknown dtype"), "unknown dtype should fail")
+ok, err = pcall(function() d:convertFrom(img) end)
+assert(not ok and err:find("length mismatch"), "length mismatch should fail")
+ok, err = pcall(function() return Test.tensorInfo({}) end)
+assert(not ok and err:find("expected"), "table should not be accepted as tensor")
+ok, err = pcall(function() return u8[9] end)
+assert(not ok and err:find("out of range"), "index out of range should fail")
+print("✓ error handling")
+
+print("✓ AnyTensorView test PASSED")
@@ -0,0 +1,110 @@
+-- Test PostLib.BoxArray packed detections and PostLib functions accepting it
+
+print("=== Testing BoxArray ===")
+
+local function near(a, b, eps)
+    return math.abs(a - b) < (eps or 1e-4)
+end
+
+local function makeTable()
+    return {
+        {x1 = 100, y1 = 100, x2 = 200, y2 = 200, confidence = 0.9, class_id = 0},
+        {x1 = 110, y1 = 110, x2 = 210, y2 = 210, confidence = 0.8, class_id = 0},  -- suppressed by box 1
+        {x1 = 300, y1 = 300, x2 = 400, y2 = 400, confidence = 0.85, class_id = 1},
+        {x1 = 105, y1 = 105, x2 = 205, y2 = 205, confidence = 0.7, class_id = 2},  -- other class, kept
+    }
+end
+
+-- Test 1: push, #arr and get
+print("\n1. Testing push and get...")
+local arr = PostLib.BoxArray()
+assert(#arr == 0, "New BoxArray should be empty")
+arr:push(10, 20, 30, 40, 0.5, 7)
+arr:push(1, 2, 3, 4, 0.25, 3)
+assert(#arr == 2, "Expected 2 boxes")
+local x1, y1, x2, y2, conf, cls = arr:get(1)
+assert(x1 == 10 and y1 == 20 and x2 == 30 and y2 == 40, "get coordinates mismatch")
+assert(conf == 0.5 and cls == 7, "get confidence/class mismatch")
+assert(select(6, arr:get(2)) == 3, "get(2) class mismatch")
+local ok, err = pcall(arr.get, arr, 3)
+assert(not ok and err:find("out of range"), "get past end should fail")
+ok = pcall(arr.get, arr, 0)
+assert(not ok, "get(0) should fail")
+print("✓ push/get work")
+
+-- Test 2: column views
+print("\n2. Testing column views...")
+local xs = arr:column("x1")
+assert(#xs == 2 and xs[1] == 10 and xs[2] == 1, "x1 column mismatch")
+xs[2] = 5
+assert(arr:get(2) == 5, "Column writes should reach the array")
+assert(arr:column("confidence"):max() == 0.5, "confidence column max mismatch")
+local ids = arr:classIds()
+assert(#ids == 2 and ids[1] == 7 and ids[2] == 3, "classIds mismatch")
+ok, err = pcall(arr.column, arr, "width")
+assert(not ok and err:find("unknown column"), "Unknown column should fail")
+print("✓ Column views work")
+
+-- Test 3: views stay valid when the array grows
+print("\n3. Testing view lifetime...")
+local ys = arr:column("y1")
+for i = 1, 1000 do
+    arr:push(i, i, i + 1, i + 1, 0.1, 0)
+end
+assert(#arr == 1002 and arr:capacity() >= 1002, "Array should have grown")
+assert(#ys == 2 and ys[1] == 20 and ys[2] == 2, "Old view should keep its values")
+assert(#arr:column("y1") == 1002, "New view should see all boxes")
+ys = nil
+collectgarbage()
+arr:clear()
+assert(#arr == 0 and arr:capacity() >= 1002, "clear should keep capacity")
+print("✓ Views survive growth")
+
+-- Test 4: toTable and fromTable round trip
+print("\n4. Testing toTable/fromTable...")
+local packed = PostLib.BoxArray.fromTable(makeTable())
+assert(#packed == 4, "fromTable should read 4 boxes")
+local back = packed:toTable()
+assert(#back == 4 and back[3].x1 == 300 and back[3].class_id == 1, "toTable mismatch")
+local camel = PostLib.BoxArray.fromTable({{x1 = 1, y1 = 2, x2 = 3, y2 = 4, confidence = 0.5, classId = 9}})
+assert(select(6, camel:get(1)) == 9, "fromTable should accept classId")
+print("✓ Round trip works")
+
+-- Test 5: nms on BoxArray matches nms on tables
+print("\n5. Testing nms with BoxArray...")
+local boxes = makeTable()
+PostLib.nms(boxes, 0.45)
+PostLib.nms(packed, 0.45)
+assert(#packed == #boxes and #packed == 3, "Expected 3 boxes after NMS, got " .. #packed)
+for i = 1, #boxes do
+    local bx1, _, _, _, bconf, bcls = packed:get(i)
+    assert(bx1 == boxes[i].x1 and near(bconf, boxes[i].confidence) and bcls == boxes[i].class_id,
+        "NMS result mismatch at " .. i)
+end
+print("✓ nms filters BoxArray in place")
+
+-- Test 6: scaleBoxes on BoxArray
+print("\n6. Testing scaleBoxes with BoxArray...")
+local pad_info = {top = 80, left = 0, bottom = 80, right = 0}
+local scaled_table = PostLib.scaleBoxes(makeTable(), 1280, 960, 640, 640, pad_info)
+local source = PostLib.BoxArray.fromTable(makeTable())
+local scaled = PostLib.scaleBoxes(source, 1280, 960, 640, 640, pad_info)
+assert(scaled ~= source and #scaled == 4, "scaleBoxes should return a new BoxArray")
+assert(source:get(1) == 100, "Source BoxArray should be unchanged")
+for i = 1, #scaled do
+    local sx1, sy1, sx2, sy2 = scaled:get(i)
+    local t = scaled_table[i]
+    assert(near(sx1, t.x1) and near(sy1, t.y1) and near(sx2, t.x2) and near(sy2, t.y2),
+        "scaleBoxes mismatch at " .. i)
+end
+print("✓ scaleBoxes returns scaled BoxArray")
+
+-- Test 7: createLargeBoxes fills a BoxArray
+print("\n7. Testing createLargeBoxes with BoxArray...")
+local large = PostLib.BoxArray()
+assert(PostLib.createLargeBoxes(100, large) == large, "dst should be returned")
+assert(#large == 100 and select(6, large:get(51)) == 0 and large:get(51) == 500, "createLargeBoxes mismatch")
+assert(#PostLib.createLargeBoxes(10) == 10, "Table form should still work")
+print("✓ createLargeBoxes fills BoxArray")
+
+print("\n✓ BoxArray test PASSED")
@@ -0,0 +1,114 @@
+-- Test size-bucketed image buffer pool: reuse, zero fill, limits and advice
+
+print("=== Testing image buffer pool ===")
+
+-- Stats changes since before
+local function delta(before)
+    local now = CVLib.bufferPoolStats()
+    return {
+        hits = now.hits - before.hits,
+        misses = now.misses - before.misses,
+        retainedBytes = now.retainedBytes,
+        retainedBuffers = now.retainedBuffers,
+    }
+end
+
+-- Test 1: default allocator is a pool
+print("\n1. Default pool...")
+local stats = CVLib.bufferPoolStats()
+assert(stats ~= nil, "Images should use a pool by default")
+assert(stats.hits >= 0 and stats.misses >= 0, "Stats should be counters")
+print("✓ default pool active")
+
+-- Test 2: released buffer is reused by the next image of the same size
+print("\n2. Reuse after release...")
+CVLib.setBufferPool({})
+local before = CVLib.bufferPoolStats()
+local img = CVLib.Image(320, 240, 3)
+img:fill(200)
+img:release()
+local d = delta(before)
+assert(d.misses == 1 and d.hits == 0, "First image should miss")
+assert(d.retainedBytes == 320 * 240 * 3 and d.retainedBuffers == 1, "Released buffer should be retained")
+
+local again = CVLib.Image(320, 240, 3)
+d = delta(before)
+assert(d.hits == 1 and d.retainedBuffers == 0, "Same size should hit")
+assert(again:at(10, 10, 0) == 0 and again:at(239, 319, 2) == 0, "Reused buffer should be zero filled")
+print("✓ buffer reused and zero filled")
+
+-- Test 3: buckets are keyed by byte size, not shape
+print("\n3. Size buckets...")
+again:release()
+before = CVLib.bufferPoolStats()
+local other = CVLib.Image(240, 320, 3)
+d = delta(before)
+assert(d.hits == 1, "Same byte size with other shape should hit")
+local small = CVLib.Image(32, 32, 1)
+d = delta(before)
+assert(d.misses == 1, "Other size should miss")
+other:release()
+small:release()
+print("✓ keyed by byte size")
+
+-- Test 4: transform results draw from the pool
+print("\n4. Transforms...")
+local frame = CVLib.Image(64, 48, 3)
+local flipped = CVLib.flipHorizontal(frame)
+flipped:release()
+before = CVLib.bufferPoolStats()
+for i = 1, 10 do
+    local out = CVLib.flipHorizontal(frame)
+    out:release()
+end
+d = delta(before)
+assert(d.hits == 10 and d.misses == 0, "Per-frame results should reuse one buffer")
+print("✓ transforms reuse buffers")
+
+-- Test 5: retained bytes are limited by maxBytes
+print("\n5. maxBytes...")
+CVLib.setBufferPool({maxBytes = 1000})
+local a = CVLib.Image(20, 20, 1)
+local b = CVLib.Image(20, 20, 1)
+local c = CVLib.Image(20, 20, 1)
+a:release()
+b:release()
+c:release()
+stats = CVLib.bufferPoolStats()
+assert(stats.retainedBuffers == 2 and stats.retainedBytes == 800, "Only 800 of 1200 bytes should be retained")
+CVLib.clearBufferPool()
+stats = CVLib.bufferPoolStats()
+assert(stats.retainedBuffers == 0 and stats.retainedBytes == 0, "clear should free retained buffers")
+print("✓ maxBytes respected, clear works")
+
+-- Test 6: advice options
+print("\n6. Advice...")
+for _, advice in ipairs({"none", "hugepage", "populate"}) do
+    CVLib.setBufferPool({advice = advice})
+    local big = CVLib.Image(1280, 720, 3)
+    assert(big:at(719, 1279, 2) == 0, advice .. " buffer should be zero filled")
+    big:fill(1)
+    big:release()
+    local reuse = CVLib.Image(1280, 720, 3)
+    assert(CVLib.bufferPoolStats().hits == 1, advice .. " buffer should be reused")
+    assert(reuse:at(0, 0, 0) == 0, advice .. " reused buffer should be zero filled")
+end
+assert(not pcall(CVLib.setBufferPool, {advice = "huge"}), "Unknown advice should fail")
+assert(not pcall(CVLib.setBufferPool, {maxBytes = -1}), "Negative maxBytes should fail")
+print("✓ advice options work")
+
+-- Test 7: pool can be disabled, existing images stay valid
+print("\n7. Heap allocator...")
+local kept = CVLib.Image(16, 16, 3)
+kept:fill(9)
+CVLib.setBufferPool(nil)
+assert(CVLib.bufferPoolStats() == nil, "No stats without pool")
+local plain = CVLib.Image(16, 16, 3)
+assert(plain:at(15, 15, 2) == 0, "Heap image should be zero filled")
+assert(kept:at(15, 15, 2) == 9, "Image from old pool should stay valid")
+kept:release()
+plain:release()
+CVLib.setBufferPool({})
+print("✓ pool can be disabled")
+
+print("\n✓ Image buffer pool test PASSED")
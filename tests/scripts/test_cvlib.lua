@@ -30,11 +30,23 @@ assert(result.pad.top ~= nil, "pad should have top field")
 assert(result.pad.left ~= nil, "pad should have left field")
 print("✓ letterbox works: padded to 640x640, pad={top=" .. result.pad.top .. ", left=" .. result.pad.left .. "}")
 
+-- Tensor stores float32, compare with tolerance
+local function near(a, b)
+    return math.abs(a - b) < 1e-5
+end
+
 -- Test 4: normalize
 print("\n4. Testing normalize...")
 local tensor_data = CVLib.normalize(result.image)
 assert(tensor_data ~= nil, "normalize should return data")
 assert(#tensor_data == 640 * 640 * 3, "Normalized data should have correct size")
+local shape = tensor_data:getShape()
+assert(shape[1] == 640 and shape[2] == 640 and shape[3] == 3, "Normalized shape should be {H, W, 3}")
+-- padding pixel is gray 114 in every channel
+local hwc = tensor_data:view()
+assert(near(hwc[1], (114 / 255 - 0.485) / 0.229), "Channel 0 should use mean/std of channel 0")
+assert(near(hwc[2], (114 / 255 - 0.456) / 0.224), "Channel 1 should use mean/std of channel 1")
+assert(near(hwc[3], (114 / 255 - 0.406) / 0.225), "Channel 2 should use mean/std of channel 2")
 print("✓ normalize works: " .. #tensor_data .. " elements")
 
 -- Test 5: hwc2chw
@@ -42,6 +54,26 @@ print("\n5. Testing hwc2chw...")
 local chw_data = CVLib.hwc2chw(result.image)
 assert(chw_data ~= nil, "hwc2chw should return data")
 assert(#chw_data == 640 * 640 * 3, "CHW data should have correct size")
+local chw_shape = chw_data:getShape()
+assert(chw_shape[1] == 3 and chw_shape[2] == 640 and chw_shape[3] == 640, "CHW shape should be {3, H, W}")
+local chw = chw_data:view()
+local plane = 640 * 640
+for _, p in ipairs({0, 1, 640 * 320 + 17, plane - 1}) do
+    for c = 0, 2 do
+        assert(near(chw[c * plane + p + 1], hwc[p * 3 + c + 1]), "CHW should match HWC at pixel " .. p)
+    end
+end
 print("✓ hwc2chw works: " .. #chw_data .. " elements")
 
+-- Test 6: caller supplied output is reused
+print("\n6. Testing dst reuse...")
+local dst = PostLib.Tensor({1, 3, 640, 640})
+local out = CVLib.hwc2chw(result.image, dst)
+assert(rawequal(out, dst), "hwc2chw should return dst")
+assert(near(dst:at(plane), chw[plane + 1]), "dst should hold CHW data")
+local view_dst = dst:view()
+assert(rawequal(CVLib.normalize(result.image, view_dst), view_dst), "normalize should return dst view")
+assert(near(dst:at(1), hwc[2]), "dst view should hold HWC data")
+print("✓ dst reuse works")
+
 print("\n=== CVLib Module: ALL TESTS PASSED ===")
@@ -45,33 +45,43 @@ end)
 test("normalize with empty image", function()
     local img = CVLib.Image(0, 0)
     local data = CVLib.normalize(img)
-    assert(type(data) == "table", "normalize should return table")
-    assert(#data == 0, "normalized empty image should be empty table")
+    assert(data:empty(), "normalized empty image should be empty tensor")
+    assert(#data == 0, "normalized empty image should have no elements")
 end)
 
 test("normalize with valid small image", function()
     local img = CVLib.Image(2, 2, 3)
     img:fill(128)  -- Fill with gray
     local data = CVLib.normalize(img)
-    assert(type(data) == "table", "normalize should return table")
     assert(#data == 2 * 2 * 3, "normalized data size should be W*H*C")
 end)
 
 test("hwc2chw with empty image", function()
     local img = CVLib.Image(0, 0)
     local data = CVLib.hwc2chw(img)
-    assert(type(data) == "table", "hwc2chw should return table")
-    assert(#data == 0, "hwc2chw empty image should be empty table")
+    assert(data:empty(), "hwc2chw empty image should be empty tensor")
+    assert(#data == 0, "hwc2chw empty image should have no elements")
 end)
 
 test("hwc2chw with valid small image", function()
     local img = CVLib.Image(2, 2, 3)
     img:fill(100)
     local data = CVLib.hwc2chw(img)
-    assert(type(data) == "table", "hwc2chw should return table")
     assert(#data == 2 * 2 * 3, "hwc2chw data size should be W*H*C")
 end)
 
+test("normalize rejects dst of wrong size", function()
+    local img = CVLib.Image(2, 2, 3)
+    local ok = pcall(CVLib.normalize, img, PostLib.Tensor({2, 2, 2}))
+    assert(not ok, "normalize should reject dst with wrong element count")
+end)
+
+test("hwc2chw rejects non 3-channel image", function()
+    local img = CVLib.Image(2, 2, 1)
+    local ok = pcall(CVLib.hwc2chw, img)
+    assert(not ok, "hwc2chw should reject 1-channel image")
+end)
+
 -- ============= PostLib Edge Cases =============
 
 test("Empty box list", function()
@@ -0,0 +1,41 @@
+-- Test external memory pressure reporting (Image pixel buffers)
+
+print("=== Testing external memory accounting ===")
+
+local gc = Test.GCPolicy()
+collectgarbage("collect")
+local base = gc:externalMemory()
+
+-- Live images are charged with their pixel buffer size
+local img = CVLib.Image(640, 480, 3)
+assert(gc:externalMemory() == base + 640 * 480 * 3, "Image buffer should be charged")
+
+-- Collected images are uncharged
+img = nil
+collectgarbage("collect")
+assert(gc:externalMemory() == base, "Collected image should be uncharged")
+
+-- Dead images must be reclaimed while the loop runs, not at exit:
+-- 300 frames of 640x480x3 would hold ~276 MB without accounting
+local peak = 0
+for frame = 1, 300 do
+    local frame_img = CVLib.imread("frame.jpg")
+    local copy = frame_img:clone()
+    peak = math.max(peak, gc:externalMemory())
+end
+print(string.format("Peak external memory: %.1f MB", peak / 1e6))
+assert(peak < 64 * 1024 * 1024, "External memory should stay bounded")
+
+-- With the collector stopped the debt is deferred to policy steps
+gc:stop()
+for i = 1, 20 do
+    local tmp = CVLib.Image(640, 480, 3)
+end
+local held = gc:externalMemory()
+assert(held >= 20 * 640 * 480 * 3, "Stopped GC should not collect images")
+while not gc:step(1) do end
+while not gc:step(1) do end
+assert(gc:externalMemory() < held, "Policy step should reclaim deferred images")
+gc:restart()
+
+print("✓ External memory test PASSED")
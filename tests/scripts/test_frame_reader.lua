@@ -0,0 +1,123 @@
+-- Test PPM/PGM/Y4M/raw decoding: imread and memory-mapped FrameReader streams
+
+print("=== Testing frame reader ===")
+
+local function writeFile(path, ...)
+    local f = assert(io.open(path, "wb"))
+    f:write(...)
+    f:close()
+end
+
+-- w x h bytes with value (base + i) % 256, i counts from 0 in file order
+local function bytes(n, base)
+    local t = {}
+    for i = 0, n - 1 do
+        t[#t + 1] = string.char((base + i) % 256)
+    end
+    return table.concat(t)
+end
+
+local tmp = os.tmpname()
+
+-- Test 1: imread decodes PPM as BGR
+print("\n1. imread PPM...")
+local ppm = tmp .. ".ppm"
+writeFile(ppm, "P6\n# comment\n4 3\n255\n", bytes(4 * 3 * 3, 0))
+local img = CVLib.imread(ppm)
+assert(img.width == 4 and img.height == 3 and img.channels == 3, "PPM should be 4x3x3")
+assert(img:at(0, 0, 0) == 2 and img:at(0, 0, 2) == 0, "PPM RGB should become BGR")
+assert(img:at(2, 3, 1) == 34, "Last pixel green should be 34")
+print("✓ PPM decoded")
+
+-- Test 2: imread PGM gives gray as BGR, unsupported files fail
+print("\n2. imread PGM...")
+local pgm = tmp .. ".pgm"
+writeFile(pgm, "P5 5 2 255\n", bytes(10, 100))
+local gray = CVLib.imread(pgm)
+assert(gray.channels == 3 and gray:at(1, 4, 0) == 109 and gray:at(1, 4, 2) == 109, "PGM should expand to BGR")
+writeFile(pgm, "P5 5 2 65535\n", bytes(20, 0))
+assert(not pcall(CVLib.imread, pgm), "16-bit PGM should fail")
+writeFile(pgm, "P5 5 2 255\n", bytes(7, 0))
+assert(not pcall(CVLib.imread, pgm), "Truncated PGM should fail")
+assert(not pcall(CVLib.imread, tmp .. "_missing.ppm"), "Missing PPM should fail")
+print("✓ PGM decoded, invalid files rejected")
+
+-- Test 3: concatenated PPM stream, frames alias the mapping
+print("\n3. PPM stream...")
+writeFile(ppm, "P6 2 2 255\n", bytes(12, 0), "\nP6 2 2 255\n", bytes(12, 50))
+local reader = CVLib.openFrames(ppm)
+assert(reader.count == 2 and #reader == 2 and reader:format() == "pnm", "Stream should have 2 PNM frames")
+assert(reader.width == 2 and reader.height == 2 and reader.channels == 3, "Frames should be 2x2x3")
+local first = reader:next()
+local second = reader:next()
+assert(reader:next() == nil and reader.position == 2, "next should return nil at end")
+assert(first:at(0, 0, 0) == 0 and second:at(0, 0, 0) == 50, "Frames should be RGB as stored")
+local copy = second:clone()
+second:set(0, 0, 0, 1)
+assert(second:at(0, 0, 0) == 1 and copy:at(0, 0, 0) == 50, "Writing a frame should copy it")
+assert(reader:frame(1):at(0, 0, 0) == 50, "File pages should be unchanged")
+reader:seek(1)
+assert(reader:next():at(1, 1, 2) == 61, "seek should move the stream")
+assert(not pcall(reader.frame, reader, 2), "Frame index out of range should fail")
+print("✓ PPM stream works")
+
+-- Test 4: Y4M luma frames and BGR conversion
+print("\n4. Y4M...")
+local y4m = tmp .. ".y4m"
+local frames = {}
+for k = 0, 2 do
+    -- 4x2 4:2:0: 8 luma, 2 U, 2 V
+    frames[#frames + 1] = "FRAME\n" .. bytes(8, 16 + k * 10) .. string.char(128, 128, 128, 128)
+end
+writeFile(y4m, "YUV4MPEG2 W4 H2 F30:1 Ip A1:1 C420jpeg\n", table.concat(frames))
+local video = CVLib.openFrames(y4m)
+assert(video.count == 3 and video:format() == "y4m" and video.channels == 1, "Y4M should give 3 luma frames")
+assert(video:frame(2):at(1, 3, 0) == 16 + 20 + 7, "Luma plane should be aliased")
+local color = CVLib.openFrames(y4m, {bgr = true})
+assert(color.channels == 3, "bgr option should give 3 channels")
+local black = color:frame(0)
+assert(black:at(0, 0, 0) == 0 and black:at(0, 0, 1) == 0 and black:at(0, 0, 2) == 0, "Y=16 should be black")
+local mid = CVLib.imread(y4m)
+assert(mid.channels == 3 and mid:at(1, 3, 1) == 8, "imread of Y4M should give first frame as BGR")
+writeFile(y4m, "YUV4MPEG2 W4 H2 C420p10\nFRAME\n", bytes(24, 0))
+assert(not pcall(CVLib.openFrames, y4m), "10-bit Y4M should fail")
+writeFile(y4m, "YUV4MPEG2 W2147483647 H2 C420jpeg\nFRAME\n", bytes(24, 0))
+assert(not pcall(CVLib.openFrames, y4m), "Oversized Y4M width should fail")
+writeFile(y4m, "YUV4MPEG2 W-4 H2 C420jpeg\nFRAME\n", bytes(24, 0))
+assert(not pcall(CVLib.openFrames, y4m), "Negative Y4M width should fail")
+print("✓ Y4M works")
+
+-- Test 5: raw frames need a size
+print("\n5. Raw frames...")
+local raw = tmp .. ".raw"
+writeFile(raw, bytes(3 * 2 * 2 * 4, 0))
+local rr = CVLib.openFrames(raw, {width = 3, height = 2, channels = 2})
+assert(rr.count == 4 and rr:format() == "raw" and rr:frame(3):at(0, 0, 1) == 37, "Raw should give 4 frames")
+assert(not pcall(CVLib.openFrames, raw), "Raw without size should fail")
+assert(not pcall(CVLib.openFrames, raw, {width = 5, height = 2}), "Size not dividing file should fail")
+local kept = rr:frame(1)
+rr = nil
+collectgarbage()
+assert(kept:at(0, 0, 0) == 12, "Frames should keep the mapping alive")
+print("✓ raw frames work")
+
+-- Test 6: frames feed the pipeline
+print("\n6. Frames in the pipeline...")
+writeFile(raw, bytes(64 * 48 * 3 * 2, 0))
+local stream = CVLib.openFrames(raw, {width = 64, height = 48, readahead = 4096})
+local n = 0
+while true do
+    local frame = stream:next()
+    if not frame then break end
+    local out = CVLib.preprocess(frame, {w = 32, h = 32})
+    assert(out.tensor:getShape()[4] == 32, "preprocess of mapped frame")
+    n = n + 1
+end
+assert(n == 2, "Should replay 2 frames")
+print("✓ frames work in the pipeline")
+
+for _, path in ipairs({tmp, ppm, pgm, y4m, raw}) do
+    os.remove(path)
+end
+
+print("\n✓ Frame reader test PASSED")
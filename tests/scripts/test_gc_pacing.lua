@@ -0,0 +1,57 @@
+-- Test GC pacing with per-frame step budgets
+
+print("=== Testing GC pacing ===")
+
+local gc = Test.GCPolicy()
+assert(gc:isRunning(), "GC should be running by default")
+
+-- Stop automatic collection, garbage must pile up
+gc:stop()
+assert(not gc:isRunning(), "GC should be stopped")
+
+local before = gc:memoryInUse()
+for frame = 1, 20 do
+    local garbage = {}
+    for i = 1, 2000 do
+        garbage[i] = { i, tostring(i) }
+    end
+end
+local grown = gc:memoryInUse()
+print("Memory before/after frames:", before, grown)
+assert(grown > before, "Memory should grow while GC is stopped")
+
+-- Pay the debt in small time-boxed steps
+gc:setStepSize(64)
+local steps, finished = 0, false
+while not finished and steps < 10000 do
+    finished = gc:step(0.5)
+    steps = steps + 1
+end
+print("Frames to finish cycle:", steps)
+assert(finished, "GC cycle should finish within step budget loop")
+assert(gc:memoryInUse() < grown, "Stepping should reclaim memory")
+assert(not gc:isRunning(), "Stepping must not restart GC")
+assert(gc:pauseCount() >= steps, "Every step should be recorded")
+
+-- Pause histogram
+gc:collect()
+local p50, p99 = gc:percentileUs(0.5), gc:percentileUs(0.99)
+print(string.format("Pauses: %d, p50 <= %.0fus, p99 <= %.0fus, max %.0fus",
+    gc:pauseCount(), p50, p99, gc:maxPauseUs()))
+assert(p50 <= p99 and p99 <= gc:maxPauseUs(), "Percentiles should be ordered")
+
+gc:resetStats()
+assert(gc:pauseCount() == 0, "Stats should be cleared")
+
+-- Mode switching
+local ok = pcall(function() gc:setGenerational() end)
+if ok then
+    assert(gc:isGenerational(), "Mode should be generational")
+end
+gc:setIncremental(200, 100)
+assert(not gc:isGenerational(), "Mode should be incremental")
+
+gc:restart()
+assert(gc:isRunning(), "GC should be running again")
+
+print("✓ GC pacing test PASSED")
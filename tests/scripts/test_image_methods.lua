@@ -65,4 +65,53 @@ assert(flipped_v.width == original.width, "Width should be preserved")
 assert(flipped_v.height == original.height, "Height should be preserved")
 print("✓ flipVertical() works")
 
+-- Test 9: transforms into caller provided dst
+print("\n9. Testing dst arguments...")
+local rgb = CVLib.Image(640, 480, 3)
+assert(rawequal(CVLib.bgr2rgb(original, rgb), rgb), "bgr2rgb should return dst")
+assert(rgb:at(10, 20, 0) == original:at(10, 20, 2), "bgr2rgb dst should hold swapped channels")
+local crop_dst = CVLib.Image(200, 200, 3)
+assert(rawequal(CVLib.crop(original, 100, 100, 200, 200, crop_dst), crop_dst), "crop should return dst")
+assert(crop_dst:at(5, 7, 1) == original:at(105, 107, 1), "crop dst should hold region")
+local resize_dst = CVLib.Image(320, 240, 3)
+assert(rawequal(CVLib.resize(original, 320, 240, nil, resize_dst), resize_dst), "resize should return dst")
+assert(resize_dst:at(3, 4, 2) == resized:at(3, 4, 2), "resize dst should match new image")
+local flip_dst = CVLib.Image(640, 480, 3)
+CVLib.flipHorizontal(original, flip_dst)
+assert(flip_dst:at(0, 639, 1) == original:at(0, 0, 1), "flipHorizontal dst should be mirrored")
+CVLib.flipVertical(original, flip_dst)
+assert(flip_dst:at(479, 0, 0) == original:at(0, 0, 0), "flipVertical dst should be mirrored")
+local gray = CVLib.Image(4, 2, 1)
+gray:fill(9)
+local bgr = CVLib.Image(4, 2, 3)
+assert(rawequal(CVLib.gray2bgr(gray, bgr), bgr) and bgr:at(1, 3, 2) == 9, "gray2bgr should fill dst")
+print("✓ dst arguments work")
+
+-- Test 10: in-place transforms
+print("\n10. Testing in-place transforms...")
+local work = original:clone()
+CVLib.bgr2rgb(work, work)
+assert(work:at(10, 20, 0) == original:at(10, 20, 2) and work:at(10, 20, 2) == original:at(10, 20, 0),
+    "bgr2rgb in place should swap channels")
+work = original:clone()
+CVLib.flipHorizontal(work, work)
+assert(work:at(7, 0, 1) == original:at(7, 639, 1) and work:at(7, 639, 1) == original:at(7, 0, 1),
+    "flipHorizontal in place should mirror rows")
+CVLib.flipHorizontal(work, work)
+assert(work:at(7, 100, 1) == original:at(7, 100, 1), "Flipping twice should restore")
+work = original:clone()
+CVLib.flipVertical(work, work)
+assert(work:at(0, 5, 0) == original:at(479, 5, 0) and work:at(479, 5, 0) == original:at(0, 5, 0),
+    "flipVertical in place should reverse rows")
+print("✓ in-place transforms work")
+
+-- Test 11: wrong dst is rejected
+print("\n11. Testing dst validation...")
+assert(not pcall(CVLib.bgr2rgb, original, CVLib.Image(10, 10, 3)), "Wrong size dst should fail")
+assert(not pcall(CVLib.crop, original, 0, 0, 20, 20, CVLib.Image(20, 20, 1)), "Wrong channel dst should fail")
+assert(not pcall(CVLib.resize, original, 640, 480, "bilinear", original), "resize into source should fail")
+assert(not pcall(CVLib.gray2bgr, original), "gray2bgr of color image should fail")
+assert(not pcall(CVLib.crop, original, 600, 0, 100, 10), "Out of bounds crop should fail")
+print("✓ dst validation works")
+
 print("\n=== Image Class Methods: ALL TESTS PASSED ===")
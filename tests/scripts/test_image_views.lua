@@ -0,0 +1,165 @@
+-- Test copy-on-write clones, ROI views with row stride, and row/plane/pixels views
+
+print("=== Testing image views and copy-on-write ===")
+
+-- Image with value (x * 16 + y * 4 + c) % 256 at (y, x, c)
+local function pattern(w, h, c)
+    local img = CVLib.Image(w, h, c)
+    for y = 0, h - 1 do
+        for x = 0, w - 1 do
+            for ch = 0, c - 1 do
+                img:set(y, x, ch, (x * 16 + y * 4 + ch) % 256)
+            end
+        end
+    end
+    return img
+end
+
+local function same(a, b)
+    if a.width ~= b.width or a.height ~= b.height or a.channels ~= b.channels then
+        return false
+    end
+    for y = 0, a.height - 1 do
+        for x = 0, a.width - 1 do
+            for c = 0, a.channels - 1 do
+                if a:at(y, x, c) ~= b:at(y, x, c) then return false end
+            end
+        end
+    end
+    return true
+end
+
+-- Test 1: clone shares pixels until one side is written
+print("\n1. Copy-on-write clone...")
+local img = pattern(40, 30, 3)
+local copy = img:clone()
+assert(not copy:aliases(img), "Clone should not alias the source")
+assert(same(copy, img), "Clone should have the same pixels")
+copy:set(1, 1, 0, 250)
+assert(copy:at(1, 1, 0) == 250 and img:at(1, 1, 0) == 20, "Writing the clone should not change the source")
+local copy2 = img:clone()
+img:fill(7)
+assert(copy2:at(2, 3, 1) == 57 and img:at(2, 3, 1) == 7, "Writing the source should not change the clone")
+print("✓ clone detaches on write")
+
+-- Test 2: roi is a view with the parent stride, writes go through
+print("\n2. ROI view...")
+img = pattern(40, 30, 3)
+local view = img:roi(10, 5, 8, 6)
+assert(view.width == 8 and view.height == 6 and view.channels == 3, "View should be 8x6x3")
+assert(view.stride == 40 * 3 and not view.continuous, "View should keep the parent stride")
+assert(img.continuous and img.stride == 120, "Full image should be continuous")
+assert(view:aliases(img), "View should alias its parent")
+assert(view:at(0, 0, 0) == img:at(5, 10, 0) and view:at(5, 7, 2) == img:at(10, 17, 2), "View should see parent pixels")
+view:fill(9)
+assert(img:at(5, 10, 0) == 9 and img:at(10, 17, 2) == 9, "fill on view should write the region")
+assert(img:at(4, 10, 0) ~= 9 and img:at(5, 18, 0) ~= 9 and img:at(11, 17, 0) ~= 9, "fill on view should stay inside")
+assert(not pcall(img.roi, img, 35, 0, 10, 1), "Out of bounds roi should fail")
+print("✓ roi views work")
+
+-- Test 3: crop view and copy
+print("\n3. crop view...")
+img = pattern(40, 30, 3)
+local cropped = CVLib.crop(img, 10, 5, 8, 6, true)
+assert(cropped:aliases(img) and cropped.stride == 120, "crop(..., true) should return a view")
+local copied = CVLib.crop(img, 10, 5, 8, 6)
+assert(not copied:aliases(img) and copied.continuous, "crop should copy by default")
+assert(same(cropped, copied), "crop view and copy should match")
+cropped:set(0, 0, 0, 1)
+assert(img:at(5, 10, 0) == 1 and copied:at(0, 0, 0) ~= 1, "Writes through crop view should reach the parent only")
+print("✓ crop views work")
+
+-- Test 4: kernels honor stride of views
+print("\n4. Kernels on views...")
+img = pattern(50, 40, 3)
+view = img:roi(3, 4, 31, 22)
+local compact = CVLib.crop(img, 3, 4, 31, 22)
+assert(same(CVLib.bgr2rgb(view), CVLib.bgr2rgb(compact)), "bgr2rgb of view should match")
+assert(same(CVLib.flipHorizontal(view), CVLib.flipHorizontal(compact)), "flipHorizontal of view should match")
+assert(same(CVLib.flipVertical(view), CVLib.flipVertical(compact)), "flipVertical of view should match")
+for _, mode in ipairs({"nearest", "bilinear", "area"}) do
+    assert(same(CVLib.resize(view, 13, 9, mode), CVLib.resize(compact, 13, 9, mode)), mode .. " resize of view should match")
+    assert(same(CVLib.letterbox(view, 32, 32, mode).image, CVLib.letterbox(compact, 32, 32, mode).image),
+        mode .. " letterbox of view should match")
+end
+local a, b = CVLib.hwc2chw(view), CVLib.hwc2chw(compact)
+assert(#a == #b and a:at(100) == b:at(100) and a:at(#a - 1) == b:at(#b - 1), "hwc2chw of view should match")
+a, b = CVLib.normalize(view), CVLib.normalize(compact)
+assert(#a == #b and a:at(7) == b:at(7) and a:at(#a - 1) == b:at(#b - 1), "normalize of view should match")
+local pa = CVLib.preprocess(view, {w = 32, h = 32}).tensor
+local pb = CVLib.preprocess(compact, {w = 32, h = 32}).tensor
+assert(pa:at(1500) == pb:at(1500) and pa:at(#pa - 1) == pb:at(#pb - 1), "preprocess of view should match")
+print("✓ kernels honor stride")
+
+-- Test 5: views as destination and in place
+print("\n5. Views as dst...")
+local canvas = CVLib.Image(64, 64, 3)
+local tile = canvas:roi(16, 8, 13, 9)
+CVLib.resize(compact, 13, 9, "bilinear", tile)
+assert(same(tile, CVLib.resize(compact, 13, 9, "bilinear")), "resize into view should write the region")
+assert(canvas:at(7, 16, 0) == 0 and canvas:at(8, 15, 0) == 0 and canvas:at(17, 16, 0) == 0, "Outside the view stays zero")
+local gray = CVLib.Image(31, 22, 1)
+gray:fill(5)
+CVLib.gray2bgr(gray, canvas:roi(0, 0, 31, 22))
+assert(canvas:at(21, 30, 2) == 5 and canvas:at(0, 31, 0) == 0 and canvas:at(22, 0, 0) == 0, "gray2bgr into view")
+
+img = pattern(40, 30, 3)
+local reference = img:clone()
+view = img:roi(4, 2, 20, 10)
+CVLib.flipHorizontal(view, view)
+assert(img:at(2, 4, 0) == reference:at(2, 23, 0) and img:at(2, 3, 0) == reference:at(2, 3, 0), "In-place flip of view")
+CVLib.flipVertical(view, view)
+assert(img:at(2, 4, 1) == reference:at(11, 23, 1), "In-place vertical flip of view")
+assert(pcall(CVLib.flipHorizontal, img, reference:clone()), "Clone as dst should be accepted")
+assert(not pcall(CVLib.resize, img, 20, 10, "nearest", view), "resize into a view of the source should fail")
+local overlap = img:roi(1, 0, 20, 10)
+assert(not pcall(CVLib.flipHorizontal, view, overlap), "Partly overlapping dst should fail")
+print("✓ views as dst work")
+
+-- Test 6: row, plane and pixels views
+print("\n6. Pixel views...")
+img = pattern(40, 30, 3)
+local row = img:row(2)
+assert(#row == 40 * 3, "row should have width * channels bytes")
+assert(row[1] == img:at(2, 0, 0) and row[#row] == img:at(2, 39, 2), "row[i] should index the row bytes")
+row[4] = 200
+assert(img:at(2, 1, 0) == 200, "Writes through row should reach the image")
+local green = img:plane(1)
+local shape = green:getShape()
+assert(shape[1] == 30 and shape[2] == 40 and #green == 1200, "plane should be height x width")
+assert(green:get(3, 5) == img:at(2, 4, 1), "plane should be strided by channels")
+green:set(1, 1, 33)
+assert(img:at(0, 0, 1) == 33, "Writes through plane should reach the image")
+local px = img:pixels()
+assert(#px == img.width * img.height * 3 and px[3] == img:at(0, 0, 2), "pixels should cover all bytes")
+assert(px:sum() == Test.byteSum(px), "ByteTensorView should pass as byte view")
+local sub = img:roi(4, 2, 10, 5)
+assert(sub:row(0)[1] == img:at(2, 4, 0) and sub:plane(2):get(5, 10) == img:at(6, 13, 2), "Views of roi")
+assert(not pcall(sub.pixels, sub), "pixels of a view with row gaps should fail")
+assert(not pcall(img.row, img, 30) and not pcall(img.plane, img, 3), "Out of range row/plane should fail")
+print("✓ row, plane and pixels work")
+
+-- Test 7: views stay valid and unshared
+print("\n7. View lifetime and copy-on-write...")
+local frame = pattern(16, 16, 1)
+local bytes = frame:pixels()
+local copy3 = frame:clone()
+bytes[1] = 99
+assert(frame:at(0, 0, 0) == 99 and copy3:at(0, 0, 0) == 0, "clone with live views should not share")
+frame:release()
+collectgarbage()
+assert(bytes[1] == 99 and bytes[#bytes] == (15 * 16 + 15 * 4) % 256, "View should keep pixels alive")
+
+-- histogram at view-indexing speed
+local hist = {}
+for i = 0, 255 do hist[i] = 0 end
+for i = 1, #bytes do
+    local v = bytes[i]
+    hist[v] = hist[v] + 1
+end
+local total = 0
+for i = 0, 255 do total = total + hist[i] end
+assert(hist[99] == 1 and total == 256, "Histogram over pixels view")
+print("✓ views outlive the image")
+
+print("\n✓ Image views test PASSED")
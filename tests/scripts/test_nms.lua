@@ -0,0 +1,137 @@
+-- Test PostLib.nms options: soft-NMS, DIoU, class agnostic, max_detections and kernel levels
+
+print("=== Testing NMS Engine ===")
+
+local function near(a, b, eps)
+    return math.abs(a - b) < (eps or 1e-4)
+end
+
+local function makeBoxes()
+    return {
+        {x1 = 0,   y1 = 0,   x2 = 100, y2 = 100, confidence = 0.9,  class_id = 0},
+        {x1 = 10,  y1 = 0,   x2 = 110, y2 = 100, confidence = 0.8,  class_id = 0},  -- IoU 0.818 with box 1
+        {x1 = 50,  y1 = 0,   x2 = 150, y2 = 100, confidence = 0.7,  class_id = 0},  -- IoU 0.333 with box 1
+        {x1 = 0,   y1 = 0,   x2 = 100, y2 = 100, confidence = 0.6,  class_id = 1},  -- same place, other class
+        {x1 = 300, y1 = 300, x2 = 400, y2 = 400, confidence = 0.5,  class_id = 2},
+    }
+end
+
+local function confidences(boxes)
+    local t = {}
+    for i, b in ipairs(boxes) do t[i] = b.confidence end
+    return t
+end
+
+-- Test 1: number argument and options table give the same result
+print("\n1. Testing hard NMS...")
+local a, b = makeBoxes(), makeBoxes()
+PostLib.nms(a, 0.45)
+PostLib.nms(b, {iou = 0.45})
+assert(#a == 4 and #b == 4, "Box 2 should be suppressed")
+for i = 1, #a do
+    assert(a[i].x1 == b[i].x1 and a[i].class_id == b[i].class_id, "Options table result mismatch")
+end
+assert(a[2].x1 == 50, "Kept boxes should stay in input order")
+local defaults = makeBoxes()
+PostLib.nms(defaults)
+assert(#defaults == 4, "Default IoU threshold should be 0.45")
+print("✓ Hard NMS works")
+
+-- Test 2: class agnostic
+print("\n2. Testing agnostic NMS...")
+local boxes = makeBoxes()
+PostLib.nms(boxes, {agnostic = true})
+assert(#boxes == 3, "Box 4 should be suppressed across classes, got " .. #boxes)
+print("✓ Agnostic NMS works")
+
+-- Test 3: max_detections keeps the best boxes in input order
+print("\n3. Testing max_detections...")
+boxes = makeBoxes()
+PostLib.nms(boxes, {max_detections = 2})
+assert(#boxes == 2 and boxes[1].confidence == 0.9 and boxes[2].confidence == 0.7, "Expected the two best boxes")
+local ok, err = pcall(PostLib.nms, makeBoxes(), {max_detections = -1})
+assert(not ok and err:find("max_detections"), "Negative max_detections should fail")
+print("✓ max_detections works")
+
+-- Test 4: DIoU adds the center distance penalty
+print("\n4. Testing DIoU-NMS...")
+boxes = makeBoxes()
+PostLib.nms(boxes, {iou = 0.3})
+assert(#boxes == 3, "IoU 0.333 box should be suppressed at threshold 0.3")
+boxes = makeBoxes()
+PostLib.nms(boxes, {iou = 0.3, diou = true})
+assert(#boxes == 4, "DIoU of the 0.333 box is lower, it should be kept")
+print("✓ DIoU-NMS works")
+
+-- Test 5: soft-NMS decays confidence instead of removing
+print("\n5. Testing soft-NMS...")
+boxes = makeBoxes()
+PostLib.nms(boxes, {method = "linear"})
+assert(#boxes == 5, "Linear soft-NMS should keep all boxes")
+assert(near(boxes[2].confidence, 0.8 * (1 - 900 / 1100)), "Box 2 should be decayed by 1 - IoU")
+assert(near(boxes[3].confidence, 0.7), "Box 3 is below the IoU threshold, score kept")
+assert(near(boxes[1].confidence, 0.9) and near(boxes[4].confidence, 0.6), "Best boxes should not decay")
+
+boxes = makeBoxes()
+PostLib.nms(boxes, {method = "gaussian", sigma = 0.5, score_threshold = 0.3})
+local c = confidences(boxes)
+assert(#boxes == 4, "Gaussian soft-NMS should drop the box decayed below 0.3, got " .. #boxes)
+assert(near(c[1], 0.9) and near(c[2], 0.7 * math.exp(-(1 / 3) ^ 2 / 0.5)), "Gaussian decay mismatch")
+
+ok, err = pcall(PostLib.nms, makeBoxes(), {method = "fast"})
+assert(not ok and err:find("method"), "Unknown method should fail")
+ok, err = pcall(PostLib.nms, makeBoxes(), {method = "gaussian", sigma = 0})
+assert(not ok and err:find("sigma"), "Zero sigma should fail")
+print("✓ Soft-NMS works")
+
+-- Test 6: BoxArray gets the same result and decayed scores
+print("\n6. Testing BoxArray...")
+local packed = PostLib.BoxArray.fromTable(makeBoxes())
+PostLib.nms(packed, {method = "linear"})
+boxes = makeBoxes()
+PostLib.nms(boxes, {method = "linear"})
+assert(#packed == #boxes, "BoxArray count mismatch")
+for i = 1, #packed do
+    assert(near(select(5, packed:get(i)), boxes[i].confidence), "BoxArray score mismatch at " .. i)
+end
+print("✓ BoxArray matches tables")
+
+-- Test 7: every kernel level gives the same result on random boxes
+print("\n7. Testing kernel levels...")
+local function randomBoxes(n, seed)
+    local arr = PostLib.BoxArray()
+    local x = seed
+    local function rand(m)
+        x = (x * 1103515245 + 12345) % 2147483648
+        return x % m
+    end
+    for _ = 1, n do
+        local bx, by = rand(600), rand(600)
+        arr:push(bx, by, bx + 20 + rand(80), by + 20 + rand(80), rand(10000) / 10000, rand(5))
+    end
+    return arr
+end
+
+local reference
+for _, name in ipairs({"scalar", "sse", "avx2", "avx512"}) do
+    local level = PostLib.setKernelLevel(name)
+    for _, opts in ipairs({{iou = 0.45}, {diou = true, agnostic = true}, {method = "gaussian"}}) do
+        local arr = randomBoxes(500, 42)
+        PostLib.nms(arr, opts)
+        local result = {}
+        for i = 1, #arr do
+            local x1, _, _, _, conf = arr:get(i)
+            result[i] = string.format("%g:%.4f", x1, conf)
+        end
+        local key = table.concat(result, ",")
+        reference = reference or {}
+        local id = (opts.method or "hard") .. tostring(opts.agnostic)
+        reference[id] = reference[id] or key
+        assert(reference[id] == key, "NMS result differs at level " .. level)
+    end
+    print("  " .. name .. " -> " .. level .. " ok")
+end
+PostLib.setKernelLevel("avx512")
+print("✓ Kernel levels agree")
+
+print("\n✓ NMS Engine test PASSED")
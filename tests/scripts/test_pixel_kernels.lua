@@ -0,0 +1,116 @@
+-- Test that every instruction set level of the CVLib pixel kernels matches the scalar reference
+
+print("=== Testing pixel kernels ===")
+
+local default_level = CVLib.kernelLevel()
+print("Default level: " .. default_level)
+
+-- 3 and 4 channel images with odd widths, and an ROI view with a row stride
+local function makeImage(w, h, c)
+    local img = CVLib.Image(w, h, c)
+    local seed = w * 31 + c
+    for y = 0, h - 1 do
+        for x = 0, w - 1 do
+            for ch = 0, c - 1 do
+                seed = (seed * 1103515245 + 12345) % 2147483648
+                img:set(y, x, ch, seed % 256)
+            end
+        end
+    end
+    return img
+end
+
+local function bytes(img)
+    local t = {}
+    for y = 0, img.height - 1 do
+        local row = img:row(y)
+        for i = 1, #row do
+            t[#t + 1] = row[i]
+        end
+    end
+    return t
+end
+
+local function floats(tensor)
+    local view = tensor:view()
+    local t = {}
+    for i = 1, #view do
+        t[i] = view[i]
+    end
+    return t
+end
+
+local big = makeImage(77, 9, 3)
+local sources = {
+    rgb = makeImage(37, 5, 3),
+    rgba = makeImage(45, 4, 4),
+    gray = makeImage(70, 3, 1),
+    roi = big:roi(5, 2, 61, 6),
+}
+
+-- Outputs of every kernel, including in-place forms
+local function run()
+    local out = {}
+    for name, src in pairs(sources) do
+        out[name .. ".flipH"] = bytes(CVLib.flipHorizontal(src))
+        out[name .. ".flipV"] = bytes(CVLib.flipVertical(src))
+        local copy = src:clone()
+        CVLib.flipHorizontal(copy, copy)
+        out[name .. ".flipH.inplace"] = bytes(copy)
+        CVLib.flipVertical(copy, copy)
+        out[name .. ".flipV.inplace"] = bytes(copy)
+        if src.channels >= 3 then
+            out[name .. ".bgr2rgb"] = bytes(CVLib.bgr2rgb(src))
+            local swapped = src:clone()
+            CVLib.bgr2rgb(swapped, swapped)
+            out[name .. ".bgr2rgb.inplace"] = bytes(swapped)
+        end
+        if src.channels == 3 then
+            out[name .. ".normalize"] = floats(CVLib.normalize(src))
+            out[name .. ".hwc2chw"] = floats(CVLib.hwc2chw(src))
+            out[name .. ".preprocess"] = floats(CVLib.preprocess(src, {w = 48, h = 40, layout = "NHWC"}).tensor)
+        else
+            out[name .. ".gray2bgr"] = bytes(CVLib.gray2bgr(src))
+        end
+    end
+    return out
+end
+
+-- Test 1: scalar reference is correct on a few pixels
+print("\n1. Scalar reference...")
+assert(CVLib.setKernelLevel("scalar") == "scalar", "Scalar level should always be available")
+local rgb = sources.rgb
+local flipped = CVLib.flipHorizontal(rgb)
+assert(flipped:at(1, 0, 2) == rgb:at(1, 36, 2), "flipHorizontal should mirror pixels")
+local swapped = CVLib.bgr2rgb(sources.rgba)
+assert(swapped:at(3, 44, 0) == sources.rgba:at(3, 44, 2) and swapped:at(3, 44, 3) == sources.rgba:at(3, 44, 3),
+    "bgr2rgb should swap channels 0 and 2 and keep alpha")
+local expanded = CVLib.gray2bgr(sources.gray)
+assert(expanded:at(2, 69, 1) == sources.gray:at(2, 69, 0), "gray2bgr should copy gray to all channels")
+local reference = run()
+print("✓ scalar reference correct")
+
+-- Test 2: every SIMD level gives the same result
+print("\n2. SIMD levels match scalar...")
+for _, name in ipairs({"sse", "avx2", "avx512"}) do
+    local level = CVLib.setKernelLevel(name)
+    local out = run()
+    for key, ref in pairs(reference) do
+        local got = out[key]
+        assert(#got == #ref, key .. ": size differs at level " .. level)
+        for i = 1, #ref do
+            assert(math.abs(got[i] - ref[i]) <= 1e-5, string.format("%s[%d] differs at level %s", key, i, level))
+        end
+    end
+    print("  " .. name .. " -> " .. level .. " matches")
+end
+print("✓ all levels match")
+
+-- Test 3: level names
+print("\n3. Level selection...")
+assert(not pcall(CVLib.setKernelLevel, "neon"), "Unknown level should fail")
+assert(CVLib.setKernelLevel("avx512") == default_level, "Highest level should be the default")
+assert(CVLib.kernelLevel() == default_level, "kernelLevel should report the level in use")
+print("✓ level selection works")
+
+print("\n✓ Pixel kernels test PASSED")
@@ -2,21 +2,20 @@
 
 print("=== Testing PostLib Module ===")
 
--- Create a dummy tensor for testing
-local function createDummyTensor()
-    -- PostLib expects Tensor objects, but we'll use a table for now
-    return {
-        getShape = function() return {1, 3, 80, 80} end
-    }
-end
-
 -- Test 1: parseYoloOutput
 print("\n1. Testing parseYoloOutput...")
-local tensor = createDummyTensor()
-
--- For now, we'll skip this test since we need actual Tensor objects
--- This will be properly tested with real tensor binding later
-print("⚠ Skipping parseYoloOutput (requires Tensor binding)")
+local output = PostLib.Tensor({1, 2, 85})
+local view = output:view()
+view[1], view[2], view[3], view[4], view[5] = 320, 240, 64, 32, 5   -- cx, cy, w, h, objectness logit
+view[5 + 18] = 5                                                    -- class 17
+view[86 + 4] = -5                                                   -- second row rejected
+
+local decoded = PostLib.parseYoloOutput(output)
+assert(#decoded == 1, "parseYoloOutput should keep one box")
+local decoded_box = decoded:toTable()[1]
+assert(decoded_box.class_id == 17, "class_id should be 17")
+assert(decoded_box.x1 == 288 and decoded_box.y2 == 256, "box corners mismatch")
+print("✓ parseYoloOutput works: " .. #decoded .. " box")
 
 -- Test 2: NMS in-place mutation
 print("\n2. Testing NMS in-place mutation...")
@@ -0,0 +1,122 @@
+-- Test fused CVLib.preprocess against the letterbox/bgr2rgb/normalize/hwc2chw chain
+
+print("=== Testing fused preprocess ===")
+
+-- Tensor stores float32, compare with tolerance
+local function near(a, b)
+    return math.abs(a - b) < 1e-5
+end
+
+local img = CVLib.imread("test.jpg")   -- 640x480 gradient
+
+-- Test 1: NCHW with channel swap matches the chain
+print("\n1. NCHW matches letterbox -> bgr2rgb -> hwc2chw...")
+local lb = CVLib.letterbox(img, 640, 640)
+local ref = CVLib.hwc2chw(CVLib.bgr2rgb(lb.image)):view()
+local out = CVLib.preprocess(img, {w = 640, h = 640, swapRB = true, layout = "NCHW"})
+local shape = out.tensor:getShape()
+assert(shape[1] == 1 and shape[2] == 3 and shape[3] == 640 and shape[4] == 640, "Shape should be {1, 3, 640, 640}")
+local view = out.tensor:view()
+assert(#view == #ref, "Element count should match chain")
+for i = 1, #ref, 997 do
+    assert(near(view[i], ref[i]), "Mismatch at " .. i .. ": " .. view[i] .. " vs " .. ref[i])
+end
+assert(near(view[#ref], ref[#ref]), "Last element should match chain")
+print("✓ NCHW matches chain")
+
+-- Test 2: same padding metadata as letterbox
+print("\n2. Padding metadata...")
+for _, k in ipairs({"top", "left", "bottom", "right"}) do
+    assert(out.pad[k] == lb.pad[k], "pad." .. k .. " should match letterbox")
+end
+assert(out.pad.top == 80 and out.pad.bottom == 80, "640x480 should pad 80 rows top and bottom")
+assert(out.scale == 1, "640x480 into 640x640 should not scale")
+print("✓ pad={top=" .. out.pad.top .. ", left=" .. out.pad.left .. "}")
+
+-- Test 3: NHWC without swap matches letterbox -> normalize
+print("\n3. NHWC matches letterbox -> normalize...")
+local ref_hwc = CVLib.normalize(lb.image):view()
+local hwc = CVLib.preprocess(img, {layout = "NHWC"}).tensor
+local hwc_shape = hwc:getShape()
+assert(hwc_shape[2] == 640 and hwc_shape[3] == 640 and hwc_shape[4] == 3, "Shape should be {1, 640, 640, 3}")
+local hwc_view = hwc:view()
+for i = 1, #ref_hwc, 1013 do
+    assert(near(hwc_view[i], ref_hwc[i]), "NHWC mismatch at " .. i)
+end
+print("✓ NHWC matches chain")
+
+-- Test 4: downscale and non-square output
+print("\n4. Downscale 1920x1080 into 320x256...")
+local big = CVLib.Image(1920, 1080, 3)
+big:fill(200)
+local small = CVLib.preprocess(big, {w = 320, h = 256})
+local small_shape = small.tensor:getShape()
+assert(small_shape[3] == 256 and small_shape[4] == 320, "Shape should be {1, 3, 256, 320}")
+assert(small.pad.left == 0 and small.pad.top + small.pad.bottom == 256 - 180, "Should pad rows only")
+local sv = small.tensor:view()
+local pad_value = (114 / 255 - 0.485) / 0.229
+local img_value = (200 / 255 - 0.485) / 0.229
+assert(near(sv[1], pad_value), "Top row should be normalized padding")
+assert(near(sv[(small.pad.top + 1) * 320], img_value), "Image row should be normalized pixel")
+print("✓ downscale works, scale=" .. small.scale)
+
+-- Test 5: custom mean/std and dst reuse
+print("\n5. Custom mean/std and dst reuse...")
+local dst = PostLib.Tensor({1, 3, 640, 640})
+local opts = {mean = {0, 0, 0}, std = {1, 1, 1}}
+local res = CVLib.preprocess(img, opts, dst)
+assert(rawequal(res.tensor, dst), "preprocess should return dst")
+assert(near(dst:at(0), 114 / 255), "Padding with mean 0 std 1 should be 114/255")
+print("✓ dst reused")
+
+-- Test 6: invalid arguments
+print("\n6. Invalid arguments...")
+assert(not pcall(CVLib.preprocess, img, {layout = "CHWN"}), "Unknown layout should fail")
+assert(not pcall(CVLib.preprocess, img, {w = 0}), "Zero width should fail")
+assert(not pcall(CVLib.preprocess, CVLib.Image(0, 0)), "Empty image should fail")
+assert(not pcall(CVLib.preprocess, img, nil, PostLib.Tensor({3, 3})), "Wrong dst size should fail")
+print("✓ invalid arguments rejected")
+
+-- Test 7: batch matches per-image preprocess
+print("\n7. preprocessBatch matches preprocess...")
+local other = CVLib.Image(300, 500, 3)
+other:fill(50)
+local region = CVLib.crop(img, 100, 50, 200, 120, true)
+local batch_opts = {w = 160, h = 128, swapRB = true}
+local batch = CVLib.preprocessBatch({img, other, region}, batch_opts)
+local batch_shape = batch.tensor:getShape()
+assert(batch_shape[1] == 3 and batch_shape[2] == 3 and batch_shape[3] == 128 and batch_shape[4] == 160,
+    "Shape should be {3, 3, 128, 160}")
+local bv = batch.tensor:view()
+local per_image = 3 * 128 * 160
+for n, image in ipairs({img, other, region}) do
+    local single = CVLib.preprocess(image, batch_opts)
+    local v = single.tensor:view()
+    for i = 1, per_image, 97 do
+        assert(near(bv[(n - 1) * per_image + i], v[i]), "Batch image " .. n .. " mismatch at " .. i)
+    end
+    assert(near(bv[n * per_image], v[per_image]), "Batch image " .. n .. " last element should match")
+    for _, k in ipairs({"top", "left", "bottom", "right"}) do
+        assert(batch.pad[n][k] == single.pad[k], "Batch pad." .. k .. " should match for image " .. n)
+    end
+    assert(batch.scale[n] == single.scale, "Batch scale should match for image " .. n)
+end
+print("✓ batch matches per-image results")
+
+-- Test 8: batch layout, dst reuse and invalid arguments
+print("\n8. preprocessBatch options...")
+local nhwc = CVLib.preprocessBatch({img, other}, {w = 64, h = 64, layout = "NHWC"})
+local nhwc_shape = nhwc.tensor:getShape()
+assert(nhwc_shape[1] == 2 and nhwc_shape[2] == 64 and nhwc_shape[4] == 3, "Shape should be {2, 64, 64, 3}")
+local batch_dst = PostLib.Tensor({2, 3, 64, 64})
+assert(rawequal(CVLib.preprocessBatch({img, other}, {w = 64, h = 64}, batch_dst).tensor, batch_dst),
+    "preprocessBatch should return dst")
+local empty = CVLib.preprocessBatch({}, {w = 64, h = 64})
+assert(empty.tensor:getShape()[1] == 0 and #empty.pad == 0, "Empty batch should give empty tensor")
+assert(not pcall(CVLib.preprocessBatch, {img, CVLib.Image(0, 0)}), "Empty image in batch should fail")
+assert(not pcall(CVLib.preprocessBatch, {img, "frame"}), "Non-image in batch should fail")
+assert(not pcall(CVLib.preprocessBatch, img), "Image instead of table should fail")
+assert(not pcall(CVLib.preprocessBatch, {img}, {w = 64, h = 64}, batch_dst), "Wrong dst size should fail")
+print("✓ batch options work")
+
+print("\n✓ Fused preprocess test PASSED")
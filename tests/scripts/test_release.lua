@@ -0,0 +1,43 @@
+-- Test deterministic release via release() and to-be-closed variables
+
+print("=== Testing deterministic release ===")
+
+local gc = Test.GCPolicy()
+collectgarbage("collect")
+local base = gc:externalMemory()
+
+-- Explicit release frees the buffer immediately
+local img = CVLib.Image(640, 480, 3)
+assert(gc:externalMemory() == base + 640 * 480 * 3, "Image should be charged")
+img:release()
+assert(gc:externalMemory() == base, "Released image should be uncharged")
+
+-- Access after release raises a clean error
+local ok, err = pcall(function() return img.width end)
+assert(not ok and err:find("released"), "Property access should fail: " .. tostring(err))
+ok, err = pcall(function() return img:clone() end)
+assert(not ok and err:find("released"), "Method call should fail: " .. tostring(err))
+ok, err = pcall(function() return CVLib.bgr2rgb(img) end)
+assert(not ok and err:find("released"), "Passing released image should fail: " .. tostring(err))
+
+-- Release is idempotent
+img:release()
+
+-- To-be-closed variable releases at scope exit
+do
+    local frame <close> = CVLib.imread("frame.jpg")
+    assert(frame.width == 640, "Image should be usable in scope")
+end
+assert(gc:externalMemory() == base, "Closed image should be released")
+
+-- Peak memory stays flat across frames without any collection
+gc:stop()
+for frame = 1, 50 do
+    local src <close> = CVLib.imread("frame.jpg")
+    local rgb <close> = CVLib.bgr2rgb(src)
+    assert(gc:externalMemory() <= base + 2 * 640 * 480 * 3, "Peak should stay flat")
+end
+assert(gc:externalMemory() == base, "All frames should be released")
+gc:restart()
+
+print("✓ Release test PASSED")
@@ -0,0 +1,93 @@
+-- Test resize engine: nearest, bilinear and area modes for any channel count
+
+print("=== Testing resize modes ===")
+
+-- Image with value (x * 16 + y * 4 + c) % 256 at (y, x, c)
+local function pattern(w, h, c)
+    local img = CVLib.Image(w, h, c)
+    for y = 0, h - 1 do
+        for x = 0, w - 1 do
+            for ch = 0, c - 1 do
+                img:set(y, x, ch, (x * 16 + y * 4 + ch) % 256)
+            end
+        end
+    end
+    return img
+end
+
+-- Test 1: nearest keeps the top-left sampling used by letterbox
+print("\n1. Nearest...")
+local img = pattern(8, 6, 3)
+local small = CVLib.resize(img, 4, 3)
+assert(small.width == 4 and small.height == 3 and small.channels == 3, "Size should be 4x3x3")
+for y = 0, 2 do
+    for x = 0, 3 do
+        assert(small:at(y, x, 1) == img:at(y * 2, x * 2, 1), "Nearest should sample (2y, 2x)")
+    end
+end
+assert(CVLib.resize(img, 4, 3, "nearest"):at(2, 3, 2) == small:at(2, 3, 2), "Default mode should be nearest")
+print("✓ nearest works")
+
+-- Test 2: bilinear keeps constant images constant, interpolates midpoints
+print("\n2. Bilinear...")
+local flat = CVLib.Image(7, 5, 3)
+flat:fill(93)
+local up = CVLib.resize(flat, 20, 13, "bilinear")
+assert(up:at(0, 0, 0) == 93 and up:at(12, 19, 2) == 93 and up:at(6, 9, 1) == 93, "Constant image should stay constant")
+-- 2x upscale of a 2 pixel ramp: half-pixel centers give 1/4 and 3/4 blends
+local ramp = CVLib.Image(2, 1, 1)
+ramp:set(0, 1, 0, 200)
+local ramp4 = CVLib.resize(ramp, 4, 1, "bilinear")
+assert(ramp4:at(0, 0, 0) == 0 and ramp4:at(0, 1, 0) == 50, "Left half should blend 0 and 50")
+assert(ramp4:at(0, 2, 0) == 150 and ramp4:at(0, 3, 0) == 200, "Right half should blend 150 and 200")
+print("✓ bilinear works")
+
+-- Test 3: area averages covered pixels
+print("\n3. Area...")
+local half = CVLib.resize(img, 4, 3, "area")
+for y = 0, 2 do
+    for x = 0, 3 do
+        local sum = img:at(2 * y, 2 * x, 0) + img:at(2 * y, 2 * x + 1, 0)
+                  + img:at(2 * y + 1, 2 * x, 0) + img:at(2 * y + 1, 2 * x + 1, 0)
+        assert(half:at(y, x, 0) == math.floor(sum / 4 + 0.5), "Area should average 2x2 block")
+    end
+end
+local enlarged = CVLib.resize(flat, 14, 10, "area")
+assert(enlarged:at(9, 13, 0) == 93, "Area enlarge should fall back to bilinear")
+print("✓ area works")
+
+-- Test 4: any channel count
+print("\n4. Channel counts...")
+for _, c in ipairs({1, 2, 4, 5}) do
+    local src = pattern(6, 4, c)
+    for _, mode in ipairs({"nearest", "bilinear", "area"}) do
+        local out = CVLib.resize(src, 3, 2, mode)
+        assert(out.channels == c, mode .. " should keep " .. c .. " channels")
+        assert(out:at(0, 0, c - 1) <= 255, mode .. " should write last channel")
+    end
+    local same = CVLib.resize(src, 6, 4, "bilinear")
+    assert(same:at(3, 5, c - 1) == src:at(3, 5, c - 1), "Same size bilinear should copy pixels")
+end
+print("✓ 1, 2, 4 and 5 channels work")
+
+-- Test 5: letterbox modes and non 3-channel letterbox
+print("\n5. Letterbox...")
+local gray = pattern(64, 32, 1)
+local lb = CVLib.letterbox(gray, 32, 32, "area")
+assert(lb.image.channels == 1 and lb.pad.top == 8 and lb.pad.bottom == 8, "Gray letterbox should pad 8 rows")
+assert(lb.image:at(0, 0, 0) == 114, "Padding should be 114")
+assert(lb.image:at(8, 0, 0) == math.floor((gray:at(0, 0, 0) + gray:at(0, 1, 0) + gray:at(1, 0, 0) + gray:at(1, 1, 0)) / 4 + 0.5),
+    "Area letterbox should average 2x2 block")
+local bl = CVLib.letterbox(CVLib.imread("test.jpg"), 320, 320, "bilinear")
+assert(bl.image.width == 320 and bl.pad.top == 40, "Bilinear letterbox should pad 40 rows")
+print("✓ letterbox modes work")
+
+-- Test 6: invalid arguments
+print("\n6. Invalid arguments...")
+assert(not pcall(CVLib.resize, img, 4, 3, "cubic"), "Unknown mode should fail")
+assert(not pcall(CVLib.resize, img, 0, 3), "Zero width should fail")
+assert(not pcall(CVLib.resize, CVLib.Image(0, 0), 4, 3), "Empty image should fail")
+assert(not pcall(CVLib.letterbox, img, 32, 32, "cubic"), "Unknown letterbox mode should fail")
+print("✓ invalid arguments rejected")
+
+print("\n✓ Resize modes test PASSED")
@@ -0,0 +1,123 @@
+-- Test PostLib.scaleBoxes with letterbox results, in place scaling, BoxArray and kernel levels
+
+print("=== Testing scaleBoxes ===")
+
+local function near(a, b, eps)
+    return math.abs(a - b) < (eps or 1e-4)
+end
+
+-- 1280x720 letterboxed to 640x640: scale 0.5, image 640x360 at top 140
+local img = CVLib.Image(1280, 720, 3)
+local lb = CVLib.letterbox(img, 640, 640)
+
+local function makeBoxes()
+    return {
+        {x1 = 100, y1 = 200, x2 = 300, y2 = 400, confidence = 0.9, class_id = 0},
+        {x1 = -10, y1 = 100, x2 = 700, y2 = 900, confidence = 0.8, class_id = 1},  -- clipped
+    }
+end
+
+local function checkScaled(boxes, what)
+    local b1, b2 = boxes[1], boxes[2]
+    assert(b1.x1 == 200 and b1.y1 == 120 and b1.x2 == 600 and b1.y2 == 520, what .. ": box 1 mismatch")
+    assert(b2.x1 == 0 and b2.y1 == 0 and b2.x2 == 1280 and b2.y2 == 720, what .. ": box 2 should be clipped")
+    assert(near(b1.confidence, 0.9) and b2.class_id == 1, what .. ": confidence/class should be kept")
+end
+
+-- Test 1: pad table of letterbox carries the sizes
+print("\n1. Testing letterbox pad...")
+local pad = lb.pad
+assert(pad.orig_w == 1280 and pad.orig_h == 720, "pad should carry source size")
+assert(pad.new_w == 640 and pad.new_h == 360, "pad should carry resized size")
+assert(pad.top == 140 and pad.bottom == 140 and pad.left == 0 and pad.right == 0, "pad mismatch")
+print("✓ Pad table has source and resized size")
+
+-- Test 2: letterbox result, its pad and the explicit form agree
+print("\n2. Testing letterbox argument forms...")
+local boxes = makeBoxes()
+checkScaled(PostLib.scaleBoxes(boxes, lb), "letterbox result")
+checkScaled(PostLib.scaleBoxes(boxes, lb.pad), "pad table")
+checkScaled(PostLib.scaleBoxes(boxes, 1280, 720, 640, 640, lb.pad), "explicit sizes")
+assert(boxes[1].x1 == 100, "Input should be unchanged without inplace")
+local keyed = makeBoxes()
+keyed.name = {x1 = 0, y1 = 140, x2 = 0, y2 = 140, confidence = 0.5, class_id = 2}
+assert(#PostLib.scaleBoxes(keyed, 1280, 720, 640, 640, lb.pad) == 3, "Copy should accept non-integer keys")
+print("✓ All forms agree")
+
+-- Test 3: in place on tables and Box userdata
+print("\n3. Testing in place scaling...")
+boxes = makeBoxes()
+local same = PostLib.scaleBoxes(boxes, lb, true)
+assert(same == boxes, "In place should return the input table")
+checkScaled(boxes, "in place")
+boxes = makeBoxes()
+assert(PostLib.scaleBoxes(boxes, 1280, 720, 640, 640, lb.pad, true) == boxes, "Explicit in place should return input")
+checkScaled(boxes, "explicit in place")
+local userdata = PostLib.createTestBoxes()
+local x1 = userdata[1].x1
+PostLib.scaleBoxes(userdata, {top = 0, left = 0, orig_w = 1280, orig_h = 1280, new_w = 640, new_h = 640}, true)
+assert(userdata[1].x1 == x1 * 2, "Box userdata should be scaled in place")
+print("✓ In place scaling works")
+
+-- Test 4: BoxArray
+print("\n4. Testing BoxArray...")
+local arr = PostLib.BoxArray.fromTable(makeBoxes())
+local scaled = PostLib.scaleBoxes(arr, lb)
+assert(scaled ~= arr and arr:get(1) == 100, "BoxArray copy should leave input unchanged")
+checkScaled(scaled:toTable(), "BoxArray copy")
+assert(PostLib.scaleBoxes(arr, lb, true) == arr, "BoxArray in place should return input")
+checkScaled(arr:toTable(), "BoxArray in place")
+print("✓ BoxArray scaling works")
+
+-- Test 5: per-image pads of preprocessBatch
+print("\n5. Testing preprocessBatch pads...")
+local batch = CVLib.preprocessBatch({img, CVLib.Image(320, 640, 3)}, {w = 640, h = 640})
+boxes = makeBoxes()
+checkScaled(PostLib.scaleBoxes(boxes, batch.pad[1]), "batch pad 1")
+local tall = PostLib.scaleBoxes({{x1 = 160, y1 = 0, x2 = 480, y2 = 640, confidence = 1, class_id = 0}}, batch.pad[2])
+assert(tall[1].x1 == 0 and tall[1].x2 == 320 and tall[1].y2 == 640, "batch pad 2 mismatch")
+print("✓ Batch pads work")
+
+-- Test 6: errors
+print("\n6. Testing errors...")
+local ok, err = pcall(PostLib.scaleBoxes, makeBoxes(), {top = 0, left = 0})
+assert(not ok and err:find("letterbox"), "Pad without sizes should fail")
+ok = pcall(PostLib.scaleBoxes, {{x1 = 0}}, lb)
+assert(not ok, "Box without fields should fail")
+assert(#PostLib.scaleBoxes({}, lb) == 0, "Empty input should give empty output")
+print("✓ Errors reported")
+
+-- Test 7: kernel levels give the same boxes
+print("\n7. Testing kernel levels...")
+local function randomBoxes(n, seed)
+    local result = PostLib.BoxArray()
+    local x = seed
+    local function rand(m)
+        x = (x * 1103515245 + 12345) % 2147483648
+        return x % m
+    end
+    for _ = 1, n do
+        local bx, by = rand(700) - 30, rand(700) - 30
+        result:push(bx, by, bx + rand(200), by + rand(200), 0.5, 0)
+    end
+    return result
+end
+
+local reference
+for _, name in ipairs({"scalar", "sse", "avx2", "avx512"}) do
+    local level = PostLib.setKernelLevel(name)
+    local result = PostLib.scaleBoxes(randomBoxes(1003, 7), lb, true)
+    local values = {}
+    for i = 1, #result do
+        local a, b, c, d = result:get(i)
+        values[i] = string.format("%g,%g,%g,%g", a, b, c, d)
+    end
+    local key = table.concat(values, ";")
+    reference = reference or key
+    assert(reference == key, "scaleBoxes result differs at level " .. level)
+    print("  " .. name .. " -> " .. level .. " ok")
+end
+PostLib.setKernelLevel("avx512")
+print("✓ Kernel levels agree")
+
+print("\n✓ scaleBoxes test PASSED")
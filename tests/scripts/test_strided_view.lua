@@ -0,0 +1,68 @@
+-- Test strided N-d TensorView (zero-copy slice/select/transpose/reshape/row)
+
+print("=== Testing StridedTensorView ===")
+
+-- [1, 25200, 85] model output, column c of row r holds c + 100 * (r % 100) (0-based r, c)
+local out = Test.createOutput()
+assert(out:ndim() == 3, "ndim should be 3")
+local shape = out:getShape()
+assert(shape[1] == 1 and shape[2] == 25200 and shape[3] == 85, "shape mismatch")
+assert(#out == 25200 * 85, "numel mismatch")
+assert(out:isContiguous(), "output should be contiguous")
+
+local function expected(r, c) return (c - 1) + 100 * ((r - 1) % 100) end
+
+-- Element access, 1-based per dimension
+assert(out:get(1, 1, 1) == expected(1, 1), "get(1,1,1) mismatch")
+assert(out:get(1, 250, 5) == expected(250, 5), "get(1,250,5) mismatch")
+assert(out:get(1, -1, -1) == expected(25200, 85), "negative index mismatch")
+
+-- Row access returns 1-d TensorView over the same memory
+assert(out:rows() == 25200, "rows mismatch")
+local det = out:row(1234)
+assert(#det == 85, "row length mismatch")
+assert(det:get(5) == expected(1234, 5), "row element mismatch")
+det:set(5, -1)
+assert(out:get(1, 1234, 5) == -1, "row should share memory")
+
+-- Select drops the batch dimension
+local dets = out:select(1, 1)
+assert(dets:ndim() == 2 and dets:size(1) == 25200, "select shape mismatch")
+assert(dets:get(1234, 5) == -1, "select should share memory")
+local col = dets:select(2, 5)
+assert(col:ndim() == 1 and #col == 25200 and col:get(1234) == -1, "select of 2-d view should give 1-d view")
+local ok, err = pcall(col.select, col, 1, 1)
+assert(not ok and err:find("get%(i%)"), "select on 1-d view should fail")
+
+-- Slice columns 5..85 (scores), every other row
+local scores = dets:slice(2, 5, -1):slice(1, 1, -1, 2)
+assert(scores:size(1) == 12600 and scores:size(2) == 81, "slice shape mismatch")
+assert(not scores:isContiguous(), "strided slice is not contiguous")
+assert(scores:get(2, 1) == expected(3, 5), "slice element mismatch")
+assert(scores:row(2):get(1) == expected(3, 5), "row of slice mismatch")
+
+-- Transpose / permute only swap strides
+local t = dets:transpose(1, 2)
+assert(t:size(1) == 85 and t:size(2) == 25200, "transpose shape mismatch")
+assert(t:get(7, 300) == dets:get(300, 7), "transpose element mismatch")
+local p = out:permute({3, 2, 1})
+assert(p:get(7, 300, 1) == out:get(1, 300, 7), "permute element mismatch")
+local ok = pcall(function() return t:row(1) end)
+assert(not ok, "row of transposed view should fail")
+
+-- Reshape needs contiguous layout, clone makes a compact copy
+local flat = out:reshape({-1, 85})
+assert(flat:size(1) == 25200, "reshape infer mismatch")
+ok = pcall(function() return t:reshape({-1}) end)
+assert(not ok, "reshape of transposed view should fail")
+local compact = t:clone()
+assert(compact:isContiguous(), "clone should be contiguous")
+assert(compact:get(7, 300) == t:get(7, 300), "clone element mismatch")
+
+-- Views keep the data alive after the source is gone
+local row = out:row(2)
+out, dets, scores, t, p, flat = nil, nil, nil, nil, nil, nil
+collectgarbage("collect")
+assert(row:get(3) == expected(2, 3), "row should keep data alive")
+
+print("✓ StridedTensorView test PASSED")
@@ -0,0 +1,62 @@
+-- Test zero-copy views over Lua strings and mutable buffers
+
+print("=== Testing TensorView over strings and buffers ===")
+
+-- Lua string viewed as bytes and reinterpreted as floats
+local payload = string.rep("\1\2\3\4", 1000)
+assert(Test.byteSum(payload) == 10 * 1000, "byteSum over string mismatch")
+assert(Test.tensorInfo(payload) == "u8[4000]", "string should be accepted as AnyTensorView")
+
+local floats = string.pack("<ffff", 1.5, 2.5, 3, -1)
+assert(Test.floatSum(floats) == 6, "floatSum over string mismatch")
+print("✓ string views")
+
+-- String stays pinned while C++ holds the view
+Test.holdBytes(string.rep("\7", 100))
+collectgarbage()
+collectgarbage()
+assert(Test.heldByteSum() == 700, "held view should pin the string")
+Test.releaseBytes()
+assert(Test.heldByteSum() == 0, "released view should be gone")
+-- held again and never released: lua_close has to free it
+Test.holdBytes(string.rep("\1", 10))
+print("✓ string pinned by view")
+
+-- Mutable buffer filled from Lua and viewed as f32 without copy
+local buf = Test.Buffer(16)
+assert(#buf == 16 and buf:size() == 16, "buffer size mismatch")
+assert(Test.byteSum(buf) == 0, "buffer should be zero filled")
+buf:write(1, string.pack("<ff", 1.25, 2.5))
+local v = buf:view("f32")
+assert(#v == 4 and v[1] == 1.25 and v[2] == 2.5 and v[3] == 0, "buffer view mismatch")
+v[3] = 7
+assert(buf:read(9, 4) == string.pack("<f", 7), "view write should show in buffer")
+assert(Test.floatSum(buf) == 10.75, "buffer should be accepted as float view")
+assert(Test.tensorInfo(buf) == "u8[16]", "buffer should be accepted as AnyTensorView")
+buf:fill(1)
+assert(Test.byteSum(buf) == 16, "buffer fill mismatch")
+print("✓ mutable buffer")
+
+-- View keeps buffer storage alive
+local held = Test.Buffer(8):view("u8")
+collectgarbage()
+held[8] = 200
+assert(held[8] == 200 and held:sum() == 200, "view should keep buffer alive")
+
+-- Errors
+local ok, err = pcall(function() return Test.floatSum("abc") end)
+assert(not ok and err:find("multiple"), "string length not multiple of float should fail")
+ok, err = pcall(function() return Test.byteSum(123) end)
+assert(not ok and err:find("expected"), "number should not be accepted as byte view")
+ok, err = pcall(function() buf:write(15, "abc") end)
+assert(not ok and err:find("out of buffer"), "write past end should fail")
+ok, err = pcall(function() return Test.Buffer(6):view("f32") end)
+assert(not ok and err:find("multiple"), "buffer size not multiple of f32 should fail")
+print("✓ error handling")
+
+-- Any AnyTensorView argument takes a string as read-only u8
+local bytes = Test.createAnyView("u8", 4)
+bytes:convertFrom("abcd")
+assert(bytes[1] == 97 and bytes[4] == 100, "convert from string mismatch")
+
+print("✓ TensorView over strings and buffers test PASSED")
@@ -0,0 +1,69 @@
+-- Test memory-mapped file-backed tensor views
+
+print("=== Testing TensorMapping ===")
+
+local path = os.tmpname()
+
+-- Write [10, 100] f32 tensor with header
+local src = Test.createAnyView("f32", 1000)
+for i = 1, #src do src[i] = (i - 1) * 0.5 end
+Test.writeTensorFile(path, src, {10, 100})
+
+local shape = Test.mapTensorShape(path)
+assert(#shape == 2 and shape[1] == 10 and shape[2] == 100, "shape from header mismatch")
+
+-- Read-only mapping: data shared with page cache, writes rejected
+local ro = Test.mapTensorFile(path, "r", "sequential,willneed,hugepage")
+assert(ro:dtype() == "f32" and #ro == 1000, "mapped view shape mismatch")
+assert(ro:isReadOnly(), "read-only mapping should give read-only view")
+assert(ro[1] == 0 and ro[1000] == 499.5, "mapped values mismatch")
+assert(ro:sum() == src:sum(), "mapped sum mismatch")
+local ok, err = pcall(function() ro[1] = 1 end)
+assert(not ok and err:find("read%-only"), "write to read-only mapping should fail")
+ok, err = pcall(function() ro:fill(0) end)
+assert(not ok and err:find("read%-only"), "fill of read-only mapping should fail")
+print("✓ read-only mapping")
+
+-- Copy-on-write mapping: writes stay private, file is unchanged
+local cow = Test.mapTensorFile(path, "cow")
+assert(not cow:isReadOnly(), "copy-on-write view should be writable")
+cow[1] = 42
+assert(cow[1] == 42 and ro[1] == 0, "copy-on-write should not change shared pages")
+assert(Test.mapTensorFile(path)[1] == 0, "copy-on-write should not change file")
+print("✓ copy-on-write mapping")
+
+-- Conversion from mapped view without copying the file first
+local half = ro:convertTo("f16")
+assert(half[1000] == 499.5, "convert from mapped view mismatch")
+
+-- Whole file as typed view (header dtype must match)
+local fv = Test.mapFloatFile(path)
+assert(#fv == 1000 and fv[3] == 1, "mapFloatFile mismatch")
+fv:scale(2)
+assert(fv[3] == 2 and ro[3] == 1, "typed copy-on-write view should be private")
+print("✓ typed view of mapped file")
+
+-- Views keep the mapping alive after the function returns
+collectgarbage()
+assert(ro[500] == 249.5, "mapping should stay alive while view is referenced")
+
+-- Errors
+ok, err = pcall(function() return Test.mapTensorFile(path .. ".missing") end)
+assert(not ok and err:find("can not open"), "missing file should fail")
+ok, err = pcall(function() Test.writeTensorFile(path, src, {3, 3}) end)
+assert(not ok and err:find("shape"), "shape mismatch should fail")
+
+-- Header whose shape product wraps to 0 bytes must not map a huge view over the payload
+local bad = io.open(path, "wb")
+bad:write(string.pack("<I4I4I4I4", 0x534e544c, 1, 0, 2), string.pack("<I8I8", 1 << 32, 1 << 32),
+    string.rep("\0", 6 * 8), string.pack("<I8", 128), string.rep("\0", 128 - 88), string.rep("\0", 16))
+bad:close()
+ok, err = pcall(function() return Test.mapTensorFile(path) end)
+assert(not ok and err:find("invalid header"), "wrapping header shape should fail")
+print("✓ error handling")
+
+ro, cow, fv = nil, nil, nil
+collectgarbage()
+os.remove(path)
+
+print("✓ TensorMapping test PASSED")
@@ -2,6 +2,11 @@
 
 print("=== Testing Tensor Class Methods ===")
 
+-- Tensor stores float32, compare with tolerance
+local function near(a, b)
+    return math.abs(a - b) < 1e-6
+end
+
 -- Test 1: Tensor constructor
 print("\n1. Testing Tensor constructor...")
 local shape = {2, 3, 4}
@@ -41,9 +46,9 @@ tensor:fill(3.14)
 print("  After fill, checking first element...")
 local val = tensor:at(0)
 print("  tensor:at(0) = " .. tostring(val))
-assert(val == 3.14, "First element should be 3.14, got " .. tostring(val))
+assert(near(val, 3.14), "First element should be 3.14, got " .. tostring(val))
 local val10 = tensor:at(10)
-assert(val10 == 3.14, "All elements should be 3.14, got " .. tostring(val10))
+assert(near(val10, 3.14), "All elements should be 3.14, got " .. tostring(val10))
 print("✓ fill() works")
 
 -- Test 6: clone() method
@@ -51,12 +56,12 @@ print("\n6. Testing clone()...")
 local cloned = tensor:clone()
 assert(#cloned == #tensor, "Cloned tensor should have same length")
 local cloned_val = cloned:at(0)
-assert(cloned_val == 3.14, "Cloned data should match, got " .. tostring(cloned_val))
+assert(near(cloned_val, 3.14), "Cloned data should match, got " .. tostring(cloned_val))
 cloned:fill(2.71)
 local orig_val = tensor:at(0)
-assert(orig_val == 3.14, "Original should not be affected, got " .. tostring(orig_val))
+assert(near(orig_val, 3.14), "Original should not be affected, got " .. tostring(orig_val))
 local new_cloned_val = cloned:at(0)
-assert(new_cloned_val == 2.71, "Clone should be modified, got " .. tostring(new_cloned_val))
+assert(near(new_cloned_val, 2.71), "Clone should be modified, got " .. tostring(new_cloned_val))
 print("✓ clone() works")
 
 -- Test 7: reshape() method
@@ -77,4 +82,32 @@ local val = tensor:at(0)
 assert(val == 0, "First element should be 0")
 print("✓ at() works")
 
+-- Test 9: view() shares data without copy
+print("\n9. Testing view()...")
+local view = tensor:view()
+assert(#view == 24, "View should cover all 24 elements")
+view[1] = 1.5
+view[24] = -2
+assert(tensor:at(0) == 1.5, "Write through view should be visible in tensor")
+assert(tensor:at(23) == -2, "Last element should be -2")
+tensor:fill(0.5)
+assert(view[12] == 0.5, "Tensor fill should be visible in view")
+assert(view:sum() == 12, "Sum through view should be 12")
+local alive = tensor:clone():view()
+collectgarbage()
+collectgarbage()
+assert(#alive == 24 and alive[1] == 0.5, "View should keep tensor data alive")
+print("✓ view() works")
+
+-- Test 10: fromView() adopts buffer without copy
+print("\n10. Testing fromView()...")
+local adopted = PostLib.Tensor.fromView(view, {6, 4})
+local adopted_shape = adopted:getShape()
+assert(adopted_shape[1] == 6 and adopted_shape[2] == 4, "Adopted shape should be [6, 4]")
+view[2] = 7
+assert(adopted:at(1) == 7, "Adopted tensor should share data with view")
+local ok = pcall(PostLib.Tensor.fromView, view, {5, 5})
+assert(not ok, "fromView should reject shape not matching view length")
+print("✓ fromView() works")
+
 print("\n=== Tensor Class Methods: ALL TESTS PASSED ===")
@@ -0,0 +1,78 @@
+-- Test vectorized bulk operations on TensorView
+
+print("=== Testing TensorView bulk operations ===")
+print("Kernel level:", Test.kernelLevel())
+
+local function near(a, b, tol) return math.abs(a - b) <= (tol or 1e-5) * math.max(1, math.abs(b)) end
+
+-- Odd length exercises the scalar tail of every kernel
+local n = 100003
+local x = Test.createFloatView(n, 0)
+for i = 1, n do x[i] = ((i - 1) % 1000) * 0.01 - 5 end
+
+-- Reductions (float lanes, so compare against the magnitude of the terms)
+local expected_sum, abs_sum = 0, 0
+for i = 1, n do
+    expected_sum = expected_sum + x[i]
+    abs_sum = abs_sum + math.abs(x[i])
+end
+local function near_sum(a, b) return math.abs(a - b) <= 1e-7 * abs_sum end
+assert(near_sum(x:sum(), expected_sum), "sum mismatch")
+assert(near(x:min(), -5), "min mismatch")
+assert(near(x:max(), 4.99), "max mismatch")
+assert(x:argmax() == 1000, "argmax should be first maximum (1-based)")
+
+local ones = Test.createFloatView(n, 1)
+assert(near_sum(x:dot(ones), expected_sum), "dot mismatch")
+
+-- Element-wise
+local y = Test.createFloatView(n, 0)
+y:copyFrom(x)
+assert(y[12345] == x[12345], "copyFrom mismatch")
+y:clamp(-1, 1)
+assert(y:min() == -1 and y:max() == 1, "clamp mismatch")
+y:add(ones, 2)          -- y = y + 2
+y:scale(0.5)            -- y = y / 2
+y:addScalar(-1)         -- y = y - 1
+for _, i in ipairs({1, 2, 501, 99999, n}) do
+    local v = math.max(-1, math.min(1, x[i]))
+    assert(near(y[i], (v + 2) * 0.5 - 1), "element-wise chain mismatch at " .. i)
+end
+y:fill(7)
+assert(y:sum() == 7 * n, "fill mismatch")
+
+-- Sigmoid against the scalar formula
+local s = Test.createFloatView(n, 0)
+s:copyFrom(x)
+s:sigmoid()
+for _, i in ipairs({1, 250, 500, 750, n}) do
+    assert(near(s[i], 1 / (1 + math.exp(-x[i])), 1e-6), "sigmoid mismatch at " .. i)
+end
+
+-- Vector kernels agree with the scalar reference
+local simd_sum, simd_sig = x:sum(), s[777]
+Test.setKernelLevel("scalar")
+local r = Test.createFloatView(n, 0)
+r:copyFrom(x)
+r:sigmoid()
+assert(near_sum(x:sum(), simd_sum), "scalar sum should match")
+assert(near(r[777], simd_sig, 1e-6), "scalar sigmoid should match")
+Test.setKernelLevel("avx512")
+
+-- Size mismatch and empty view are reported
+local ok, err = pcall(function() y:add(Test.createFloatView(3, 0)) end)
+assert(not ok and err:find("length mismatch"), "length mismatch should fail")
+ok, err = pcall(function() return Test.createFloatView(0, 0):max() end)
+assert(not ok and err:find("empty"), "max of empty view should fail")
+
+-- Score thresholding: bulk calls instead of per-element loop
+local scores = Test.createFloatView(1000000, 0)
+scores:fill(-3)
+scores[424242] = 4
+local t0 = os.clock()
+scores:sigmoid()
+local best, best_i = scores:max(), scores:argmax()
+print(string.format("sigmoid + argmax over 1M scores: %.2f ms", (os.clock() - t0) * 1000))
+assert(best_i == 424242 and near(best, 1 / (1 + math.exp(-4))), "threshold search mismatch")
+
+print("✓ TensorView bulk operations test PASSED")
@@ -17,3 +17,37 @@ view:set(1, 2.71)
 assert(math.abs(view:get(1) - 2.71) < 0.01, "View element modification failed")
 
 print("✓ TensorView test PASSED")
+
+print("=== Testing TensorView indexing ===")
+
+-- Numeric index reads and writes the same memory as get/set
+assert(math.abs(view[1] - 2.71) < 0.01, "view[1] should see view:set")
+view[2] = 1.5
+assert(view:get(2) == 1.5, "view:get should see view[2] write")
+assert(math.abs(view[#view] - 3.14) < 0.01, "Last element access failed")
+
+-- Bounds are checked
+local ok, err = pcall(function() return view[0] end)
+assert(not ok and err:find("out of range"), "view[0] should fail")
+ok, err = pcall(function() view[#view + 1] = 0 end)
+assert(not ok and err:find("out of range"), "Write past end should fail")
+ok, err = pcall(function() return view[1.5] end)
+assert(not ok and err:find("integer"), "Fractional index should fail")
+
+-- Methods are still reachable through string keys
+assert(type(view.get) == "function", "Method lookup should fall back")
+
+-- Compare per-element cost against method dispatch
+local n = 1000000
+local t0 = os.clock()
+local s1 = 0
+for i = 1, n do s1 = s1 + view:get(i) end
+local t_get = os.clock() - t0
+t0 = os.clock()
+local s2 = 0
+for i = 1, n do s2 = s2 + view[i] end
+local t_index = os.clock() - t0
+print(string.format("view:get(i) %.1f ns, view[i] %.1f ns", t_get / n * 1e9, t_index / n * 1e9))
+assert(s1 == s2, "get and index should read the same values")
+
+print("✓ TensorView indexing test PASSED")
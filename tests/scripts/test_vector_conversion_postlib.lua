@@ -104,4 +104,32 @@ local sample = large_boxes[50]
 checkBoxFields(sample, 50)
 print("✓ Large vector conversion works: " .. #large_boxes .. " boxes")
 
+-- Test 9: nms and scaleBoxes read Box userdata directly
+print("\n9. Testing nms/scaleBoxes with Box userdata...")
+local typed = PostLib.createTestBoxes()
+local first = typed[1]
+PostLib.nms(typed, 0.1)   -- boxes 1 and 2 overlap with IoU 0.14
+assert(#typed == 3 and typed[1] == first, "nms should keep Box objects in place")
+assert(typed[2].classId == 1, "Box 2 should be suppressed")
+
+local pad_info = {top = 0, left = 0, bottom = 0, right = 0}
+local scaled = PostLib.scaleBoxes(PostLib.createTestBoxes(), 1280, 1280, 640, 640, pad_info)
+assert(#scaled == 4 and scaled[1].x1 == 200 and scaled[3].class_id == 1, "scaleBoxes should read Box userdata")
+print("✓ Box userdata read without field lookups")
+
+-- Test 10: mixed tables and soft-NMS scores written to Box
+print("\n10. Testing mixed box table...")
+local mixed = {
+    PostLib.Box(100, 100, 200, 200, 0.9, 0),
+    {x1 = 110, y1 = 100, x2 = 210, y2 = 200, confidence = 0.8, classId = 0},
+    PostLib.Box(105, 100, 205, 200, 0.7, 0),
+}
+PostLib.nms(mixed, {method = "linear", iou = 0.5})
+assert(#mixed == 3, "Linear soft-NMS should keep all boxes")
+assert(type(mixed[1]) == "userdata" and type(mixed[2]) == "table", "Element types should be kept")
+assert(mixed[3].confidence < 0.7, "Box confidence should be decayed, got " .. mixed[3].confidence)
+local ok, err = pcall(PostLib.nms, {PostLib.Box(), 42}, 0.5)
+assert(not ok and err:find("table or Box"), "Non-box element should fail")
+print("✓ Mixed tables work")
+
 print("\n=== Vector<Box> Conversion: ALL TESTS PASSED ===")
@@ -0,0 +1,101 @@
+-- Test PostLib.parseYoloOutput decoding into a packed BoxArray
+
+print("=== Testing YOLO Decoder ===")
+
+local function near(a, b, eps)
+    return math.abs(a - b) < (eps or 1e-4)
+end
+
+local function sigmoid(x)
+    return 1 / (1 + math.exp(-x))
+end
+
+-- rows of {cx, cy, w, h, objectness, class scores...}, raw logits as the model outputs them
+local rows = {
+    {100, 100, 20, 40,  4, -2,  3,  0},   -- class 1, kept
+    {200, 200, 10, 10, -5,  9,  9,  9},   -- low objectness, rejected early
+    {300,  50, 60, 30,  2,  0, -1, -3},   -- class 0, kept
+    { 50,  50, 10, 10,  0, -4, -4, -1},   -- score 0.5 * 0.27 below threshold
+}
+local C = 3
+
+local function makeTensor(shape)
+    local tensor = PostLib.Tensor(shape)
+    local view = tensor:view()
+    local k = 1
+    for _, row in ipairs(rows) do
+        for _, v in ipairs(row) do
+            view[k] = v
+            k = k + 1
+        end
+    end
+    return tensor
+end
+
+-- Test 1: Tensor [1, N, 5 + C] with sigmoid activation
+print("\n1. Testing [1, N, 5 + C] tensor...")
+local out = PostLib.parseYoloOutput(makeTensor({1, #rows, 5 + C}))
+assert(#out == 2, "Expected 2 boxes, got " .. #out)
+local boxes = out:toTable()
+assert(boxes[1].class_id == 1 and boxes[2].class_id == 0, "class ids mismatch")
+assert(near(boxes[1].x1, 90) and near(boxes[1].y1, 80), "box 1 corner mismatch")
+assert(near(boxes[1].x2, 110) and near(boxes[1].y2, 120), "box 1 corner mismatch")
+assert(near(boxes[1].confidence, sigmoid(4) * sigmoid(3)), "box 1 confidence mismatch")
+assert(near(boxes[2].confidence, sigmoid(2) * sigmoid(0)), "box 2 confidence mismatch")
+assert(near(boxes[2].x1, 270) and near(boxes[2].y2, 65), "box 2 corner mismatch")
+print("✓ Decoded " .. #out .. " boxes")
+
+-- Test 2: [N, 5 + C] shape and threshold option
+print("\n2. Testing [N, 5 + C] tensor and conf option...")
+local tensor = makeTensor({#rows, 5 + C})
+assert(#PostLib.parseYoloOutput(tensor, {conf = 0.9}) == 1, "conf 0.9 should keep one box")
+assert(#PostLib.parseYoloOutput(tensor, {conf = 0.1}) == 3, "conf 0.1 should keep three boxes")
+print("✓ Shape and conf option work")
+
+-- Test 3: already activated output
+print("\n3. Testing sigmoid = false...")
+local probs = PostLib.Tensor({1, 2, 5 + C})
+local view = probs:view()
+local values = {10, 20, 4, 8, 0.9, 0.1, 0.2, 0.8,
+                30, 40, 4, 4, 0.2, 0.9, 0.1, 0.1}
+for i, v in ipairs(values) do view[i] = v end
+local plain = PostLib.parseYoloOutput(probs, {sigmoid = false}):toTable()
+assert(#plain == 1, "Expected 1 box, got " .. #plain)
+assert(plain[1].class_id == 2 and near(plain[1].confidence, 0.72), "plain score mismatch")
+print("✓ Probabilities are used as is")
+
+-- Test 4: flat float views need the class count
+print("\n4. Testing FloatTensorView and string input...")
+local flat = makeTensor({1, #rows, 5 + C}):view()
+assert(#PostLib.parseYoloOutput(flat, {classes = C}) == 2, "FloatTensorView decode mismatch")
+local packed = {}
+for _, row in ipairs(rows) do
+    for _, v in ipairs(row) do packed[#packed + 1] = string.pack("f", v) end
+end
+assert(#PostLib.parseYoloOutput(table.concat(packed), {classes = C}) == 2, "string decode mismatch")
+print("✓ Views decode with classes option")
+
+-- Test 5: dst is cleared and reused
+print("\n5. Testing dst reuse...")
+local dst = PostLib.BoxArray()
+local result = PostLib.parseYoloOutput(tensor, {conf = 0.1}, dst)
+assert(result == dst and #dst == 3, "dst should be returned with 3 boxes")
+PostLib.parseYoloOutput(tensor, {conf = 0.9}, dst)
+assert(#dst == 1, "dst should be cleared before decode")
+dst:clear()
+assert(#dst == 0, "clear should empty BoxArray")
+print("✓ dst BoxArray reused")
+
+-- Test 6: errors
+print("\n6. Testing errors...")
+local ok, err = pcall(PostLib.parseYoloOutput, PostLib.Tensor({2, 3, 8}))
+assert(not ok and err:find("shape"), "batch of 2 should fail")
+ok, err = pcall(PostLib.parseYoloOutput, flat, {classes = 4})
+assert(not ok and err:find("5 %+ C"), "size mismatch should fail")
+ok, err = pcall(PostLib.parseYoloOutput, tensor, nil, {})
+assert(not ok and err:find("BoxArray"), "bad dst should fail")
+ok, err = pcall(PostLib.parseYoloOutput, tensor, 0.5)
+assert(not ok and err:find("options"), "bad options should fail")
+print("✓ Errors reported")
+
+print("\n✓ YOLO Decoder test PASSED")
@@ -1,23 +1,823 @@
 #include "cv_types.h"
+#include "cv_kernels.h"
 #include "LuaIntf.h"
 #include <string>
 #include <cstring>
 #include <cmath>
 #include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 using namespace LuaIntf;
 using namespace CVLib;
 
 namespace CVLib {
 
+typedef int32_t Int8 __attribute__((vector_size(32)));
+typedef uint8_t Byte8 __attribute__((vector_size(8)));
+
+/**
+ * Fixed pool of worker threads for row-parallel kernels, shared by all CVLib functions.
+ * The calling thread runs chunks too and keeps draining the queue while it waits,
+ * so parallelFor may be nested. Kernels run by the pool must not throw.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(int workers) {
+        for (int i = 0; i < workers; i++) {
+            workers_.emplace_back([this]() { run(); });
+        }
+    }
+    
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        task_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    /**
+     * Shared pool, one worker less than hardware threads since the caller also runs chunks
+     */
+    static ThreadPool& shared() {
+        static ThreadPool pool(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) - 1);
+        return pool;
+    }
+    
+    int concurrency() const { return static_cast<int>(workers_.size()) + 1; }
+    
+    /**
+     * Run fn(begin, end) over [0, n) in chunks of at least min_chunk items and wait for all.
+     * Runs inline when the work is too small to split.
+     */
+    template <typename F>
+    void parallelFor(int n, int min_chunk, F&& fn) {
+        int chunks = std::min(concurrency(), std::max(1, n / std::max(1, min_chunk)));
+        if (chunks <= 1) {
+            if (n > 0) fn(0, n);
+            return;
+        }
+        
+        int chunk = (n + chunks - 1) / chunks;
+        int remaining = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int begin = chunk; begin < n; begin += chunk) {
+                int end = std::min(n, begin + chunk);
+                remaining++;
+                tasks_.push_back([this, &fn, &remaining, begin, end]() {
+                    fn(begin, end);
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (--remaining == 0) done_cv_.notify_all();
+                });
+            }
+        }
+        task_cv_.notify_all();
+        
+        fn(0, chunk);
+        
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (remaining > 0) {
+            if (!tasks_.empty()) {
+                runOne(lock);
+            } else {
+                done_cv_.wait(lock);
+            }
+        }
+    }
+
+private:
+    void runOne(std::unique_lock<std::mutex>& lock) {
+        std::function<void()> task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+    
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            task_cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;
+            runOne(lock);
+        }
+    }
+    
+    std::mutex mutex_;
+    std::condition_variable task_cv_;
+    std::condition_variable done_cv_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> workers_;
+    bool stop_ = false;
+};
+
+template <typename F>
+static void parallelFor(int n, int min_chunk, F&& fn) {
+    ThreadPool::shared().parallelFor(n, min_chunk, std::forward<F>(fn));
+}
+
+/**
+ * Resize interpolation: nearest samples one pixel (top-left mapping, as letterbox always did),
+ * bilinear uses half-pixel centers, area averages covered pixels (bilinear when enlarging).
+ */
+enum class ResizeMode { NEAREST, BILINEAR, AREA };
+
+static bool parseResizeMode(const std::string& name, ResizeMode& mode) {
+    if (name.empty() || name == "nearest") {
+        mode = ResizeMode::NEAREST;
+    } else if (name == "bilinear") {
+        mode = ResizeMode::BILINEAR;
+    } else if (name == "area") {
+        mode = ResizeMode::AREA;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Fixed-point bilinear weights: 11 bits per axis, so 255 * 2^22 still fits in int32
+static const int RESIZE_BITS = 11;
+static const int RESIZE_ONE = 1 << RESIZE_BITS;
+
+// Minimum rows per thread of resize kernels
+static const int RESIZE_MIN_ROWS = 16;
+
+/**
+ * Source rows of interleaved 8-bit pixels, row y starts at data + y * stride.
+ * Strides let the resize write into a region of a larger image (letterbox).
+ */
+struct PixelRows {
+    const uint8_t* data;
+    int width;
+    int height;
+    size_t stride;
+};
+
+static void resizeNearest(const PixelRows& src, uint8_t* dst, int dst_w, int dst_h, size_t dst_stride, int channels) {
+    std::vector<int> xofs(dst_w);
+    for (int x = 0; x < dst_w; x++) {
+        xofs[x] = (x * src.width) / dst_w * channels;
+    }
+    
+    parallelFor(dst_h, RESIZE_MIN_ROWS, [&](int y0, int y1) {
+        for (int y = y0; y < y1; y++) {
+            const uint8_t* s = src.data + static_cast<size_t>((y * src.height) / dst_h) * src.stride;
+            uint8_t* d = dst + static_cast<size_t>(y) * dst_stride;
+            switch (channels) {
+            case 1:
+                for (int x = 0; x < dst_w; x++) d[x] = s[xofs[x]];
+                break;
+            case 3:
+                for (int x = 0; x < dst_w; x++) {
+                    const uint8_t* p = s + xofs[x];
+                    d[x * 3 + 0] = p[0];
+                    d[x * 3 + 1] = p[1];
+                    d[x * 3 + 2] = p[2];
+                }
+                break;
+            default:
+                for (int x = 0; x < dst_w; x++) {
+                    std::memcpy(d + x * channels, s + xofs[x], channels);
+                }
+                break;
+            }
+        }
+    });
+}
+
+/**
+ * Bilinear taps along one axis: source indices i0/i1 and fixed-point weight of i1.
+ */
+static void bilinearTaps(int src_len, int dst_len, std::vector<int>& i0, std::vector<int>& i1, std::vector<int>& w) {
+    i0.resize(dst_len);
+    i1.resize(dst_len);
+    w.resize(dst_len);
+    double scale = static_cast<double>(src_len) / dst_len;
+    for (int d = 0; d < dst_len; d++) {
+        double f = (d + 0.5) * scale - 0.5;
+        int i = static_cast<int>(std::floor(f));
+        double a = f - i;
+        if (i < 0) {
+            i = 0;
+            a = 0;
+        }
+        if (i >= src_len - 1) {
+            i = src_len - 1;
+            a = 0;
+        }
+        i0[d] = i;
+        i1[d] = std::min(i + 1, src_len - 1);
+        w[d] = static_cast<int>(std::lround(a * RESIZE_ONE));
+    }
+}
+
+/**
+ * Horizontal bilinear pass of one source row into fixed-point values (8.11 bits).
+ * C is the channel count known at compile time, or 0 to use channels.
+ */
+template <int C>
+static void bilinearRow(const uint8_t* s, int32_t* out, int dst_w, int channels,
+                        const int* xofs0, const int* xofs1, const int* ax) {
+    const int ch = C ? C : channels;
+    for (int x = 0; x < dst_w; x++) {
+        const uint8_t* p0 = s + xofs0[x];
+        const uint8_t* p1 = s + xofs1[x];
+        int32_t a = ax[x];
+        int32_t b = RESIZE_ONE - a;
+        for (int c = 0; c < ch; c++) {
+            out[x * ch + c] = p0[c] * b + p1[c] * a;
+        }
+    }
+}
+
+/**
+ * Vertical bilinear pass: blend two horizontal rows and round back to 8 bits, 8 values per vector.
+ */
+static void bilinearColumn(const int32_t* r0, const int32_t* r1, uint8_t* d, size_t n, int by) {
+    const int32_t w1 = by;
+    const int32_t w0 = RESIZE_ONE - by;
+    const int shift = 2 * RESIZE_BITS;
+    const int32_t round = 1 << (shift - 1);
+    
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        Int8 a, b;
+        std::memcpy(&a, r0 + i, sizeof(a));
+        std::memcpy(&b, r1 + i, sizeof(b));
+        Int8 v = (a * w0 + b * w1 + round) >> shift;
+        Byte8 out = __builtin_convertvector(v, Byte8);
+        std::memcpy(d + i, &out, sizeof(out));
+    }
+    for (; i < n; i++) {
+        d[i] = static_cast<uint8_t>((r0[i] * w0 + r1[i] * w1 + round) >> shift);
+    }
+}
+
+static void resizeBilinear(const PixelRows& src, uint8_t* dst, int dst_w, int dst_h, size_t dst_stride, int channels) {
+    std::vector<int> x0, x1, ax, y0, y1, ay;
+    bilinearTaps(src.width, dst_w, x0, x1, ax);
+    bilinearTaps(src.height, dst_h, y0, y1, ay);
+    for (int x = 0; x < dst_w; x++) {
+        x0[x] *= channels;
+        x1[x] *= channels;
+    }
+    
+    auto horizontal = channels == 1 ? &bilinearRow<1>
+        : channels == 3 ? &bilinearRow<3>
+        : channels == 4 ? &bilinearRow<4>
+        : &bilinearRow<0>;
+    
+    parallelFor(dst_h, RESIZE_MIN_ROWS, [&](int row_begin, int row_end) {
+        // Two cached horizontal rows, consecutive output rows mostly share source rows
+        size_t row_len = static_cast<size_t>(dst_w) * channels;
+        std::vector<int32_t> buffer(row_len * 2);
+        int32_t* rows[2] = { buffer.data(), buffer.data() + row_len };
+        int cached[2] = { -1, -1 };
+        
+        for (int y = row_begin; y < row_end; y++) {
+            if (cached[0] != y0[y]) {
+                if (cached[1] == y0[y]) {
+                    std::swap(rows[0], rows[1]);
+                    std::swap(cached[0], cached[1]);
+                } else {
+                    horizontal(src.data + y0[y] * src.stride, rows[0], dst_w, channels, x0.data(), x1.data(), ax.data());
+                    cached[0] = y0[y];
+                }
+            }
+            if (cached[1] != y1[y]) {
+                horizontal(src.data + y1[y] * src.stride, rows[1], dst_w, channels, x0.data(), x1.data(), ax.data());
+                cached[1] = y1[y];
+            }
+            bilinearColumn(rows[0], rows[1], dst + static_cast<size_t>(y) * dst_stride, row_len, ay[y]);
+        }
+    });
+}
+
+/**
+ * Area taps along one axis: dst index, src index and covered fraction, ordered by dst.
+ */
+struct AreaTap {
+    int dst;
+    int src;
+    float weight;
+};
+
+static std::vector<AreaTap> areaTaps(int src_len, int dst_len) {
+    std::vector<AreaTap> taps;
+    double scale = static_cast<double>(src_len) / dst_len;
+    for (int d = 0; d < dst_len; d++) {
+        double f0 = d * scale;
+        double f1 = std::min((d + 1) * scale, static_cast<double>(src_len));
+        for (int s = static_cast<int>(f0); s < f1; s++) {
+            double covered = std::min(f1, s + 1.0) - std::max(f0, static_cast<double>(s));
+            if (covered > 1e-9) {
+                taps.push_back({ d, s, static_cast<float>(covered / scale) });
+            }
+        }
+    }
+    return taps;
+}
+
+/**
+ * Add one source row, weighted by wy, to the area accumulator row.
+ * C is the channel count known at compile time, or 0 to use channels.
+ */
+template <int C>
+static void areaRow(const uint8_t* s, float* acc, int channels, const std::vector<AreaTap>& xtaps, float wy) {
+    const int ch = C ? C : channels;
+    for (const AreaTap& tap : xtaps) {
+        float w = wy * tap.weight;
+        float* out = acc + static_cast<size_t>(tap.dst) * ch;
+        const uint8_t* p = s + static_cast<size_t>(tap.src) * ch;
+        for (int c = 0; c < ch; c++) {
+            out[c] += w * p[c];
+        }
+    }
+}
+
+static void resizeArea(const PixelRows& src, uint8_t* dst, int dst_w, int dst_h, size_t dst_stride, int channels) {
+    std::vector<AreaTap> xtaps = areaTaps(src.width, dst_w);
+    std::vector<AreaTap> ytaps = areaTaps(src.height, dst_h);
+    
+    // ytaps of dst row y are [ybegin[y], ybegin[y + 1])
+    std::vector<size_t> ybegin(dst_h + 1, ytaps.size());
+    for (size_t i = ytaps.size(); i-- > 0;) {
+        ybegin[ytaps[i].dst] = i;
+    }
+    
+    auto accumulate = channels == 1 ? &areaRow<1>
+        : channels == 3 ? &areaRow<3>
+        : channels == 4 ? &areaRow<4>
+        : &areaRow<0>;
+    
+    parallelFor(dst_h, RESIZE_MIN_ROWS, [&](int row_begin, int row_end) {
+        size_t row_len = static_cast<size_t>(dst_w) * channels;
+        std::vector<float> acc(row_len);
+        
+        for (int y = row_begin; y < row_end; y++) {
+            std::fill(acc.begin(), acc.end(), 0.0f);
+            for (size_t t = ybegin[y]; t < ybegin[y + 1]; t++) {
+                const uint8_t* s = src.data + static_cast<size_t>(ytaps[t].src) * src.stride;
+                accumulate(s, acc.data(), channels, xtaps, ytaps[t].weight);
+            }
+            uint8_t* d = dst + static_cast<size_t>(y) * dst_stride;
+            for (size_t i = 0; i < row_len; i++) {
+                d[i] = static_cast<uint8_t>(std::min(255.0f, acc[i] + 0.5f));
+            }
+        }
+    });
+}
+
+/**
+ * Resize interleaved 8-bit pixels of any channel count into dst rows of dst_stride bytes.
+ * Column offsets and weights are computed once, rows are split across the thread pool.
+ */
+static void resizePixels(const PixelRows& src, uint8_t* dst, int dst_w, int dst_h, size_t dst_stride,
+                         int channels, ResizeMode mode) {
+    if (dst_w <= 0 || dst_h <= 0 || src.width <= 0 || src.height <= 0) return;
+    
+    if (mode == ResizeMode::AREA && (dst_w > src.width || dst_h > src.height)) {
+        mode = ResizeMode::BILINEAR;
+    }
+    switch (mode) {
+    case ResizeMode::NEAREST:
+        resizeNearest(src, dst, dst_w, dst_h, dst_stride, channels);
+        break;
+    case ResizeMode::BILINEAR:
+        resizeBilinear(src, dst, dst_w, dst_h, dst_stride, channels);
+        break;
+    case ResizeMode::AREA:
+        resizeArea(src, dst, dst_w, dst_h, dst_stride, channels);
+        break;
+    }
+}
+
+static PixelRows pixelRows(const Image& img) {
+    return PixelRows{ img.data(), img.getWidth(), img.getHeight(), img.stride() };
+}
+
+/**
+ * Options of FrameReader. width/height/channels describe raw files, which have no header.
+ */
+struct FrameReaderOptions {
+    int width = 0;
+    int height = 0;
+    int channels = 3;
+    bool bgr = false;                    // convert frames to 3-channel BGR (copy) instead of aliasing
+    size_t readahead = 32 << 20;         // bytes read ahead of the current frame, 0 to disable
+};
+
 /**
- * Read image from file path.
- * Stub implementation - returns dummy image for testing.
+ * Frame stream over a memory-mapped file, without third-party codecs:
+ * - PPM (P6) and PGM (P5) with 8-bit samples, one image or several concatenated
+ * - Y4M (YUV4MPEG2) 8-bit video, mono, 4:2:0, 4:2:2 or 4:4:4
+ * - raw frames of width x height x channels bytes, back to back
+ *
+ * Frames are Images aliasing the mapping (see Image::wrapReadOnly): PPM gives RGB, PGM and
+ * raw give the stored channels, Y4M gives the luma plane. Writing a frame copies it first.
+ * With bgr = true every frame is converted into a new 3-channel BGR Image instead.
+ *
+ * The whole file is advised sequential, and a readahead window in front of the current
+ * frame is requested with MADV_WILLNEED, so a replay streams at disk bandwidth.
+ */
+class FrameReader {
+public:
+    enum class Format { RAW, PNM, Y4M };
+    
+    explicit FrameReader(const std::string& path, const FrameReaderOptions& options = FrameReaderOptions())
+        : options_(options) {
+        mapping_ = TensorMapping::open(path, TensorMapMode::READ_ONLY, TensorMapAdvice::SEQUENTIAL);
+        bytes_ = static_cast<const uint8_t*>(mapping_->data());
+        nbytes_ = mapping_->nbytes();
+        
+        if (options.width > 0 || options.height > 0) {
+            indexRaw();
+        } else if (startsWith(0, "YUV4MPEG2")) {
+            indexY4M();
+        } else if (startsWith(0, "P5") || startsWith(0, "P6")) {
+            indexPNM();
+        } else {
+            throw std::runtime_error("FrameReader: '" + path + "' is not PPM/PGM/Y4M, give width and height for raw frames");
+        }
+    }
+    
+    /**
+     * True if path has an extension FrameReader decodes (.ppm .pgm .pnm .y4m)
+     */
+    static bool isSupportedPath(const std::string& path) {
+        size_t dot = path.rfind('.');
+        if (dot == std::string::npos) return false;
+        std::string ext = path.substr(dot + 1);
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+        return ext == "ppm" || ext == "pgm" || ext == "pnm" || ext == "y4m";
+    }
+    
+    // Size of the Images returned
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    int getChannels() const { return options_.bgr ? 3 : channels_; }
+    
+    int count() const { return static_cast<int>(frames_.size()); }
+    int position() const { return position_; }
+    
+    std::string format() const {
+        switch (format_) {
+            case Format::PNM: return "pnm";
+            case Format::Y4M: return "y4m";
+            default: return "raw";
+        }
+    }
+    
+    /**
+     * Frame at 0-based index
+     *
+     * @throws std::out_of_range if index is outside the stream
+     */
+    Image frame(int index) {
+        if (index < 0 || index >= count()) {
+            throw std::out_of_range("FrameReader: frame index out of range");
+        }
+        prefetch(index);
+        const uint8_t* data = bytes_ + frames_[index];
+        if (options_.bgr) {
+            return convertBGR(data);
+        }
+        return Image::wrapReadOnly(data, width_, height_, channels_, static_cast<size_t>(width_) * channels_, mapping_);
+    }
+    
+    /**
+     * Move the stream to 0-based index, count() is the end
+     */
+    void seek(int index) {
+        if (index < 0 || index > count()) {
+            throw std::out_of_range("FrameReader: seek index out of range");
+        }
+        position_ = index;
+    }
+    
+    /**
+     * Lua: reader:next() - next frame as Image, nil at end of stream
+     */
+    int next(lua_State* L) {
+        if (position_ >= count()) {
+            lua_pushnil(L);
+            return 1;
+        }
+        Lua::push(L, frame(position_++));
+        return 1;
+    }
+
+private:
+    bool startsWith(size_t pos, const char* text) const {
+        size_t len = std::strlen(text);
+        return pos + len <= nbytes_ && std::memcmp(bytes_ + pos, text, len) == 0;
+    }
+    
+    void addFrame(size_t offset, size_t frame_bytes) {
+        if (frame_bytes > nbytes_ - offset) {
+            throw std::runtime_error("FrameReader: '" + mapping_->path() + "' ends inside a frame");
+        }
+        frames_.push_back(offset);
+    }
+    
+    void indexRaw() {
+        if (options_.width <= 0 || options_.height <= 0 || options_.channels <= 0) {
+            throw std::runtime_error("FrameReader: raw frames need positive width, height and channels");
+        }
+        format_ = Format::RAW;
+        width_ = options_.width;
+        height_ = options_.height;
+        channels_ = options_.channels;
+        size_t frame_bytes = static_cast<size_t>(width_) * height_ * channels_;
+        if (nbytes_ % frame_bytes != 0) {
+            throw std::runtime_error("FrameReader: raw file size is not a multiple of the frame size");
+        }
+        for (size_t offset = 0; offset < nbytes_; offset += frame_bytes) {
+            frames_.push_back(offset);
+        }
+    }
+    
+    // PNM header field: skip whitespace and # comments, then a decimal number
+    int pnmNumber(size_t& pos) const {
+        for (;;) {
+            while (pos < nbytes_ && std::isspace(bytes_[pos])) pos++;
+            if (pos < nbytes_ && bytes_[pos] == '#') {
+                while (pos < nbytes_ && bytes_[pos] != '\n') pos++;
+                continue;
+            }
+            break;
+        }
+        long value = 0;
+        size_t start = pos;
+        while (pos < nbytes_ && std::isdigit(bytes_[pos]) && value <= 1000000) {
+            value = value * 10 + (bytes_[pos++] - '0');
+        }
+        if (pos == start || value > 1000000) {
+            throw std::runtime_error("FrameReader: invalid PNM header in '" + mapping_->path() + "'");
+        }
+        return static_cast<int>(value);
+    }
+    
+    void indexPNM() {
+        format_ = Format::PNM;
+        size_t pos = 0;
+        while (pos < nbytes_) {
+            if (!startsWith(pos, "P5") && !startsWith(pos, "P6")) {
+                throw std::runtime_error("FrameReader: expected P5 or P6 image in '" + mapping_->path() + "'");
+            }
+            int channels = bytes_[pos + 1] == '6' ? 3 : 1;
+            pos += 2;
+            int w = pnmNumber(pos);
+            int h = pnmNumber(pos);
+            int maxval = pnmNumber(pos);
+            if (maxval < 1 || maxval > 255) {
+                throw std::runtime_error("FrameReader: only 8-bit PNM is supported");
+            }
+            if (pos >= nbytes_ || !std::isspace(bytes_[pos])) {
+                throw std::runtime_error("FrameReader: invalid PNM header in '" + mapping_->path() + "'");
+            }
+            pos++;   // single whitespace before raster
+            
+            if (frames_.empty()) {
+                width_ = w;
+                height_ = h;
+                channels_ = channels;
+            } else if (w != width_ || h != height_ || channels != channels_) {
+                throw std::runtime_error("FrameReader: images in one PNM stream must have the same size and type");
+            }
+            size_t frame_bytes = static_cast<size_t>(w) * h * channels;
+            addFrame(pos, frame_bytes);
+            pos += frame_bytes;
+            while (pos < nbytes_ && std::isspace(bytes_[pos])) pos++;
+        }
+        if (frames_.empty() || width_ <= 0 || height_ <= 0) {
+            throw std::runtime_error("FrameReader: empty PNM image in '" + mapping_->path() + "'");
+        }
+    }
+    
+    // End of the line starting at pos (index of '\n')
+    size_t lineEnd(size_t pos) const {
+        const void* nl = std::memchr(bytes_ + pos, '\n', nbytes_ - pos);
+        if (!nl) {
+            throw std::runtime_error("FrameReader: truncated Y4M header in '" + mapping_->path() + "'");
+        }
+        return static_cast<const uint8_t*>(nl) - bytes_;
+    }
+    
+    // Y4M W/H header field: decimal number in 1..1000000, like pnmNumber
+    int y4mDimension(const std::string& token) const {
+        long value = 0;
+        size_t pos = 1;
+        while (pos < token.size() && std::isdigit(static_cast<unsigned char>(token[pos])) && value <= 1000000) {
+            value = value * 10 + (token[pos++] - '0');
+        }
+        if (pos == 1 || pos != token.size() || value < 1 || value > 1000000) {
+            throw std::runtime_error("FrameReader: invalid Y4M frame size " + token + " in '" + mapping_->path() + "'");
+        }
+        return static_cast<int>(value);
+    }
+    
+    void indexY4M() {
+        format_ = Format::Y4M;
+        size_t end = lineEnd(0);
+        std::string header(reinterpret_cast<const char*>(bytes_), end);
+        std::string colorspace = "420jpeg";
+        
+        size_t start = header.find(' ');
+        while (start != std::string::npos) {
+            size_t stop = header.find(' ', start + 1);
+            std::string token = header.substr(start + 1, stop == std::string::npos ? std::string::npos : stop - start - 1);
+            start = stop;
+            if (token.empty()) continue;
+            switch (token[0]) {
+                case 'W': width_ = y4mDimension(token); break;
+                case 'H': height_ = y4mDimension(token); break;
+                case 'C': colorspace = token.substr(1); break;
+                case 'X': if (token == "XCOLORRANGE=FULL") full_range_ = true; break;
+                default: break;
+            }
+        }
+        if (width_ <= 0 || height_ <= 0) {
+            throw std::runtime_error("FrameReader: Y4M header has no frame size");
+        }
+        
+        size_t luma = static_cast<size_t>(width_) * height_;
+        size_t cw = (width_ + 1) / 2, ch = (height_ + 1) / 2;
+        if (colorspace == "420" || colorspace == "420jpeg" || colorspace == "420paldv" || colorspace == "420mpeg2") {
+            chroma_w_ = static_cast<int>(cw);
+            chroma_h_ = static_cast<int>(ch);
+        } else if (colorspace == "422") {
+            chroma_w_ = static_cast<int>(cw);
+            chroma_h_ = height_;
+        } else if (colorspace == "444") {
+            chroma_w_ = width_;
+            chroma_h_ = height_;
+        } else if (colorspace != "mono") {
+            throw std::runtime_error("FrameReader: unsupported Y4M colorspace " + colorspace + ", only 8-bit is supported");
+        }
+        channels_ = 1;
+        
+        size_t frame_bytes = luma + 2 * static_cast<size_t>(chroma_w_) * chroma_h_;
+        size_t pos = end + 1;
+        while (pos < nbytes_) {
+            if (!startsWith(pos, "FRAME")) {
+                throw std::runtime_error("FrameReader: expected FRAME in '" + mapping_->path() + "'");
+            }
+            pos = lineEnd(pos) + 1;
+            addFrame(pos, frame_bytes);
+            pos += frame_bytes;
+        }
+    }
+    
+    /**
+     * Ask the kernel to read the window in front of frame index, once half of the previous
+     * window is consumed
+     */
+    void prefetch(int index) {
+        if (options_.readahead == 0) return;
+        size_t offset = frames_[index];
+        if (offset + options_.readahead / 2 < prefetched_ && offset >= prefetch_start_) return;
+        mapping_->advise(TensorMapAdvice::WILLNEED, offset, options_.readahead);
+        prefetch_start_ = offset;
+        prefetched_ = offset + options_.readahead;
+    }
+    
+    Image convertBGR(const uint8_t* data) const {
+        Image out = Image::uninitialized(width_, height_, 3);
+        uint8_t* dst = out.data();
+        const size_t pixels = static_cast<size_t>(width_) * height_;
+        
+        const int C = channels_;
+        if (format_ == Format::Y4M) {
+            convertYUV(data, dst);
+        } else if (C >= 3) {
+            // PPM is RGB, raw is already BGR (extra channels dropped)
+            const int b = format_ == Format::PNM ? 2 : 0;
+            for (size_t i = 0; i < pixels; i++) {
+                dst[i * 3 + 0] = data[i * C + b];
+                dst[i * 3 + 1] = data[i * C + 1];
+                dst[i * 3 + 2] = data[i * C + 2 - b];
+            }
+        } else {
+            // gray, the first channel of 2-channel raw
+            for (size_t i = 0; i < pixels; i++) {
+                uint8_t v = data[i * C];
+                dst[i * 3 + 0] = v;
+                dst[i * 3 + 1] = v;
+                dst[i * 3 + 2] = v;
+            }
+        }
+        return out;
+    }
+    
+    /**
+     * BT.601 YUV to BGR in 8.8 fixed point, limited (video) range unless XCOLORRANGE=FULL
+     */
+    void convertYUV(const uint8_t* y_plane, uint8_t* dst) const {
+        const uint8_t* u_plane = y_plane + static_cast<size_t>(width_) * height_;
+        const uint8_t* v_plane = u_plane + static_cast<size_t>(chroma_w_) * chroma_h_;
+        const int W = width_;
+        const bool mono = chroma_w_ == 0;
+        const int xshift = chroma_w_ == width_ ? 0 : 1;
+        const int yshift = chroma_h_ == height_ ? 0 : 1;
+        
+        // limited: 255/219 on luma, 255/224 on chroma
+        const int ky = full_range_ ? 256 : 298;
+        const int y0 = full_range_ ? 0 : 16;
+        const int kr = full_range_ ? 359 : 409;
+        const int kgu = full_range_ ? 88 : 100;
+        const int kgv = full_range_ ? 183 : 208;
+        const int kb = full_range_ ? 454 : 516;
+        auto clamp = [](int v) { return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v)); };
+        
+        parallelFor(height_, 16, [&](int row0, int row1) {
+            for (int y = row0; y < row1; y++) {
+                const uint8_t* ys = y_plane + static_cast<size_t>(y) * W;
+                const uint8_t* us = mono ? nullptr : u_plane + static_cast<size_t>(y >> yshift) * chroma_w_;
+                const uint8_t* vs = mono ? nullptr : v_plane + static_cast<size_t>(y >> yshift) * chroma_w_;
+                uint8_t* out = dst + static_cast<size_t>(y) * W * 3;
+                for (int x = 0; x < W; x++) {
+                    int c = (ys[x] - y0) * ky;
+                    int d = mono ? 0 : us[x >> xshift] - 128;
+                    int e = mono ? 0 : vs[x >> xshift] - 128;
+                    out[x * 3 + 0] = clamp((c + kb * d + 128) >> 8);
+                    out[x * 3 + 1] = clamp((c - kgu * d - kgv * e + 128) >> 8);
+                    out[x * 3 + 2] = clamp((c + kr * e + 128) >> 8);
+                }
+            }
+        });
+    }
+
+private:
+    FrameReaderOptions options_;
+    std::shared_ptr<TensorMapping> mapping_;
+    const uint8_t* bytes_ = nullptr;
+    size_t nbytes_ = 0;
+    Format format_ = Format::RAW;
+    int width_ = 0;
+    int height_ = 0;
+    int channels_ = 0;
+    int chroma_w_ = 0;
+    int chroma_h_ = 0;
+    bool full_range_ = false;
+    std::vector<size_t> frames_;
+    int position_ = 0;
+    size_t prefetch_start_ = 0;
+    size_t prefetched_ = 0;
+};
+
+/**
+ * Open frame stream, see FrameReader.
+ * Usage: openFrames(path [, {width=, height=, channels=3, bgr=false, readahead=32 MB}])
+ */
+FrameReader openFrames(const std::string& path, lua_State* L) {
+    FrameReaderOptions options;
+    if (lua_istable(L, 2)) {
+        LuaRef opts(L, 2);
+        options.width = opts.get("width", options.width);
+        options.height = opts.get("height", options.height);
+        options.channels = opts.get("channels", options.channels);
+        options.bgr = opts.get("bgr", options.bgr);
+        lua_Number readahead = opts.get("readahead", lua_Number(options.readahead));
+        options.readahead = readahead > 0 ? static_cast<size_t>(readahead) : 0;
+    } else if (!lua_isnoneornil(L, 2)) {
+        throw std::runtime_error("openFrames: options must be a table");
+    }
+    return FrameReader(path, options);
+}
+
+/**
+ * Read image from file path as BGR.
+ * PPM/PGM/PNM decode the first image and Y4M the first frame (see FrameReader).
+ * TODO: other formats need an image decoding library; until then they give a 640x480
+ * test gradient, without touching the file.
  */
 Image imread(const std::string& path) {
-    // TODO: Real implementation with image decoding library
-    // For now, create a 640x480 dummy BGR image
-    Image img(640, 480, 3);
+    if (FrameReader::isSupportedPath(path)) {
+        FrameReaderOptions options;
+        options.bgr = true;
+        options.readahead = 0;
+        FrameReader reader(path, options);
+        if (reader.count() == 0) {
+            throw std::runtime_error("imread: no image in '" + path + "'");
+        }
+        return reader.frame(0);
+    }
+    
+    // Create a 640x480 dummy BGR image
+    Image img = Image::uninitialized(640, 480, 3);
     
     // Fill with gradient pattern for testing
     uint8_t* p = img.data();
@@ -34,94 +834,241 @@ Image imread(const std::string& path) {
 }
 
 /**
- * Convert BGR to RGB color space.
- * Swaps B and R channels in-place.
+ * Destination of an image transform, left on top of stack: the optional Image argument at
+ * index, which must be w x h x channels and is returned, otherwise a new Image.
+ * A new Image is not zero filled, the transform must write every pixel.
  */
-Image bgr2rgb(const Image& img) {
-    Image result(img.getWidth(), img.getHeight(), img.getChannels());
+static Image* pushImageOutput(lua_State* L, int index, int w, int h, int channels, const char* name) {
+    if (lua_isnoneornil(L, index)) {
+        Lua::push(L, Image::uninitialized(w, h, channels));
+        return Lua::get<Image*>(L, -1);
+    }
     
-    const uint8_t* src = img.data();
-    uint8_t* dst = result.data();
+    Image* dst = Lua::get<Image*>(L, index);
+    if (!dst) {
+        luaL_error(L, "%s: dst must be Image", name);
+    }
+    if (dst->getWidth() != w || dst->getHeight() != h || dst->getChannels() != channels) {
+        luaL_error(L, "%s: dst must be %dx%dx%d, got %dx%dx%d", name, w, h, channels,
+            dst->getWidth(), dst->getHeight(), dst->getChannels());
+    }
+    lua_pushvalue(L, index);
+    return dst;
+}
+
+/**
+ * True if dst is src itself (the same pixels), for transforms that may run in place
+ */
+static bool samePixels(const Image& src, const Image& dst) {
+    return src.aliases(dst) && src.data() == dst.data() && src.stride() == dst.stride();
+}
+
+/**
+ * In-place transforms accept dst == src, but not views that partly overlap src
+ */
+static void checkOverlap(lua_State* L, const Image& src, const Image& dst, const char* name) {
+    if (src.aliases(dst) && !samePixels(src, dst)) {
+        luaL_error(L, "%s: dst must be the source itself or must not share data with it", name);
+    }
+}
+
+/**
+ * Swap channels 0 and 2 of 3 or 4 channel pixels, dst may be src.
+ */
+static void bgr2rgbInto(const Image& img, Image& result) {
+    const int C = img.getChannels();
+    const int W = img.getWidth();
     
-    size_t pixels = img.getWidth() * img.getHeight();
-    for (size_t i = 0; i < pixels; i++) {
-        dst[i * 3 + 0] = src[i * 3 + 2];  // R
-        dst[i * 3 + 1] = src[i * 3 + 1];  // G
-        dst[i * 3 + 2] = src[i * 3 + 0];  // B
+    for (int y = 0; y < img.getHeight(); y++) {
+        // dst first: a copy-on-write detach must happen before src is read
+        uint8_t* dst = result.row(y);
+        PixelKernels::swapRB(img.row(y), dst, W, C);
+    }
+}
+
+/**
+ * Convert BGR to RGB color space (BGRA to RGBA keeps alpha).
+ * Usage: bgr2rgb(img [, dst]), dst may be img itself to convert in place.
+ * Returns dst if given, otherwise a new Image.
+ * Uses lua_CFunction convention to access lua_State.
+ */
+int bgr2rgb(lua_State* L) {
+    Image* img = Lua::get<Image*>(L, 1);
+    if (!img) {
+        return luaL_error(L, "bgr2rgb: expected Image argument");
+    }
+    if (!img->empty() && img->getChannels() != 3 && img->getChannels() != 4) {
+        return luaL_error(L, "bgr2rgb: expected 3 or 4 channel image");
     }
     
-    return result;
+    Image* dst = pushImageOutput(L, 2, img->getWidth(), img->getHeight(), img->getChannels(), "bgr2rgb");
+    checkOverlap(L, *img, *dst, "bgr2rgb");
+    bgr2rgbInto(*img, *dst);
+    return 1;
+}
+
+/**
+ * Letterbox placement of a src_w x src_h image in a target_w x target_h canvas.
+ */
+struct LetterboxGeometry {
+    float scale;
+    int src_w, src_h;
+    int new_w, new_h;
+    int pad_top, pad_left, pad_bottom, pad_right;
+};
+
+static LetterboxGeometry letterboxGeometry(int src_w, int src_h, int target_w, int target_h) {
+    LetterboxGeometry g;
+    g.src_w = src_w;
+    g.src_h = src_h;
+    g.scale = std::min(
+        static_cast<float>(target_w) / src_w,
+        static_cast<float>(target_h) / src_h
+    );
+    
+    g.new_w = static_cast<int>(src_w * g.scale);
+    g.new_h = static_cast<int>(src_h * g.scale);
+    
+    g.pad_left = (target_w - g.new_w) / 2;
+    g.pad_top = (target_h - g.new_h) / 2;
+    g.pad_right = target_w - g.new_w - g.pad_left;
+    g.pad_bottom = target_h - g.new_h - g.pad_top;
+    return g;
+}
+
+/**
+ * Build pad table {top=N, left=N, bottom=N, right=N, orig_w=N, orig_h=N, new_w=N, new_h=N},
+ * orig is the source image size and new the resized image inside the padding,
+ * enough for PostLib.scaleBoxes to map boxes back to the source image
+ */
+static LuaRef padTable(lua_State* L, const LetterboxGeometry& g) {
+    LuaRef pad_info = LuaRef::createTable(L, 0, 8);
+    pad_info.set("top", g.pad_top);
+    pad_info.set("left", g.pad_left);
+    pad_info.set("bottom", g.pad_bottom);
+    pad_info.set("right", g.pad_right);
+    pad_info.set("orig_w", g.src_w);
+    pad_info.set("orig_h", g.src_h);
+    pad_info.set("new_w", g.new_w);
+    pad_info.set("new_h", g.new_h);
+    return pad_info;
 }
 
 /**
  * Apply letterbox padding to resize image while maintaining aspect ratio.
- * Returns table with {image=padded_image, pad={top=N, left=N, bottom=N, right=N}}
+ * Usage: letterbox(img, target_w, target_h [, mode]), mode is "nearest" (default), "bilinear" or "area".
+ * Returns table with {image=padded_image, pad={top=N, left=N, bottom=N, right=N, orig_w=N, orig_h=N,
+ * new_w=N, new_h=N}}, the result or its pad can be passed to PostLib.scaleBoxes.
  * Uses lua_CFunction convention to access lua_State.
  */
 int letterbox(lua_State* L) {
-    // Get arguments: Image, target_w, target_h
+    // Get arguments: Image, target_w, target_h, mode
     Image* img = Lua::get<Image*>(L, 1);
     int target_w = lua_tointeger(L, 2);
     int target_h = lua_tointeger(L, 3);
+    const char* mode_name = luaL_optstring(L, 4, "nearest");
     
     if (!img) {
         return luaL_error(L, "letterbox: expected Image argument");
     }
+    if (img->empty() || img->getWidth() <= 0 || img->getHeight() <= 0) {
+        return luaL_error(L, "letterbox: expected non-empty image");
+    }
+    ResizeMode mode;
+    if (!parseResizeMode(mode_name, mode)) {
+        return luaL_error(L, "letterbox: mode must be nearest, bilinear or area, got %s", mode_name);
+    }
     
-    float scale = std::min(
-        static_cast<float>(target_w) / img->getWidth(),
-        static_cast<float>(target_h) / img->getHeight()
-    );
-    
-    int new_w = static_cast<int>(img->getWidth() * scale);
-    int new_h = static_cast<int>(img->getHeight() * scale);
-    
-    int pad_left = (target_w - new_w) / 2;
-    int pad_top = (target_h - new_h) / 2;
-    int pad_right = target_w - new_w - pad_left;
-    int pad_bottom = target_h - new_h - pad_top;
+    LetterboxGeometry g = letterboxGeometry(img->getWidth(), img->getHeight(), target_w, target_h);
     
     // Create padded image with gray background (114)
-    Image padded(target_w, target_h, img->getChannels());
+    Image padded = Image::uninitialized(target_w, target_h, img->getChannels());
     std::memset(padded.data(), 114, padded.size());
     
-    // Simple nearest-neighbor resize and copy
-    const uint8_t* src = img->data();
-    uint8_t* dst = padded.data();
-    
-    for (int y = 0; y < new_h; y++) {
-        for (int x = 0; x < new_w; x++) {
-            int src_x = (x * img->getWidth()) / new_w;
-            int src_y = (y * img->getHeight()) / new_h;
-            
-            int src_idx = (src_y * img->getWidth() + src_x) * 3;
-            int dst_idx = ((y + pad_top) * target_w + (x + pad_left)) * 3;
-            
-            dst[dst_idx + 0] = src[src_idx + 0];
-            dst[dst_idx + 1] = src[src_idx + 1];
-            dst[dst_idx + 2] = src[src_idx + 2];
-        }
-    }
+    // Resize into the region inside padding
+    int channels = img->getChannels();
+    Image region = padded.roi(g.pad_left, g.pad_top, g.new_w, g.new_h);
+    resizePixels(pixelRows(*img), region.data(), g.new_w, g.new_h, region.stride(), channels, mode);
     
     // Build return table {image=..., pad={...}}
     LuaRef result = LuaRef::createTable(L);
     result.set("image", padded);
-    
-    LuaRef pad_info = LuaRef::createTable(L);
-    pad_info.set("top", pad_top);
-    pad_info.set("left", pad_left);
-    pad_info.set("bottom", pad_bottom);
-    pad_info.set("right", pad_right);
-    
-    result.set("pad", pad_info);
+    result.set("pad", padTable(L, g));
     
     result.pushToStack();
     return 1;
 }
 
+// YOLOv5 normalization parameters
+static const float NORM_MEAN[] = {0.485f, 0.456f, 0.406f};
+static const float NORM_STD[] = {0.229f, 0.224f, 0.225f};
+
+/**
+ * Fold (v / 255 - mean) / std into one multiply-add per value: v * scale + bias
+ */
+static void normalizeParams(const float* mean, const float* std, float* scale, float* bias) {
+    for (int c = 0; c < 3; c++) {
+        scale[c] = 1.0f / (255.0f * std[c]);
+        bias[c] = -mean[c] / std[c];
+    }
+}
+
+/**
+ * Normalize interleaved 3-channel pixels into planar CHW layout, one row at a time.
+ */
+static void normalizeCHW(const uint8_t* src, size_t stride, float* dst, int H, int W) {
+    float scale[3], bias[3];
+    normalizeParams(NORM_MEAN, NORM_STD, scale, bias);
+    
+    size_t plane_size = static_cast<size_t>(H) * W;
+    for (int h = 0; h < H; h++) {
+        float* planes[3];
+        for (int c = 0; c < 3; c++) {
+            planes[c] = dst + c * plane_size + static_cast<size_t>(h) * W;
+        }
+        PixelKernels::normalizePlanar(src + h * stride, planes, W, scale, bias);
+    }
+}
+
+/**
+ * Get output buffer for normalize/hwc2chw and leave the result object on top of stack.
+ * The optional argument at index may be a Tensor or FloatTensorView with the same number
+ * of elements, which is reused and returned; otherwise a new Tensor of shape is returned.
+ * Tensor and FloatTensorView are registered by PostLib.
+ */
+static float* pushOutput(lua_State* L, int index, const std::vector<int>& shape, const char* name) {
+    size_t len = 1;
+    for (int dim : shape) len *= dim;
+    
+    if (lua_isnoneornil(L, index)) {
+        Tensor tensor(shape);
+        Lua::push(L, tensor);
+        return tensor.data();
+    }
+    
+    float* data = nullptr;
+    size_t dst_len = 0;
+    if (Tensor* tensor = CppObject::cast<Tensor>(L, index, true)) {
+        data = tensor->data();
+        dst_len = tensor->length();
+    } else if (TensorView<float>* view = CppObject::cast<TensorView<float>>(L, index, true)) {
+        data = view->data();
+        dst_len = view->size();
+    } else {
+        luaL_error(L, "%s: dst must be Tensor or FloatTensorView, got %s", name, luaL_typename(L, index));
+    }
+    
+    if (dst_len != len) {
+        luaL_error(L, "%s: dst has %d elements, expected %d", name, int(dst_len), int(len));
+    }
+    lua_pushvalue(L, index);
+    return data;
+}
+
 /**
  * Normalize image pixels: (pixel / 255.0 - mean) / std
- * Returns Lua table of flattened float array (still HWC order).
+ * Usage: normalize(img [, dst]), writes float tensor of shape {H, W, 3} (still HWC order).
+ * Returns dst if given, otherwise a new Tensor; empty image gives empty tensor.
  * Uses lua_CFunction convention to access lua_State.
  */
 int normalize(lua_State* L) {
@@ -133,44 +1080,33 @@ int normalize(lua_State* L) {
     
     // Check for empty image
     if (img->empty() || img->getWidth() <= 0 || img->getHeight() <= 0) {
-        // Return empty table for empty image
-        LuaRef result = LuaRef::createTable(L);
-        result.pushToStack();
+        pushOutput(L, 2, {0, 0, 3}, "normalize");
         return 1;
     }
-    
-    // YOLOv5 normalization parameters
-    const float mean[] = {0.485f, 0.456f, 0.406f};
-    const float std[] = {0.229f, 0.224f, 0.225f};
-    
-    std::vector<float> data;
-    data.reserve(img->size());
-    
-    const uint8_t* src = img->data();
-    size_t pixels = img->getWidth() * img->getHeight();
-    
-    for (size_t i = 0; i < pixels; i++) {
-        for (int c = 0; c < 3; c++) {
-            float val = src[i * 3 + c] / 255.0f;
-            val = (val - mean[c]) / std[c];
-            data.push_back(val);
-        }
+    if (img->getChannels() != 3) {
+        return luaL_error(L, "normalize: expected 3-channel image");
     }
     
-    // Convert to Lua table
-    LuaRef result = LuaRef::createTable(L);
-    for (size_t i = 0; i < data.size(); i++) {
-        result[i + 1] = data[i];  // Lua uses 1-based indexing
+    int H = img->getHeight();
+    int W = img->getWidth();
+    float* dst = pushOutput(L, 2, {H, W, 3}, "normalize");
+    float scale[3], bias[3];
+    normalizeParams(NORM_MEAN, NORM_STD, scale, bias);
+    const Image& src = *img;
+    if (src.isContinuous()) {
+        PixelKernels::normalize(src.data(), dst, static_cast<size_t>(H) * W, scale, bias);
+    } else {
+        for (int y = 0; y < H; y++) {
+            PixelKernels::normalize(src.row(y), dst + static_cast<size_t>(y) * W * 3, W, scale, bias);
+        }
     }
-    
-    result.pushToStack();
     return 1;
 }
 
 /**
- * Convert HWC (Height-Width-Channel) to CHW (Channel-Height-Width) layout.
- * Input: Image object
- * Output: Lua table of CHW flattened array
+ * Normalize and convert HWC (Height-Width-Channel) to CHW (Channel-Height-Width) layout.
+ * Usage: hwc2chw(img [, dst]), writes float tensor of shape {3, H, W}.
+ * Returns dst if given, otherwise a new Tensor; empty image gives empty tensor.
  * Uses lua_CFunction convention to access lua_State.
  */
 int hwc2chw(lua_State* L) {
@@ -182,159 +1118,525 @@ int hwc2chw(lua_State* L) {
     
     // Check for empty image
     if (img->empty() || img->getWidth() <= 0 || img->getHeight() <= 0) {
-        // Return empty table for empty image
-        LuaRef result = LuaRef::createTable(L);
-        result.pushToStack();
+        pushOutput(L, 2, {3, 0, 0}, "hwc2chw");
         return 1;
     }
+    if (img->getChannels() != 3) {
+        return luaL_error(L, "hwc2chw: expected 3-channel image");
+    }
     
     int H = img->getHeight();
     int W = img->getWidth();
-    int C = img->getChannels();
+    float* dst = pushOutput(L, 2, {3, H, W}, "hwc2chw");
+    const Image& src = *img;
+    normalizeCHW(src.data(), src.stride(), dst, H, W);
+    return 1;
+}
+
+/**
+ * Options of fused preprocess, scale/bias are per output channel.
+ */
+struct PreprocessParams {
+    int width = 640;
+    int height = 640;
+    float scale[3];
+    float bias[3];
+    bool swap_rb = false;
+    bool nchw = true;
+};
+
+/**
+ * Fused letterbox + BGR/RGB swap + normalize + layout for output rows [y0, y1).
+ * Each output row is gathered (nearest-neighbor, channel swapped) into a small byte row
+ * that stays in L1, then written once as float. Padding is written as normalized 114.
+ */
+static void preprocessRows(const Image& img, const LetterboxGeometry& g, const PreprocessParams& p,
+                           const std::vector<int>& src_x, float* dst, int y0, int y1) {
+    const int W = p.width;
+    const size_t plane_size = static_cast<size_t>(W) * p.height;
+    const int src_c[3] = { p.swap_rb ? 2 : 0, 1, p.swap_rb ? 0 : 2 };
     
-    // First normalize the image
-    const float mean[] = {0.485f, 0.456f, 0.406f};
-    const float std[] = {0.229f, 0.224f, 0.225f};
+    float pad_val[3];
+    for (int c = 0; c < 3; c++) {
+        pad_val[c] = 114 * p.scale[c] + p.bias[c];
+    }
     
-    std::vector<float> hwc_data;
-    hwc_data.reserve(H * W * C);
+    std::vector<uint8_t> row(static_cast<size_t>(g.new_w) * 3);
+    for (int y = y0; y < y1; y++) {
+        int ry = y - g.pad_top;
+        bool pad_row = ry < 0 || ry >= g.new_h;
+        int left = pad_row ? W : g.pad_left;
+        int right = pad_row ? W : g.pad_left + g.new_w;
+        
+        if (!pad_row) {
+            int sy = (ry * img.getHeight()) / g.new_h;
+            const uint8_t* src = img.row(sy);
+            if (p.nchw) {
+                for (int c = 0; c < 3; c++) {
+                    uint8_t* out = row.data() + static_cast<size_t>(c) * g.new_w;
+                    for (int x = 0; x < g.new_w; x++) {
+                        out[x] = src[src_x[x] + src_c[c]];
+                    }
+                }
+            } else {
+                for (int x = 0; x < g.new_w; x++) {
+                    row[x * 3 + 0] = src[src_x[x] + src_c[0]];
+                    row[x * 3 + 1] = src[src_x[x] + src_c[1]];
+                    row[x * 3 + 2] = src[src_x[x] + src_c[2]];
+                }
+            }
+        }
+        
+        if (p.nchw) {
+            for (int c = 0; c < 3; c++) {
+                float* out = dst + c * plane_size + static_cast<size_t>(y) * W;
+                std::fill(out, out + left, pad_val[c]);
+                if (!pad_row) {
+                    TensorConvert::convert(TensorDType::U8, row.data() + static_cast<size_t>(c) * g.new_w,
+                        TensorDType::F32, out + left, g.new_w, p.scale[c], p.bias[c]);
+                }
+                std::fill(out + right, out + W, pad_val[c]);
+            }
+        } else {
+            float* out = dst + static_cast<size_t>(y) * W * 3;
+            for (int x = 0; x < left; x++) {
+                std::copy(pad_val, pad_val + 3, out + x * 3);
+            }
+            if (!pad_row) {
+                PixelKernels::normalize(row.data(), out + left * 3, g.new_w, p.scale, p.bias);
+            }
+            for (int x = right; x < W; x++) {
+                std::copy(pad_val, pad_val + 3, out + x * 3);
+            }
+        }
+    }
+}
+
+/**
+ * Read preprocess options table at index, missing fields use defaults.
+ */
+static PreprocessParams readPreprocessParams(lua_State* L, int index) {
+    PreprocessParams p;
+    float mean[3] = { NORM_MEAN[0], NORM_MEAN[1], NORM_MEAN[2] };
+    float std[3] = { NORM_STD[0], NORM_STD[1], NORM_STD[2] };
+    std::string layout = "NCHW";
     
-    const uint8_t* src = img->data();
-    for (size_t i = 0; i < static_cast<size_t>(H * W); i++) {
+    if (lua_istable(L, index)) {
+        LuaRef opts(L, index);
+        p.width = opts.get("w", p.width);
+        p.height = opts.get("h", p.height);
+        p.swap_rb = opts.get("swapRB", p.swap_rb);
+        layout = opts.get("layout", layout);
+        
+        LuaRef mean_ref = opts.get("mean");
+        LuaRef std_ref = opts.get("std");
         for (int c = 0; c < 3; c++) {
-            float val = src[i * 3 + c] / 255.0f;
-            val = (val - mean[c]) / std[c];
-            hwc_data.push_back(val);
+            if (mean_ref.isTable()) mean[c] = mean_ref.rawget(c + 1, mean[c]);
+            if (std_ref.isTable()) std[c] = std_ref.rawget(c + 1, std[c]);
         }
+    } else if (!lua_isnoneornil(L, index)) {
+        luaL_error(L, "preprocess: options must be a table");
     }
     
-    // Then transpose to CHW
-    std::vector<float> chw_data(H * W * C);
-    for (int c = 0; c < C; c++) {
-        for (int h = 0; h < H; h++) {
-            for (int w = 0; w < W; w++) {
-                int hwc_idx = (h * W + w) * C + c;
-                int chw_idx = c * (H * W) + h * W + w;
-                chw_data[chw_idx] = hwc_data[hwc_idx];
-            }
+    if (p.width <= 0 || p.height <= 0) {
+        luaL_error(L, "preprocess: invalid output size %dx%d", p.width, p.height);
+    }
+    if (layout == "NCHW") {
+        p.nchw = true;
+    } else if (layout == "NHWC") {
+        p.nchw = false;
+    } else {
+        luaL_error(L, "preprocess: layout must be NCHW or NHWC, got %s", layout.c_str());
+    }
+    
+    normalizeParams(mean, std, p.scale, p.bias);
+    return p;
+}
+
+/**
+ * Run preprocessRows for images into consecutive outputs of dst.
+ * Rows of all images are split across the pool together, so a batch scales with cores,
+ * not with the number of images.
+ */
+static void preprocessImages(const std::vector<const Image*>& images, const std::vector<LetterboxGeometry>& geometry,
+                             const PreprocessParams& p, float* dst) {
+    const int H = p.height;
+    const size_t image_len = static_cast<size_t>(3) * p.width * H;
+    
+    // Source byte offset of each output column
+    std::vector<std::vector<int>> src_x(images.size());
+    for (size_t i = 0; i < images.size(); i++) {
+        const LetterboxGeometry& g = geometry[i];
+        src_x[i].resize(g.new_w);
+        for (int x = 0; x < g.new_w; x++) {
+            src_x[i][x] = (x * images[i]->getWidth()) / g.new_w * 3;
+        }
+    }
+    
+    int rows = static_cast<int>(images.size()) * H;
+    parallelFor(rows, 64, [&](int r0, int r1) {
+        // a chunk may span several images
+        while (r0 < r1) {
+            int i = r0 / H;
+            int y0 = r0 % H;
+            int y1 = std::min(H, y0 + (r1 - r0));
+            preprocessRows(*images[i], geometry[i], p, src_x[i], dst + i * image_len, y0, y1);
+            r0 += y1 - y0;
         }
+    });
+}
+
+/**
+ * Fused single-pass preprocessing: letterbox + optional BGR->RGB + normalize + layout.
+ * Usage: preprocess(img, {w=640, h=640, mean={...}, std={...}, swapRB=true, layout="NCHW"} [, dst])
+ * Produces the same values as letterbox -> bgr2rgb -> hwc2chw (or normalize for NHWC),
+ * without any intermediate image.
+ * Returns table with {tensor=Tensor, pad=pad, scale=N}, pad as for letterbox;
+ * tensor has shape {1, 3, h, w} or {1, h, w, 3}, dst is reused if given.
+ * Uses lua_CFunction convention to access lua_State.
+ */
+int preprocess(lua_State* L) {
+    Image* img = Lua::get<Image*>(L, 1);
+    if (!img) {
+        return luaL_error(L, "preprocess: expected Image argument");
     }
+    if (img->empty() || img->getWidth() <= 0 || img->getHeight() <= 0 || img->getChannels() != 3) {
+        return luaL_error(L, "preprocess: expected non-empty 3-channel image");
+    }
+    
+    PreprocessParams p = readPreprocessParams(L, 2);
+    LetterboxGeometry g = letterboxGeometry(img->getWidth(), img->getHeight(), p.width, p.height);
+    
+    std::vector<int> shape = p.nchw
+        ? std::vector<int>{1, 3, p.height, p.width}
+        : std::vector<int>{1, p.height, p.width, 3};
+    float* dst = pushOutput(L, 3, shape, "preprocess");
+    LuaRef tensor = LuaRef::popFromStack(L);
+    preprocessImages({ img }, { g }, p, dst);
     
-    // Convert to Lua table
     LuaRef result = LuaRef::createTable(L);
-    for (size_t i = 0; i < chw_data.size(); i++) {
-        result[i + 1] = chw_data[i];  // Lua uses 1-based indexing
+    result.set("tensor", tensor);
+    result.set("pad", padTable(L, g));
+    result.set("scale", g.scale);
+    
+    result.pushToStack();
+    return 1;
+}
+
+/**
+ * Fused preprocessing of several images into one batch tensor.
+ * Usage: preprocessBatch({img1, img2, ...}, opts [, dst]), opts as for preprocess.
+ * Every image is letterboxed on its own; the images may have different sizes.
+ * Returns table with {tensor=Tensor, pad={pad1, pad2, ...}, scale={scale1, scale2, ...}};
+ * tensor has shape {N, 3, h, w} or {N, h, w, 3}, dst is reused if given.
+ * Uses lua_CFunction convention to access lua_State.
+ */
+int preprocessBatch(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int n = static_cast<int>(lua_rawlen(L, 1));
+    
+    // images stay alive in the table at index 1
+    std::vector<const Image*> images(n);
+    for (int i = 0; i < n; i++) {
+        lua_rawgeti(L, 1, i + 1);
+        Image* img = CppObject::cast<Image>(L, -1, true);
+        lua_pop(L, 1);
+        if (!img) {
+            return luaL_error(L, "preprocessBatch: image %d is not an Image", i + 1);
+        }
+        if (img->empty() || img->getWidth() <= 0 || img->getHeight() <= 0 || img->getChannels() != 3) {
+            return luaL_error(L, "preprocessBatch: image %d must be a non-empty 3-channel image", i + 1);
+        }
+        images[i] = img;
+    }
+    
+    PreprocessParams p = readPreprocessParams(L, 2);
+    std::vector<LetterboxGeometry> geometry(n);
+    for (int i = 0; i < n; i++) {
+        geometry[i] = letterboxGeometry(images[i]->getWidth(), images[i]->getHeight(), p.width, p.height);
     }
     
+    std::vector<int> shape = p.nchw
+        ? std::vector<int>{n, 3, p.height, p.width}
+        : std::vector<int>{n, p.height, p.width, 3};
+    float* dst = pushOutput(L, 3, shape, "preprocessBatch");
+    LuaRef tensor = LuaRef::popFromStack(L);
+    preprocessImages(images, geometry, p, dst);
+    
+    LuaRef pads = LuaRef::createTable(L);
+    LuaRef scales = LuaRef::createTable(L);
+    for (int i = 0; i < n; i++) {
+        pads[i + 1] = padTable(L, geometry[i]);
+        scales[i + 1] = geometry[i].scale;
+    }
+    
+    LuaRef result = LuaRef::createTable(L);
+    result.set("tensor", tensor);
+    result.set("pad", pads);
+    result.set("scale", scales);
+    
     result.pushToStack();
     return 1;
 }
 
 /**
  * Crop image to specified region.
+ * Usage: crop(img, x, y, w, h [, dst]), dst must be w x h with the same channels.
+ *        crop(img, x, y, w, h, true) returns a view sharing pixels with img (see Image:roi).
+ * Returns dst if given, otherwise a new Image.
+ * Uses lua_CFunction convention to access lua_State.
  */
-Image crop(const Image& img, int x, int y, int w, int h) {
-    if (x < 0 || y < 0 || x + w > img.getWidth() || y + h > img.getHeight()) {
-        throw std::runtime_error("crop: region out of bounds");
+int crop(lua_State* L) {
+    Image* img = Lua::get<Image*>(L, 1);
+    int x = static_cast<int>(luaL_checkinteger(L, 2));
+    int y = static_cast<int>(luaL_checkinteger(L, 3));
+    int w = static_cast<int>(luaL_checkinteger(L, 4));
+    int h = static_cast<int>(luaL_checkinteger(L, 5));
+    
+    if (!img) {
+        return luaL_error(L, "crop: expected Image argument");
+    }
+    if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > img->getWidth() || y + h > img->getHeight()) {
+        return luaL_error(L, "crop: region out of bounds");
+    }
+    
+    if (lua_isboolean(L, 6)) {
+        if (!lua_toboolean(L, 6)) {
+            return luaL_error(L, "crop: dst must be Image or true");
+        }
+        Lua::push(L, img->roi(x, y, w, h));
+        return 1;
     }
     
-    Image result(w, h, img.getChannels());
-    const uint8_t* src = img.data();
-    uint8_t* dst = result.data();
+    int C = img->getChannels();
+    Image* result = pushImageOutput(L, 6, w, h, C, "crop");
+    checkOverlap(L, *img, *result, "crop");
     
+    // rows only overlap when dst is img itself, which means the full image
+    const Image& src = *img;
     for (int row = 0; row < h; row++) {
-        const uint8_t* src_row = src + ((y + row) * img.getWidth() + x) * img.getChannels();
-        uint8_t* dst_row = dst + row * w * img.getChannels();
-        std::memcpy(dst_row, src_row, w * img.getChannels());
+        uint8_t* dst_row = result->row(row);
+        const uint8_t* src_row = src.row(y + row) + static_cast<size_t>(x) * C;
+        std::memmove(dst_row, src_row, static_cast<size_t>(w) * C);
     }
-    
-    return result;
+    return 1;
 }
 
 /**
- * Resize image using nearest neighbor interpolation.
+ * Resize image, mode is "nearest" (default), "bilinear" or "area". Works for any channel count.
+ * Usage: resize(img, w, h [, mode [, dst]]), dst must be w x h with the same channels
+ * and must not share data with img.
+ * Returns dst if given, otherwise a new Image.
+ * Uses lua_CFunction convention to access lua_State.
  */
-Image resize(const Image& img, int new_w, int new_h) {
-    Image result(new_w, new_h, img.getChannels());
-    const uint8_t* src = img.data();
-    uint8_t* dst = result.data();
+int resize(lua_State* L) {
+    Image* img = Lua::get<Image*>(L, 1);
+    int new_w = static_cast<int>(luaL_checkinteger(L, 2));
+    int new_h = static_cast<int>(luaL_checkinteger(L, 3));
+    const char* mode_name = luaL_optstring(L, 4, "nearest");
     
-    for (int y = 0; y < new_h; y++) {
-        for (int x = 0; x < new_w; x++) {
-            int src_x = (x * img.getWidth()) / new_w;
-            int src_y = (y * img.getHeight()) / new_h;
-            
-            int src_idx = (src_y * img.getWidth() + src_x) * img.getChannels();
-            int dst_idx = (y * new_w + x) * img.getChannels();
-            
-            for (int c = 0; c < img.getChannels(); c++) {
-                dst[dst_idx + c] = src[src_idx + c];
-            }
-        }
+    if (!img) {
+        return luaL_error(L, "resize: expected Image argument");
+    }
+    ResizeMode mode;
+    if (!parseResizeMode(mode_name, mode)) {
+        return luaL_error(L, "resize: mode must be nearest, bilinear or area, got %s", mode_name);
+    }
+    if (new_w <= 0 || new_h <= 0) {
+        return luaL_error(L, "resize: invalid size");
+    }
+    if (img->empty() || img->getWidth() <= 0 || img->getHeight() <= 0) {
+        return luaL_error(L, "resize: empty image");
     }
     
-    return result;
+    Image* result = pushImageOutput(L, 5, new_w, new_h, img->getChannels(), "resize");
+    if (img->aliases(*result)) {
+        return luaL_error(L, "resize: dst must not share data with source");
+    }
+    uint8_t* dst = result->data();
+    resizePixels(pixelRows(*img), dst, new_w, new_h, result->stride(), img->getChannels(), mode);
+    return 1;
 }
 
 /**
- * Flip image horizontally.
+ * Mirror pixels within each row, dst may be src.
  */
-Image flipHorizontal(const Image& img) {
-    Image result(img.getWidth(), img.getHeight(), img.getChannels());
-    const uint8_t* src = img.data();
-    uint8_t* dst = result.data();
+static void flipHorizontalInto(const Image& img, Image& result) {
+    const int W = img.getWidth();
+    const int C = img.getChannels();
     
+    std::vector<uint8_t> scratch;
     for (int y = 0; y < img.getHeight(); y++) {
-        for (int x = 0; x < img.getWidth(); x++) {
-            int src_idx = (y * img.getWidth() + x) * img.getChannels();
-            int dst_idx = (y * img.getWidth() + (img.getWidth() - 1 - x)) * img.getChannels();
-            
-            for (int c = 0; c < img.getChannels(); c++) {
-                dst[dst_idx + c] = src[src_idx + c];
-            }
+        uint8_t* dst = result.row(y);
+        const uint8_t* src = img.row(y);
+        if (src == dst) {
+            // in place: mirror from a copy of the row
+            scratch.assign(src, src + img.rowBytes());
+            src = scratch.data();
         }
+        PixelKernels::mirror(src, dst, W, C);
+    }
+}
+
+/**
+ * Flip image horizontally.
+ * Usage: flipHorizontal(img [, dst]), dst may be img itself to flip in place.
+ * Returns dst if given, otherwise a new Image.
+ * Uses lua_CFunction convention to access lua_State.
+ */
+int flipHorizontal(lua_State* L) {
+    Image* img = Lua::get<Image*>(L, 1);
+    if (!img) {
+        return luaL_error(L, "flipHorizontal: expected Image argument");
     }
     
-    return result;
+    Image* dst = pushImageOutput(L, 2, img->getWidth(), img->getHeight(), img->getChannels(), "flipHorizontal");
+    checkOverlap(L, *img, *dst, "flipHorizontal");
+    flipHorizontalInto(*img, *dst);
+    return 1;
 }
 
 /**
- * Flip image vertically.
+ * Reverse row order, dst may be src.
  */
-Image flipVertical(const Image& img) {
-    Image result(img.getWidth(), img.getHeight(), img.getChannels());
-    const uint8_t* src = img.data();
-    uint8_t* dst = result.data();
+static void flipVerticalInto(const Image& img, Image& result) {
+    const int H = img.getHeight();
+    const size_t row_bytes = img.rowBytes();
     
-    for (int y = 0; y < img.getHeight(); y++) {
-        const uint8_t* src_row = src + y * img.getWidth() * img.getChannels();
-        uint8_t* dst_row = dst + (img.getHeight() - 1 - y) * img.getWidth() * img.getChannels();
-        std::memcpy(dst_row, src_row, img.getWidth() * img.getChannels());
+    if (samePixels(img, result)) {
+        for (int y = 0; y < H / 2; y++) {
+            uint8_t* top = result.row(y);
+            PixelKernels::swapBytes(top, result.row(H - 1 - y), row_bytes);
+        }
+        return;
+    }
+    for (int y = 0; y < H; y++) {
+        std::memcpy(result.row(H - 1 - y), img.row(y), row_bytes);
+    }
+}
+
+/**
+ * Flip image vertically.
+ * Usage: flipVertical(img [, dst]), dst may be img itself to flip in place.
+ * Returns dst if given, otherwise a new Image.
+ * Uses lua_CFunction convention to access lua_State.
+ */
+int flipVertical(lua_State* L) {
+    Image* img = Lua::get<Image*>(L, 1);
+    if (!img) {
+        return luaL_error(L, "flipVertical: expected Image argument");
     }
     
-    return result;
+    Image* dst = pushImageOutput(L, 2, img->getWidth(), img->getHeight(), img->getChannels(), "flipVertical");
+    checkOverlap(L, *img, *dst, "flipVertical");
+    flipVerticalInto(*img, *dst);
+    return 1;
 }
 
 /**
  * Convert grayscale to BGR.
+ * Usage: gray2bgr(img [, dst]), dst must be the same size with 3 channels.
+ * Returns dst if given, otherwise a new Image.
+ * Uses lua_CFunction convention to access lua_State.
+ */
+int gray2bgr(lua_State* L) {
+    Image* img = Lua::get<Image*>(L, 1);
+    if (!img) {
+        return luaL_error(L, "gray2bgr: expected Image argument");
+    }
+    if (img->getChannels() != 1) {
+        return luaL_error(L, "gray2bgr: image must be grayscale (1 channel)");
+    }
+    
+    Image* result = pushImageOutput(L, 2, img->getWidth(), img->getHeight(), 3, "gray2bgr");
+    const Image& gray_img = *img;
+    
+    for (int y = 0; y < gray_img.getHeight(); y++) {
+        PixelKernels::grayToBGR(gray_img.row(y), result->row(y), gray_img.getWidth());
+    }
+    return 1;
+}
+
+/**
+ * Replace the image buffer allocator.
+ * Usage: setBufferPool({maxBytes=64 << 20, advice="none"|"hugepage"|"populate"})
+ *        setBufferPool(nil) to allocate every image from the heap.
+ * Images keep the allocator of their buffer, so buffers in use go back to the old pool.
+ * Uses lua_CFunction convention to access lua_State.
  */
-Image gray2bgr(const Image& img) {
-    if (img.getChannels() != 1) {
-        throw std::runtime_error("gray2bgr: image must be grayscale (1 channel)");
+int setBufferPool(lua_State* L) {
+    if (lua_isnoneornil(L, 1)) {
+        Image::setAllocator(std::make_shared<HeapImageAllocator>());
+        return 0;
+    }
+    luaL_checktype(L, 1, LUA_TTABLE);
+    
+    LuaRef opts(L, 1);
+    lua_Number max_bytes = opts.get("maxBytes", lua_Number(ImageBufferPool::DEFAULT_MAX_RETAINED));
+    if (max_bytes < 0) {
+        return luaL_error(L, "setBufferPool: maxBytes must not be negative");
     }
     
-    Image result(img.getWidth(), img.getHeight(), 3);
-    const uint8_t* src = img.data();
-    uint8_t* dst = result.data();
+    std::string advice_name = opts.get("advice", std::string("none"));
+    unsigned advice = ImagePoolAdvice::NONE;
+    if (advice_name == "hugepage") {
+        advice = ImagePoolAdvice::HUGEPAGE;
+    } else if (advice_name == "populate") {
+        advice = ImagePoolAdvice::POPULATE;
+    } else if (advice_name != "none") {
+        return luaL_error(L, "setBufferPool: advice must be none, hugepage or populate, got %s",
+            advice_name.c_str());
+    }
     
-    for (size_t i = 0; i < img.getWidth() * img.getHeight(); i++) {
-        uint8_t gray = src[i];
-        dst[i * 3 + 0] = gray;  // B
-        dst[i * 3 + 1] = gray;  // G
-        dst[i * 3 + 2] = gray;  // R
+    Image::setAllocator(std::make_shared<ImageBufferPool>(static_cast<size_t>(max_bytes), advice));
+    return 0;
+}
+
+/**
+ * Buffer pool statistics.
+ * Usage: bufferPoolStats() returns {hits=, misses=, retainedBytes=, retainedBuffers=},
+ *        or nil if images are allocated from the heap.
+ */
+int bufferPoolStats(lua_State* L) {
+    auto pool = std::dynamic_pointer_cast<ImageBufferPool>(Image::getAllocator());
+    if (!pool) {
+        lua_pushnil(L);
+        return 1;
     }
     
-    return result;
+    ImageBufferPool::Stats stats = pool->stats();
+    LuaRef result = LuaRef::createTable(L);
+    result["hits"] = lua_Number(stats.hits);
+    result["misses"] = lua_Number(stats.misses);
+    result["retainedBytes"] = lua_Number(stats.retained_bytes);
+    result["retainedBuffers"] = lua_Number(stats.retained_buffers);
+    result.pushToStack();
+    return 1;
+}
+
+/**
+ * Free all buffers retained by the current pool.
+ */
+void clearBufferPool() {
+    if (auto pool = std::dynamic_pointer_cast<ImageBufferPool>(Image::getAllocator())) {
+        pool->clear();
+    }
+}
+
+/**
+ * Instruction set of the pixel kernels: "scalar", "sse", "avx2" or "avx512".
+ */
+std::string kernelLevel() {
+    return tensorKernelLevelName(PixelKernels::level());
+}
+
+/**
+ * Limit the pixel kernels to an instruction set, for testing and benchmarks.
+ * Usage: setKernelLevel("scalar"|"sse"|"avx2"|"avx512"), returns the level in use,
+ *        which is lower if the CPU does not support the requested one.
+ */
+std::string setKernelLevel(const std::string& name) {
+    return tensorKernelLevelName(PixelKernels::setLevel(parseTensorKernelLevel(name)));
 }
 
 } // namespace CVLib
@@ -345,6 +1647,41 @@ Image gray2bgr(const Image& img) {
 extern "C" int luaopen_CVLib(lua_State* L) {
     LuaRef mod = LuaRef::createTable(L);
     
+    // Byte views exported by Image:row(), Image:pixels() (view[i]) and Image:plane()
+    using ByteViewMeta = TensorViewMetaMethod<uint8_t>;
+    using ByteStridedView = StridedTensorView<uint8_t>;
+    LuaBinding(mod)
+        .beginClass<TensorView<uint8_t>>("ByteTensorView")
+            .addFunction("get", &TensorView<uint8_t>::get)
+            .addFunction("set", &TensorView<uint8_t>::set)
+            .addFunction("fill", &TensorView<uint8_t>::fill)
+            .addFunction("copyFrom", &TensorView<uint8_t>::copyFrom)
+            .addFunction("sum", &TensorView<uint8_t>::sum)
+            .addFunction("min", &TensorView<uint8_t>::min)
+            .addFunction("max", &TensorView<uint8_t>::max)
+            .addRawMetaFunction("__index", &ByteViewMeta::index)
+            .addRawMetaFunction("__newindex", &ByteViewMeta::newIndex, &ByteViewMeta::newIndexConst)
+            .addRawMetaFunction("__len", &ByteViewMeta::len)
+        .endClass()
+        
+        .beginClass<ByteStridedView>("ByteStridedView")
+            .addFunction("ndim", &ByteStridedView::ndim)
+            .addFunction("numel", static_cast<size_t(ByteStridedView::*)()const>(&ByteStridedView::size))
+            .addFunction("size", static_cast<size_t(ByteStridedView::*)(int)const>(&ByteStridedView::size))
+            .addFunction("getShape", &ByteStridedView::getShape)
+            .addFunction("getStrides", &ByteStridedView::getStrides)
+            .addFunction("isContiguous", &ByteStridedView::isContiguous)
+            .addFunction("get", &ByteStridedView::get)
+            .addFunction("set", &ByteStridedView::set)
+            .addFunction("slice", &ByteStridedView::slice, LUA_ARGS(int, int, int, _def<int, 1>))
+            .addFunction("select", &ByteStridedView::select)
+            .addFunction("flat", &ByteStridedView::flat)
+            .addFunction("clone", &ByteStridedView::clone)
+            .addMetaFunction("__len", +[](const ByteStridedView* view) -> size_t {
+                return view->size();
+            })
+        .endClass();
+    
     LuaBinding(mod)
         .beginClass<Image>("Image")
             .addConstructor(LUA_ARGS(_opt<int>, _opt<int>, _opt<int>))
@@ -356,18 +1693,51 @@ extern "C" int luaopen_CVLib(lua_State* L) {
             .addFunction("copyFrom", &Image::copyFrom)
             .addFunction("fill", &Image::fill)
             .addFunction("at", static_cast<uint8_t(Image::*)(int,int,int)const>(&Image::at))
+            .addFunction("set", [](Image* img, int y, int x, int c, int value) {
+                img->at(y, x, c) = static_cast<uint8_t>(value);
+            })
+            .addFunction("roi", &Image::roi)
+            .addFunction("aliases", &Image::aliases)
+            .addProperty("stride", &Image::stride)
+            .addProperty("continuous", &Image::isContinuous)
+            .addFunction("row", &Image::rowView)
+            .addFunction("plane", &Image::plane)
+            .addFunction("pixels", &Image::pixels)
+            .addExternalSize(&Image::size)
+            .addRelease()
+        .endClass()
+        
+        .beginClass<FrameReader>("FrameReader")
+            .addProperty("width", &FrameReader::getWidth)
+            .addProperty("height", &FrameReader::getHeight)
+            .addProperty("channels", &FrameReader::getChannels)
+            .addProperty("count", &FrameReader::count)
+            .addProperty("position", &FrameReader::position)
+            .addFunction("format", &FrameReader::format)
+            .addFunction("frame", &FrameReader::frame)
+            .addFunction("seek", &FrameReader::seek)
+            .addFunction("next", &FrameReader::next)
+            .addFunction("__len", &FrameReader::count)
         .endClass()
         
         .addFunction("imread", &imread)
+        .addFunction("openFrames", &openFrames)
         .addFunction("bgr2rgb", &bgr2rgb)
         .addFunction("letterbox", &letterbox)
         .addFunction("normalize", &normalize)
         .addFunction("hwc2chw", &hwc2chw)
+        .addFunction("preprocess", &preprocess)
+        .addFunction("preprocessBatch", &preprocessBatch)
         .addFunction("crop", &crop)
         .addFunction("resize", &resize)
         .addFunction("flipHorizontal", &flipHorizontal)
         .addFunction("flipVertical", &flipVertical)
-        .addFunction("gray2bgr", &gray2bgr);
+        .addFunction("gray2bgr", &gray2bgr)
+        .addFunction("setBufferPool", &setBufferPool)
+        .addFunction("bufferPoolStats", &bufferPoolStats)
+        .addFunction("clearBufferPool", &clearBufferPool)
+        .addFunction("kernelLevel", &kernelLevel)
+        .addFunction("setKernelLevel", &setKernelLevel);
     
     mod.pushToStack();
     return 1;
@@ -1,10 +1,14 @@
 #include "post_types.h"
+#include "post_nms.h"
 #include "cv_types.h"
 #include "LuaIntf.h"
 #include <vector>
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 
 using namespace LuaIntf;
 using namespace PostLib;
@@ -13,60 +17,262 @@ using namespace CVLib;
 namespace PostLib {
 
 /**
- * Parse YOLO output tensor into boxes.
- * Accepts either Tensor object or Lua table with getShape method.
- * Returns Lua table of boxes.
- * Stub implementation - generates dummy boxes for testing.
+ * Decode YOLOv5 style rows [cx, cy, w, h, objectness, class scores...] and append the boxes
+ * with objectness * best class score >= conf to out, corners in model input pixels.
+ *
+ * The score is at most the objectness, so rows with objectness below conf are rejected
+ * before any class is read. With sigmoid the test is done on the logit, so a rejected row
+ * costs one compare and no exp. The class argmax of survivors uses the SIMD kernels.
  */
-LuaRef parseYoloOutput(LuaRef tensor_ref) {
-    lua_State* L = tensor_ref.state();
+static void decodeYolo(const float* data, size_t rows, int attrs, float conf, bool sigmoid, BoxArray& out) {
+    const size_t classes = static_cast<size_t>(attrs - 5);
+    float obj_min = conf;
+    if (sigmoid) {
+        obj_min = conf <= 0 ? -INFINITY : (conf >= 1 ? INFINITY : std::log(conf / (1 - conf)));
+    }
+    auto activate = [sigmoid](float x) { return sigmoid ? 1 / (1 + std::exp(-x)) : x; };
     
-    // TODO: Real YOLO parsing logic
-    // For now, generate some dummy boxes
+    for (size_t r = 0; r < rows; r++) {
+        const float* row = data + r * attrs;
+        if (!(row[4] >= obj_min)) continue;     // also rejects nan
+        
+        size_t best = TensorKernels<float>::argmax(row + 5, classes);
+        float score = activate(row[4]) * activate(row[5 + best]);
+        if (!(score >= conf)) continue;
+        
+        float half_w = row[2] * 0.5f;
+        float half_h = row[3] * 0.5f;
+        out.push(row[0] - half_w, row[1] - half_h, row[0] + half_w, row[1] + half_h, score, static_cast<int>(best));
+    }
+}
+
+/**
+ * Decode YOLOv5 style output into boxes.
+ * Usage: parseYoloOutput(output [, opts [, dst]])
+ *   output: Tensor of shape [1, N, 5 + C] or [N, 5 + C], or FloatTensorView of N * (5 + C)
+ *           values (C from opts.classes)
+ *   opts: {conf=0.25, classes=80, sigmoid=true}, sigmoid=false if the model output is
+ *         already activated
+ *   dst: BoxArray to reuse, it is cleared first
+ * Returns BoxArray (dst if given) of the boxes above conf, in row order.
+ * Uses lua_CFunction convention to access lua_State.
+ */
+int parseYoloOutput(lua_State* L) {
+    float conf = 0.25f;
+    int classes = 80;
+    bool sigmoid = true;
+    if (lua_istable(L, 2)) {
+        LuaRef opts(L, 2);
+        conf = opts.get("conf", conf);
+        classes = opts.get("classes", classes);
+        sigmoid = opts.get("sigmoid", sigmoid);
+    } else if (!lua_isnoneornil(L, 2)) {
+        return luaL_error(L, "parseYoloOutput: options must be a table");
+    }
     
-    // Try to get shape (works for both Tensor objects and tables with getShape)
-    std::vector<int> shape;
-    if (tensor_ref.type() == LuaTypeID::USERDATA) {
-        // Real Tensor object
-        Tensor* tensor = static_cast<Tensor*>(tensor_ref.toPtr());
-        if (tensor) {
-            shape = tensor->getShapeCpp();
-        }
-    } else if (tensor_ref.isTable()) {
-        // Lua table with getShape method
-        LuaRef getShape = tensor_ref["getShape"];
-        if (getShape.isFunction()) {
-            LuaRef shape_ref = getShape.call<LuaRef>(tensor_ref);
-            for (auto& kv : shape_ref) {
-                shape.push_back(kv.value<int>());
-            }
+    const float* data = nullptr;
+    size_t len = 0;
+    int attrs = classes + 5;
+    if (Tensor* tensor = CppObject::cast<Tensor>(L, 1, true)) {
+        std::vector<int> shape = tensor->getShapeCpp();
+        bool batch_of_one = shape.size() == 3 && shape[0] == 1;
+        if (shape.size() != 2 && !batch_of_one) {
+            return luaL_error(L, "parseYoloOutput: output must have shape [1, N, 5 + C] or [N, 5 + C]");
         }
+        data = tensor->data();
+        len = tensor->length();
+        attrs = shape.back();
+    } else {
+        TensorView<const float> view = Lua::get<TensorView<const float>>(L, 1);
+        data = view.data();
+        len = view.size();
+    }
+    if (attrs <= 5 || len % attrs != 0) {
+        return luaL_error(L, "parseYoloOutput: output of %d values is not rows of 5 + C values, C = %d",
+            int(len), attrs - 5);
     }
     
-    // Create test boxes and return as Lua table
-    LuaRef boxes = LuaRef::createTable(L);
-    
-    std::vector<Box> test_boxes = {
-        Box(100, 100, 200, 200, 0.85f, 0),
-        Box(150, 150, 250, 250, 0.75f, 0),  // Overlaps with first
-        Box(300, 300, 400, 400, 0.90f, 1),
-        Box(500, 100, 600, 200, 0.65f, 2)
-    };
+    BoxArray* out = nullptr;
+    if (lua_isnoneornil(L, 3)) {
+        Lua::push(L, BoxArray());
+        out = CppObject::cast<BoxArray>(L, -1, false);
+    } else {
+        out = CppObject::cast<BoxArray>(L, 3, false);
+        if (!out) {
+            return luaL_error(L, "parseYoloOutput: dst must be BoxArray");
+        }
+        lua_pushvalue(L, 3);
+        out->clear();
+    }
     
-    for (size_t i = 0; i < test_boxes.size(); i++) {
-        LuaRef box_table = LuaRef::createTable(L);
-        box_table.set("x1", test_boxes[i].x1);
-        box_table.set("y1", test_boxes[i].y1);
-        box_table.set("x2", test_boxes[i].x2);
-        box_table.set("y2", test_boxes[i].y2);
-        box_table.set("confidence", test_boxes[i].confidence);
-        box_table.set("class_id", test_boxes[i].class_id);
-        boxes[i + 1] = box_table;  // Lua 1-based indexing
+    decodeYolo(data, len / attrs, attrs, conf, sigmoid, *out);
+    return 1;
+}
+
+/**
+ * Boxes as Lua table of tables {x1, y1, x2, y2, confidence, class_id}, the format of scaleBoxes
+ */
+static LuaRef boxArrayToTable(const BoxArray* array, lua_State* L) {
+    const BoxArray& boxes = *array;
+    LuaRef result = LuaRef::createTable(L, static_cast<int>(boxes.size()));
+    for (size_t i = 0; i < boxes.size(); i++) {
+        LuaRef box_table = LuaRef::createTable(L, 0, 6);
+        box_table.set("x1", boxes.x1()[i]);
+        box_table.set("y1", boxes.y1()[i]);
+        box_table.set("x2", boxes.x2()[i]);
+        box_table.set("y2", boxes.y2()[i]);
+        box_table.set("confidence", boxes.confidence()[i]);
+        box_table.set("class_id", boxes.classId()[i]);
+        result[i + 1] = box_table;
+    }
+    return result;
+}
+
+/**
+ * Number field of the box table on top of the stack.
+ */
+static float boxField(lua_State* L, const char* name) {
+    lua_getfield(L, -1, name);
+    int is_number = 0;
+    float value = static_cast<float>(lua_tonumberx(L, -1, &is_number));
+    lua_pop(L, 1);
+    if (!is_number) {
+        throw std::runtime_error(std::string("box field '") + name + "' must be a number");
+    }
+    return value;
+}
+
+/**
+ * Read a Lua table of boxes into out. The table key of each box is appended to keys when given.
+ *
+ * Box userdata are read straight from the C++ object, with no field lookup. Tables are read by
+ * field {x1, y1, x2, y2, confidence, class_id or classId}. Both may be mixed in one table, so
+ * scripts can move to Box objects gradually.
+ */
+static void readBoxTable(const LuaRef& boxes_table, BoxArray& out, std::vector<int>* keys = nullptr) {
+    lua_State* L = boxes_table.state();
+    boxes_table.pushToStack();
+    int table = lua_gettop(L);
+    if (!lua_istable(L, table)) {
+        throw std::runtime_error(std::string("table of boxes or BoxArray expected, got ") + luaL_typename(L, table));
     }
     
+    lua_pushnil(L);
+    while (lua_next(L, table) != 0) {
+        if (keys) {
+            if (lua_type(L, -2) != LUA_TNUMBER) {
+                throw std::runtime_error("boxes must be an array, got non-number key");
+            }
+            keys->push_back(static_cast<int>(lua_tointeger(L, -2)));
+        }
+        
+        if (lua_type(L, -1) == LUA_TTABLE) {
+            // Support both "class_id" and "classId" for compatibility
+            lua_getfield(L, -1, "class_id");
+            bool snake_case = !lua_isnil(L, -1);
+            lua_pop(L, 1);
+            int class_id = static_cast<int>(boxField(L, snake_case ? "class_id" : "classId"));
+            
+            out.push(boxField(L, "x1"), boxField(L, "y1"), boxField(L, "x2"), boxField(L, "y2"),
+                boxField(L, "confidence"), class_id);
+        } else if (const Box* box = CppObject::cast<Box>(L, -1, true)) {
+            out.push(*box);
+        } else {
+            throw std::runtime_error(std::string("box must be a table or Box, got ") + luaL_typename(L, -1));
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+}
+
+/**
+ * Set the confidence of box boxes_table[key], a table or Box userdata.
+ */
+static void writeBoxConfidence(const LuaRef& boxes_table, int key, float confidence) {
+    lua_State* L = boxes_table.state();
+    boxes_table.pushToStack();
+    lua_rawgeti(L, -1, key);
+    if (lua_type(L, -1) == LUA_TTABLE) {
+        lua_pushnumber(L, confidence);
+        lua_setfield(L, -2, "confidence");
+    } else if (Box* box = CppObject::cast<Box>(L, -1, false)) {
+        box->confidence = confidence;
+    }
+    lua_pop(L, 2);
+}
+
+/**
+ * Set the corners of box boxes_table[key], a table or Box userdata, to box i of boxes.
+ */
+static void writeBoxCorners(const LuaRef& boxes_table, int key, const BoxArray& boxes, size_t i) {
+    lua_State* L = boxes_table.state();
+    boxes_table.pushToStack();
+    lua_rawgeti(L, -1, key);
+    if (lua_type(L, -1) == LUA_TTABLE) {
+        lua_pushnumber(L, boxes.x1()[i]);
+        lua_setfield(L, -2, "x1");
+        lua_pushnumber(L, boxes.y1()[i]);
+        lua_setfield(L, -2, "y1");
+        lua_pushnumber(L, boxes.x2()[i]);
+        lua_setfield(L, -2, "x2");
+        lua_pushnumber(L, boxes.y2()[i]);
+        lua_setfield(L, -2, "y2");
+    } else if (Box* box = CppObject::cast<Box>(L, -1, false)) {
+        box->x1 = boxes.x1()[i];
+        box->y1 = boxes.y1()[i];
+        box->x2 = boxes.x2()[i];
+        box->y2 = boxes.y2()[i];
+    }
+    lua_pop(L, 2);
+}
+
+/**
+ * BoxArray held by ref, nullptr if ref is anything else (a table of boxes) or missing.
+ */
+static BoxArray* toBoxArray(const LuaRef& ref) {
+    if (!ref.isValid()) return nullptr;
+    lua_State* L = ref.state();
+    ref.pushToStack();
+    BoxArray* boxes = CppObject::cast<BoxArray>(L, -1, false);
+    lua_pop(L, 1);
     return boxes;
 }
 
+/**
+ * BoxArray:get(i), box at 1-based index as multiple returns x1, y1, x2, y2, confidence, class_id
+ */
+static std::tuple<float, float, float, float, float, int> boxArrayGet(const BoxArray* boxes, int i) {
+    if (i < 1 || i > boxes->length()) {
+        throw std::out_of_range("BoxArray: index " + std::to_string(i) + " out of range");
+    }
+    Box box = boxes->at(static_cast<size_t>(i - 1));
+    return std::make_tuple(box.x1, box.y1, box.x2, box.y2, box.confidence, box.class_id);
+}
+
+/**
+ * BoxArray:column(name), zero-copy view of x1, y1, x2, y2 or confidence, writes go to the array.
+ * The view keeps the column storage alive, but it stops following the array once the array grows.
+ */
+static TensorView<float> boxArrayColumn(BoxArray* boxes, const std::string& name) {
+    float* column = name == "x1" ? boxes->x1()
+        : name == "y1" ? boxes->y1()
+        : name == "x2" ? boxes->x2()
+        : name == "y2" ? boxes->y2()
+        : name == "confidence" ? boxes->confidence()
+        : nullptr;
+    if (!column) {
+        throw std::invalid_argument("BoxArray: unknown column '" + name + "', expected x1, y1, x2, y2 or confidence");
+    }
+    return TensorView<float>(column, boxes->size(), boxes->owner());
+}
+
+/**
+ * BoxArray:classIds(), zero-copy view of the class_id column, same lifetime as column()
+ */
+static TensorView<int> boxArrayClassIds(BoxArray* boxes) {
+    return TensorView<int>(boxes->classId(), boxes->size(), boxes->owner());
+}
+
 /**
  * Phase 2.3 Test Functions for vector<Box> conversion
  */
@@ -129,8 +335,18 @@ LuaRef createEmptyBoxes(lua_State* L) {
     return LuaRef::createTable(L);
 }
 
-// Test 4: Return large vector for performance testing
-LuaRef createLargeBoxes(lua_State* L, int count) {
+// Test 4: Return large vector for performance testing, or fill dst if it is a BoxArray
+LuaRef createLargeBoxes(lua_State* L, int count, LuaRef dst) {
+    if (BoxArray* packed = toBoxArray(dst)) {
+        packed->clear();
+        packed->reserve(std::max(count, 0));
+        for (int i = 0; i < count; i++) {
+            float x = static_cast<float>(i * 10);
+            packed->push(x, x, x + 50, x + 50, 0.8f, i % 10);
+        }
+        return dst;
+    }
+    
     std::vector<Box> boxes;
     for (int i = 0; i < count; i++) {
         float x = static_cast<float>(i * 10);
@@ -148,138 +364,233 @@ LuaRef createLargeBoxes(lua_State* L, int count) {
     return result;
 }
 
+// Scratch of nms and scaleBoxes, reused by every call on the thread so steady-state calls do not allocate
+struct BoxScratch {
+    NmsEngine engine;
+    BoxArray boxes;
+    std::vector<int> keys;
+};
+
+static BoxScratch& boxScratch() {
+    thread_local BoxScratch scratch;
+    return scratch;
+}
+
 /**
- * Apply Non-Maximum Suppression (NMS) in-place.
- * Modifies the input table by removing suppressed boxes.
- * Returns nothing (testing void + LuaRef + double combination).
+ * NMS options from an IoU threshold number or an options table, defaults if nil.
  */
-void nms(LuaRef boxes_table, double iou_threshold) {
-    float threshold = static_cast<float>(iou_threshold);
-    
-    // Extract all boxes from Lua table
-    std::vector<std::pair<int, Box*>> indexed_boxes;
-    
-    for (auto& kv : boxes_table) {
-        int idx = kv.key<int>();
-        LuaRef box_ref = kv.value<LuaRef>();
-        
-        // Extract box fields from Lua table
-        float x1 = box_ref.get<float>("x1");
-        float y1 = box_ref.get<float>("y1");
-        float x2 = box_ref.get<float>("x2");
-        float y2 = box_ref.get<float>("y2");
-        float confidence = box_ref.get<float>("confidence");
-        
-        // Support both "class_id" and "classId" for compatibility
-        int class_id = box_ref.has("class_id") ? 
-            box_ref.get<int>("class_id") : 
-            box_ref.get<int>("classId");
-        
-        Box* box = new Box(x1, y1, x2, y2, confidence, class_id);
-        indexed_boxes.push_back({idx, box});
+static NmsOptions readNmsOptions(const LuaRef& options) {
+    NmsOptions opts;
+    if (!options.isValid() || options.type() == LuaTypeID::NIL) {
+        return opts;
+    }
+    if (options.type() == LuaTypeID::NUMBER) {
+        opts.iou_threshold = options.toValue<float>();
+        return opts;
+    }
+    if (options.type() != LuaTypeID::TABLE) {
+        throw std::runtime_error("nms: IoU threshold or options table expected");
     }
     
-    // Sort by confidence descending
-    std::sort(indexed_boxes.begin(), indexed_boxes.end(),
-        [](const auto& a, const auto& b) {
-            return a.second->confidence > b.second->confidence;
-        });
-    
-    // NMS algorithm: mark suppressed boxes
-    std::vector<bool> suppressed(indexed_boxes.size(), false);
-    
-    for (size_t i = 0; i < indexed_boxes.size(); i++) {
-        if (suppressed[i]) continue;
-        
-        Box* box_i = indexed_boxes[i].second;
-        
-        for (size_t j = i + 1; j < indexed_boxes.size(); j++) {
-            if (suppressed[j]) continue;
-            
-            Box* box_j = indexed_boxes[j].second;
-            
-            // Only suppress boxes of same class
-            if (box_i->class_id == box_j->class_id) {
-                float iou_val = box_i->iou(*box_j);
-                if (iou_val > threshold) {
-                    suppressed[j] = true;
-                }
-            }
+    opts.iou_threshold = options.get("iou", opts.iou_threshold);
+    opts.diou = options.get("diou", opts.diou);
+    opts.agnostic = options.get("agnostic", opts.agnostic);
+    opts.sigma = options.get("sigma", opts.sigma);
+    opts.score_threshold = options.get("score_threshold", opts.score_threshold);
+    int max_detections = options.get("max_detections", 0);
+    if (max_detections < 0) {
+        throw std::runtime_error("nms: max_detections must not be negative");
+    }
+    opts.max_detections = static_cast<size_t>(max_detections);
+    
+    std::string method = options.get<std::string>("method", "hard");
+    if (method == "hard") opts.method = NmsMethod::HARD;
+    else if (method == "linear") opts.method = NmsMethod::LINEAR;
+    else if (method == "gaussian") opts.method = NmsMethod::GAUSSIAN;
+    else throw std::runtime_error("nms: method must be hard, linear or gaussian, got " + method);
+    if (opts.method == NmsMethod::GAUSSIAN && !(opts.sigma > 0)) {
+        throw std::runtime_error("nms: sigma must be positive");
+    }
+    return opts;
+}
+
+/**
+ * Apply Non-Maximum Suppression (NMS) in-place.
+ * Modifies the input table or BoxArray by removing suppressed boxes, the kept boxes stay in order.
+ * Usage: nms(boxes [, iou_threshold | opts])
+ *   opts: {iou=0.45, method="hard"|"linear"|"gaussian", diou=false, agnostic=false,
+ *          max_detections=0 (no limit), sigma=0.5, score_threshold=0.001}
+ *   Soft-NMS methods write the decayed confidence back to BoxArray and table boxes.
+ * Returns nothing (testing void + LuaRef + LuaRef combination).
+ */
+void nms(LuaRef boxes_table, LuaRef options) {
+    NmsOptions opts = readNmsOptions(options);
+    BoxScratch& scratch = boxScratch();
+    NmsEngine& engine = scratch.engine;
+    bool soft = opts.method != NmsMethod::HARD;
+    
+    if (BoxArray* packed = toBoxArray(boxes_table)) {
+        engine.run(*packed, opts);
+        const std::vector<size_t>& keep = engine.keep();
+        packed->keep(keep.data(), keep.size());
+        if (soft) {
+            std::copy(engine.scores().begin(), engine.scores().end(), packed->confidence());
         }
+        return;
     }
     
+    // Extract all boxes from Lua table
+    BoxArray& boxes = scratch.boxes;
+    std::vector<int>& keys = scratch.keys;
+    boxes.clear();
+    keys.clear();
+    readBoxTable(boxes_table, boxes, &keys);
+    engine.run(boxes, opts);
+    const std::vector<size_t>& keep = engine.keep();
+    
     // Remove suppressed boxes from Lua table (in reverse order to preserve indices)
-    int removed_count = 0;
-    for (int i = indexed_boxes.size() - 1; i >= 0; i--) {
-        if (suppressed[i]) {
-            boxes_table.removeAt(indexed_boxes[i].first);
-            removed_count++;
+    size_t next = keep.size();
+    for (size_t i = keys.size(); i-- > 0;) {
+        if (next > 0 && keep[next - 1] == i) {
+            next--;
+            if (soft) {
+                writeBoxConfidence(boxes_table, keys[i], engine.scores()[next]);
+            }
+        } else {
+            boxes_table.removeAt(keys[i]);
         }
-        delete indexed_boxes[i].second;
     }
     
     // Compact the table to remove holes
     boxes_table.compact();
 }
 
+/**
+ * Letterbox mapping from model input back to the source image,
+ * x' = (x - left) * scale_x and y' = (y - top) * scale_y, clamped to [0, max_x] and [0, max_y].
+ */
+struct BoxMapping {
+    float left, top;
+    float scale_x, scale_y;
+    float max_x, max_y;
+};
+
+static BoxMapping boxMapping(int orig_w, int orig_h, int new_w, int new_h, int pad_left, int pad_top) {
+    BoxMapping m;
+    m.left = static_cast<float>(pad_left);
+    m.top = static_cast<float>(pad_top);
+    m.scale_x = static_cast<float>(orig_w) / new_w;
+    m.scale_y = static_cast<float>(orig_h) / new_h;
+    m.max_x = static_cast<float>(orig_w);
+    m.max_y = static_cast<float>(orig_h);
+    return m;
+}
+
+/**
+ * Mapping from a CVLib.letterbox or CVLib.preprocess result, or its pad table.
+ */
+static BoxMapping readLetterbox(const LuaRef& info) {
+    LuaRef pad = info.has("pad") ? info.get<LuaRef>("pad") : info;
+    if (pad.type() != LuaTypeID::TABLE || !pad.has("orig_w") || !pad.has("orig_h")
+        || !pad.has("new_w") || !pad.has("new_h")) {
+        throw std::runtime_error("scaleBoxes: letterbox info must be a CVLib.letterbox or preprocess result or its pad");
+    }
+    return boxMapping(pad.get<int>("orig_w"), pad.get<int>("orig_h"), pad.get<int>("new_w"), pad.get<int>("new_h"),
+        pad.get<int>("left"), pad.get<int>("top"));
+}
+
+/**
+ * Map the corner columns with the vector kernels.
+ */
+static void mapBoxes(BoxArray& boxes, const BoxMapping& m) {
+    size_t n = boxes.size();
+    BoxKernels::scaleClamp(boxes.x1(), n, m.left, m.scale_x, m.max_x);
+    BoxKernels::scaleClamp(boxes.y1(), n, m.top, m.scale_y, m.max_y);
+    BoxKernels::scaleClamp(boxes.x2(), n, m.left, m.scale_x, m.max_x);
+    BoxKernels::scaleClamp(boxes.y2(), n, m.top, m.scale_y, m.max_y);
+}
+
 /**
  * Scale bounding boxes from model input size to original image size.
- * Accounts for letterbox padding.
- * Accepts and returns Lua tables (not C++ vectors).
+ * Accounts for letterbox padding and clamps to the original image.
+ * Usage: scaleBoxes(boxes, letterbox [, inplace])
+ *        scaleBoxes(boxes, orig_w, orig_h, padded_w, padded_h, pad_info [, inplace])
+ *   boxes: table of box tables or Box userdata, or BoxArray
+ *   letterbox: CVLib.letterbox or CVLib.preprocess result, or its pad (preprocessBatch result.pad[i])
+ *   inplace: rewrite the corners of boxes and return it, instead of returning new boxes
+ *            (new box tables for a table, a new BoxArray for a BoxArray)
+ * Uses lua_CFunction convention to access lua_State.
  */
-LuaRef scaleBoxes(
-    LuaRef boxes_table,
-    int orig_w, int orig_h,
-    int padded_w, int padded_h,
-    LuaRef pad_info)
-{
-    lua_State* L = boxes_table.state();
-    
-    int pad_left = pad_info.get<int>("left");
-    int pad_top = pad_info.get<int>("top");
-    int pad_right = pad_info.get<int>("right");
-    int pad_bottom = pad_info.get<int>("bottom");
-    
-    float scale_x = static_cast<float>(orig_w) / (padded_w - pad_left - pad_right);
-    float scale_y = static_cast<float>(orig_h) / (padded_h - pad_top - pad_bottom);
-    
-    LuaRef scaled_boxes = LuaRef::createTable(L);
-    
-    int idx = 1;
-    for (auto& kv : boxes_table) {
-        LuaRef box = kv.value<LuaRef>();
-        
-        float x1 = box.get<float>("x1");
-        float y1 = box.get<float>("y1");
-        float x2 = box.get<float>("x2");
-        float y2 = box.get<float>("y2");
-        float confidence = box.get<float>("confidence");
-        int class_id = box.get<int>("class_id");
-        
-        // Remove padding offset and scale
-        float scaled_x1 = (x1 - pad_left) * scale_x;
-        float scaled_y1 = (y1 - pad_top) * scale_y;
-        float scaled_x2 = (x2 - pad_left) * scale_x;
-        float scaled_y2 = (y2 - pad_top) * scale_y;
-        
-        // Clamp to image bounds
-        scaled_x1 = std::max(0.0f, std::min(scaled_x1, static_cast<float>(orig_w)));
-        scaled_y1 = std::max(0.0f, std::min(scaled_y1, static_cast<float>(orig_h)));
-        scaled_x2 = std::max(0.0f, std::min(scaled_x2, static_cast<float>(orig_w)));
-        scaled_y2 = std::max(0.0f, std::min(scaled_y2, static_cast<float>(orig_h)));
-        
-        LuaRef scaled_box = LuaRef::createTable(L);
-        scaled_box.set("x1", scaled_x1);
-        scaled_box.set("y1", scaled_y1);
-        scaled_box.set("x2", scaled_x2);
-        scaled_box.set("y2", scaled_y2);
-        scaled_box.set("confidence", confidence);
-        scaled_box.set("class_id", class_id);
-        
-        scaled_boxes[idx++] = scaled_box;
+int scaleBoxes(lua_State* L) {
+    LuaRef boxes_table(L, 1);
+    BoxMapping mapping;
+    int inplace_index;
+    if (lua_istable(L, 2)) {
+        mapping = readLetterbox(LuaRef(L, 2));
+        inplace_index = 3;
+    } else {
+        int orig_w = static_cast<int>(luaL_checkinteger(L, 2));
+        int orig_h = static_cast<int>(luaL_checkinteger(L, 3));
+        int padded_w = static_cast<int>(luaL_checkinteger(L, 4));
+        int padded_h = static_cast<int>(luaL_checkinteger(L, 5));
+        LuaRef pad_info(L, 6);
+        int pad_left = pad_info.get<int>("left");
+        int pad_top = pad_info.get<int>("top");
+        int pad_right = pad_info.get<int>("right");
+        int pad_bottom = pad_info.get<int>("bottom");
+        mapping = boxMapping(orig_w, orig_h, padded_w - pad_left - pad_right, padded_h - pad_top - pad_bottom,
+            pad_left, pad_top);
+        inplace_index = 7;
+    }
+    bool inplace = lua_toboolean(L, inplace_index);
+    
+    if (BoxArray* packed = toBoxArray(boxes_table)) {
+        if (inplace) {
+            mapBoxes(*packed, mapping);
+            lua_pushvalue(L, 1);
+        } else {
+            BoxArray scaled = *packed;
+            mapBoxes(scaled, mapping);
+            Lua::push(L, scaled);
+        }
+        return 1;
     }
     
-    return scaled_boxes;
+    BoxScratch& scratch = boxScratch();
+    BoxArray& boxes = scratch.boxes;
+    std::vector<int>& keys = scratch.keys;
+    boxes.clear();
+    keys.clear();
+    // keys are only needed to write back, so copies accept any table like before
+    readBoxTable(boxes_table, boxes, inplace ? &keys : nullptr);
+    mapBoxes(boxes, mapping);
+    
+    if (inplace) {
+        for (size_t i = 0; i < keys.size(); i++) {
+            writeBoxCorners(boxes_table, keys[i], boxes, i);
+        }
+        lua_pushvalue(L, 1);
+    } else {
+        boxArrayToTable(&boxes, L).pushToStack();
+    }
+    return 1;
+}
+
+/**
+ * Instruction set of the box kernels: "scalar", "sse", "avx2" or "avx512".
+ */
+std::string kernelLevel() {
+    return tensorKernelLevelName(BoxKernels::level());
+}
+
+/**
+ * Limit the box kernels of nms and scaleBoxes to an instruction set, for testing and benchmarks.
+ * The float tensor kernels (decoder argmax) are shared with CVLib and Test and keep their level.
+ * Usage: setKernelLevel("scalar"|"sse"|"avx2"|"avx512"), returns the level in use,
+ *        which is lower if the CPU does not support the requested one.
+ */
+std::string setKernelLevel(const std::string& name) {
+    return tensorKernelLevelName(BoxKernels::setLevel(parseTensorKernelLevel(name)));
 }
 
 /**
@@ -324,6 +635,22 @@ int tensorReshape(lua_State* L) {
     return 0;
 }
 
+/**
+ * Read shape from Lua table at index, empty if not a table.
+ */
+static std::vector<int> readShape(lua_State* L, int index) {
+    std::vector<int> shape;
+    if (lua_istable(L, index)) {
+        size_t len = lua_rawlen(L, index);
+        for (size_t i = 1; i <= len; i++) {
+            lua_rawgeti(L, index, i);
+            shape.push_back(static_cast<int>(lua_tointeger(L, -1)));
+            lua_pop(L, 1);
+        }
+    }
+    return shape;
+}
+
 /**
  * Factory function to create Tensor from Lua table of shape.
  * Note: First arg is the class metatable, second arg (if present) is the shape.
@@ -410,9 +737,51 @@ extern "C" int luaopen_PostLib(lua_State* L) {
                 t->reshapeCpp(new_shape);
                 return 0;
             })
-            .addFunction("at", static_cast<double(Tensor::*)(size_t)const>(&Tensor::at))
+            .addFunction("at", static_cast<float(Tensor::*)(size_t)const>(&Tensor::at))
+            .addFunction("view", &Tensor::view)
+            .addStaticFunction("fromView", [](const TensorView<float>& view, lua_State* L) {
+                return Tensor(view, readShape(L, 2));
+            })
             // Add __len metamethod for #tensor
             .addFunction("__len", &Tensor::length)
+        .endClass();
+    
+    // Bind TensorView class (view[i] handled by raw metamethods), exported by Tensor:view()
+    using FloatViewMeta = TensorViewMetaMethod<float>;
+    using IntViewMeta = TensorViewMetaMethod<int>;
+    LuaBinding(mod)
+        .beginClass<TensorView<float>>("FloatTensorView")
+            .addConstructor(LUA_ARGS())
+            .addFunction("get", &TensorView<float>::get)
+            .addFunction("set", &TensorView<float>::set)
+            .addFunction("fill", &TensorView<float>::fill)
+            .addFunction("copyFrom", &TensorView<float>::copyFrom)
+            .addFunction("scale", &TensorView<float>::scale)
+            .addFunction("add", &TensorView<float>::add, LUA_ARGS(const TensorView<float>&, _def<float, 1>))
+            .addFunction("addScalar", &TensorView<float>::addScalar)
+            .addFunction("clamp", &TensorView<float>::clamp)
+            .addFunction("sigmoid", &TensorView<float>::sigmoid)
+            .addFunction("sum", &TensorView<float>::sum)
+            .addFunction("dot", &TensorView<float>::dot)
+            .addFunction("min", &TensorView<float>::min)
+            .addFunction("max", &TensorView<float>::max)
+            .addFunction("argmax", &TensorView<float>::argmax)
+            .addRawMetaFunction("__index", &FloatViewMeta::index)
+            .addRawMetaFunction("__newindex", &FloatViewMeta::newIndex, &FloatViewMeta::newIndexConst)
+            .addRawMetaFunction("__len", &FloatViewMeta::len)
+        .endClass()
+        
+        // Exported by BoxArray:classIds()
+        .beginClass<TensorView<int>>("IntTensorView")
+            .addFunction("get", &TensorView<int>::get)
+            .addFunction("set", &TensorView<int>::set)
+            .addFunction("fill", &TensorView<int>::fill)
+            .addFunction("copyFrom", &TensorView<int>::copyFrom)
+            .addFunction("min", &TensorView<int>::min)
+            .addFunction("max", &TensorView<int>::max)
+            .addRawMetaFunction("__index", &IntViewMeta::index)
+            .addRawMetaFunction("__newindex", &IntViewMeta::newIndex, &IntViewMeta::newIndexConst)
+            .addRawMetaFunction("__len", &IntViewMeta::len)
         .endClass()
         
         .beginClass<Box>("Box")
@@ -425,9 +794,29 @@ extern "C" int luaopen_PostLib(lua_State* L) {
             .addProperty("classId", &Box::getClassId)
         .endClass()
         
+        .beginClass<BoxArray>("BoxArray")
+            .addConstructor(LUA_ARGS())
+            .addStaticFunction("fromTable", [](const LuaRef& boxes_table) {
+                BoxArray boxes;
+                readBoxTable(boxes_table, boxes);
+                return boxes;
+            })
+            .addFunction("get", &boxArrayGet)
+            .addFunction("push", static_cast<void(BoxArray::*)(float, float, float, float, float, int)>(&BoxArray::push))
+            .addFunction("clear", &BoxArray::clear)
+            .addFunction("reserve", &BoxArray::reserve)
+            .addFunction("capacity", &BoxArray::capacity)
+            .addFunction("column", &boxArrayColumn)
+            .addFunction("classIds", &boxArrayClassIds)
+            .addFunction("toTable", &boxArrayToTable)
+            .addFunction("__len", &BoxArray::length)
+        .endClass()
+        
         .addFunction("parseYoloOutput", &parseYoloOutput)
         .addFunction("nms", &nms)
         .addFunction("scaleBoxes", &scaleBoxes)
+        .addFunction("kernelLevel", &kernelLevel)
+        .addFunction("setKernelLevel", &setKernelLevel)
         
         // Phase 2.3 test functions
         .addFunction("createTestBoxes", &createTestBoxes)
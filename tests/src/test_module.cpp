@@ -1,6 +1,10 @@
 // Test module for advanced lua-intf features
 
 #include "LuaIntf.h"
+#include "LuaContext.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -29,6 +33,115 @@ static TensorView<float> createView() {
     return TensorView<float>(data->data(), data->size(), data);
 }
 
+// Create float view of n elements set to value
+static TensorView<float> createFloatView(int n, float value) {
+    auto data = std::make_shared<std::vector<float>>(std::max(n, 0), value);
+    return TensorView<float>(data->data(), data->size(), data);
+}
+
+// Report / limit the instruction set used by float tensor kernels and dtype conversion
+static std::string kernelLevel() {
+    return tensorKernelLevelName(TensorKernels<float>::level());
+}
+
+static std::string setKernelLevel(const std::string& name) {
+    TensorKernelLevel level = parseTensorKernelLevel(name);
+    TensorConvert::setLevel(level);
+    return tensorKernelLevelName(TensorKernels<float>::setLevel(level));
+}
+
+// Create zero filled view of dtype name ("u8", "i8", "i32", "f16", "f32", "f64")
+static AnyTensorView createAnyView(const std::string& dtype, int n) {
+    return AnyTensorView::allocate(AnyTensorView::parseDType(dtype), std::max(n, 0));
+}
+
+// Describe any tensor view, e.g. "f32[1000]"
+static std::string tensorInfo(const AnyTensorView& view) {
+    return std::string(view.dtypeName()) + "[" + std::to_string(view.size()) + "]";
+}
+
+// Write view to file with header, so it can be mapped with dtype and shape
+static void writeTensorFile(const std::string& path, const AnyTensorView& view, const std::vector<int>& shape) {
+    std::vector<size_t> dims(shape.begin(), shape.end());
+    size_t count = 1;
+    for (size_t d : dims) count *= d;
+    if (count != view.size()) {
+        throw std::invalid_argument("writeTensorFile: shape does not match view length");
+    }
+    TensorMapping::write(path, view.dtype(), dims, view.data());
+}
+
+static unsigned parseMapAdvice(const std::string& advice) {
+    unsigned flags = TensorMapAdvice::NORMAL;
+    if (advice.find("sequential") != std::string::npos) flags |= TensorMapAdvice::SEQUENTIAL;
+    if (advice.find("willneed") != std::string::npos) flags |= TensorMapAdvice::WILLNEED;
+    if (advice.find("hugepage") != std::string::npos) flags |= TensorMapAdvice::HUGEPAGE;
+    return flags;
+}
+
+// Map file with header: mode "r" (read-only, shared) or "cow" (copy-on-write)
+static AnyTensorView mapTensorFile(const std::string& path, const std::string& mode, const std::string& advice) {
+    TensorMapMode map_mode = mode == "cow" ? TensorMapMode::COPY_ON_WRITE : TensorMapMode::READ_ONLY;
+    return TensorMapping::open(path, map_mode, parseMapAdvice(advice))->anyView();
+}
+
+static std::vector<int> mapTensorShape(const std::string& path) {
+    auto mapping = TensorMapping::open(path);
+    return std::vector<int>(mapping->shape().begin(), mapping->shape().end());
+}
+
+// Map whole file as float, copy-on-write
+static TensorView<float> mapFloatFile(const std::string& path) {
+    return TensorMapping::mapFile<float>(path, TensorMapMode::COPY_ON_WRITE);
+}
+
+// Sum bytes / floats of a Lua string, TensorBuffer or TensorView without copy
+static double byteSum(TensorView<const uint8_t> bytes) {
+    return TensorKernels<uint8_t>::sum(bytes.data(), bytes.size());
+}
+
+static double floatSum(TensorView<const float> floats) {
+    return TensorKernels<float>::sum(floats.data(), floats.size());
+}
+
+// Keep a view across calls, the Lua string it views must stay pinned.
+// The view lives in the registry, so lua_close releases it even without releaseBytes.
+static const char* const HELD_BYTES_KEY = "Test.heldBytes";
+
+static void holdBytes(lua_State* L, TensorView<const uint8_t> bytes) {
+    Lua::push(L, AnyTensorView(bytes));
+    lua_setfield(L, LUA_REGISTRYINDEX, HELD_BYTES_KEY);
+}
+
+static double heldByteSum(lua_State* L) {
+    lua_getfield(L, LUA_REGISTRYINDEX, HELD_BYTES_KEY);
+    double sum = lua_isnil(L, -1) ? 0 : byteSum(Lua::get<AnyTensorView>(L, -1).as<const uint8_t>());
+    lua_pop(L, 1);
+    return sum;
+}
+
+static void releaseBytes(lua_State* L) {
+    lua_pushnil(L);
+    lua_setfield(L, LUA_REGISTRYINDEX, HELD_BYTES_KEY);
+}
+
+// Monotonic wall clock in seconds, for benchmark scripts (os.clock sums CPU time of all threads)
+static double wallClock() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Create [1, 25200, 85] model output: value of column c in row r is c + 100 * (r % 100)
+static StridedTensorView<float> createOutput() {
+    const size_t rows = 25200, cols = 85;
+    auto data = std::make_shared<std::vector<float>>(rows * cols);
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < cols; c++) {
+            (*data)[r * cols + c] = static_cast<float>(c + 100 * (r % 100));
+        }
+    }
+    return StridedTensorView<float>(data->data(), {1, rows, cols}, data);
+}
+
 // Test consuming nested vector from Lua
 static int consumeNested(const std::vector<std::vector<int>>& nested) {
     int total = 0;
@@ -48,19 +161,120 @@ extern "C" int luaopen_Test(lua_State* L)
     LuaBinding(mod)
         .addFunction("createNested", &createNested)
         .addFunction("createView", &createView)
+        .addFunction("createOutput", &createOutput)
+        .addFunction("createFloatView", &createFloatView)
+        .addFunction("kernelLevel", &kernelLevel)
+        .addFunction("setKernelLevel", &setKernelLevel)
+        .addFunction("createAnyView", &createAnyView)
+        .addFunction("tensorInfo", &tensorInfo)
+        .addFunction("writeTensorFile", &writeTensorFile)
+        .addFunction("mapTensorFile", &mapTensorFile, LUA_ARGS(std::string, _opt<std::string>, _opt<std::string>))
+        .addFunction("mapTensorShape", &mapTensorShape)
+        .addFunction("mapFloatFile", &mapFloatFile)
+        .addFunction("byteSum", &byteSum)
+        .addFunction("floatSum", &floatSum)
+        .addFunction("holdBytes", &holdBytes)
+        .addFunction("heldByteSum", &heldByteSum)
+        .addFunction("releaseBytes", &releaseBytes)
+        .addFunction("clock", &wallClock)
         .addFunction("consumeNested", &consumeNested);
     
-    // Bind TensorView class
+    // FloatTensorView is bound in PostLib, next to Tensor which exports it
+    
+    // Bind dtype-erased view
     LuaBinding(mod)
-        .beginClass<TensorView<float>>("FloatTensorView")
-            .addConstructor(LUA_ARGS())
-            .addFunction("get", &TensorView<float>::get)
-            .addFunction("set", &TensorView<float>::set)
-            .addMetaFunction("__len", +[](TensorView<float>* view) -> int {
-                return view->length();
-            })
+        .beginClass<AnyTensorView>("AnyTensorView")
+            .addFunction("dtype", &AnyTensorView::dtypeName)
+            .addFunction("itemSize", &AnyTensorView::itemSize)
+            .addFunction("nbytes", &AnyTensorView::nbytes)
+            .addFunction("get", &AnyTensorView::get)
+            .addFunction("set", &AnyTensorView::set)
+            .addFunction("fill", &AnyTensorView::fill)
+            .addFunction("convertFrom", &AnyTensorView::convertFrom,
+                LUA_ARGS(const AnyTensorView&, _def<double, 1>, _def<double, 0>))
+            .addFunction("convertTo", &AnyTensorView::convertTo,
+                LUA_ARGS(const std::string&, _def<double, 1>, _def<double, 0>))
+            .addFunction("sum", &AnyTensorView::sum)
+            .addFunction("min", &AnyTensorView::min)
+            .addFunction("max", &AnyTensorView::max)
+            .addFunction("isReadOnly", &AnyTensorView::isReadOnly)
+            .addRawMetaFunction("__index", &AnyTensorViewMetaMethod::index)
+            .addRawMetaFunction("__newindex", &AnyTensorViewMetaMethod::newIndex, &AnyTensorViewMetaMethod::newIndexConst)
+            .addRawMetaFunction("__len", &AnyTensorViewMetaMethod::len)
+        .endClass();
+    
+    // Bind mutable byte buffer
+    LuaBinding(mod)
+        .beginClass<TensorBuffer>("Buffer")
+            .addConstructor(LUA_ARGS(size_t))
+            .addFunction("size", &TensorBuffer::size)
+            .addFunction("fill", &TensorBuffer::fill)
+            .addFunction("write", &TensorBuffer::write)
+            .addFunction("read", &TensorBuffer::read)
+            .addFunction("view", &TensorBuffer::anyView)
+            .addFunction("__len", &TensorBuffer::length)
+            .addExternalSize(&TensorBuffer::size)
         .endClass();
     
+    // Bind strided N-d view
+    using FloatStridedView = StridedTensorView<float>;
+    LuaBinding(mod)
+        .beginClass<FloatStridedView>("FloatStridedView")
+            .addFunction("ndim", &FloatStridedView::ndim)
+            .addFunction("numel", static_cast<size_t(FloatStridedView::*)()const>(&FloatStridedView::size))
+            .addFunction("size", static_cast<size_t(FloatStridedView::*)(int)const>(&FloatStridedView::size))
+            .addFunction("getShape", &FloatStridedView::getShape)
+            .addFunction("getStrides", &FloatStridedView::getStrides)
+            .addFunction("isContiguous", &FloatStridedView::isContiguous)
+            .addFunction("get", &FloatStridedView::get)
+            .addFunction("set", &FloatStridedView::set)
+            .addFunction("slice", &FloatStridedView::slice, LUA_ARGS(int, int, int, _def<int, 1>))
+            .addFunction("select", &FloatStridedView::select)
+            .addFunction("transpose", &FloatStridedView::transpose)
+            .addFunction("permute", &FloatStridedView::permute)
+            .addFunction("reshape", &FloatStridedView::reshape)
+            .addFunction("rows", &FloatStridedView::rows)
+            .addFunction("row", &FloatStridedView::row)
+            .addFunction("flat", &FloatStridedView::flat)
+            .addFunction("clone", &FloatStridedView::clone)
+            .addMetaFunction("__len", +[](const FloatStridedView* view) -> size_t {
+                return view->size();
+            })
+        .endClass();
+
+    // Bind GC policy (pacing and pause instrumentation)
+    LuaBinding(mod)
+        .beginClass<LuaGCPolicy>("GCPolicy")
+            .addConstructor(LUA_ARGS(lua_State*))
+            .addFunction("stop", &LuaGCPolicy::stop)
+            .addFunction("restart", &LuaGCPolicy::restart)
+            .addFunction("isRunning", &LuaGCPolicy::isRunning)
+            .addFunction("collect", &LuaGCPolicy::collect)
+            .addFunction("setStepSize", &LuaGCPolicy::setStepSize)
+            .addFunction("setIncremental", &LuaGCPolicy::setIncremental,
+                LUA_ARGS(_opt<int>, _opt<int>, _opt<int>))
+            .addFunction("setGenerational", &LuaGCPolicy::setGenerational,
+                LUA_ARGS(_opt<int>, _opt<int>))
+            .addFunction("isGenerational", +[](const LuaGCPolicy* gc) -> bool {
+                return gc->mode() == LuaGCMode::GENERATIONAL;
+            })
+            .addFunction("memoryInUse", &LuaGCPolicy::memoryInUse)
+            .addFunction("externalMemory", &LuaGCPolicy::externalMemory)
+            .addFunction("step", +[](LuaGCPolicy* gc, double budget_ms) -> bool {
+                return gc->step(std::chrono::microseconds(static_cast<int64_t>(budget_ms * 1000)));
+            })
+            .addFunction("pauseCount", +[](const LuaGCPolicy* gc) -> lua_Integer {
+                return static_cast<lua_Integer>(gc->stats().count());
+            })
+            .addFunction("maxPauseUs", +[](const LuaGCPolicy* gc) -> double {
+                return std::chrono::duration<double, std::micro>(gc->stats().max()).count();
+            })
+            .addFunction("percentileUs", +[](const LuaGCPolicy* gc, double p) -> double {
+                return std::chrono::duration<double, std::micro>(gc->stats().percentile(p)).count();
+            })
+            .addFunction("resetStats", &LuaGCPolicy::resetStats)
+        .endClass();
+
     mod.pushToStack();
     return 1;
 }